@@ -0,0 +1,28 @@
+# frozen_string_literal: true
+
+# Subtree destroy benchmark: one page of buttons with callbacks.
+#
+# Tk reports every destroyed window to Ruby in a single batch when the
+# destroy command returns; callbacks are released at idle time.
+#
+# Usage: ruby -Ilib -Iext/tk benchmark/destroy_subtree.rb [widgets]
+
+require 'benchmark'
+require 'tk'
+
+count = (ARGV[0] || 10_000).to_i
+root = TkRoot.new
+
+page = TkFrame.new(root)
+count.times { |i| TkButton.new(page, text: i.to_s, command: proc { i }) }
+Tk.update
+
+seconds = Benchmark.realtime do
+  page.destroy
+  Tk.update_idletasks
+end
+
+printf("destroy %d widgets: %.3fs (%d left in tk_windows, %d callback ids in TkComm)\n",
+       count, seconds, TkCore::INTERP.tk_windows.size,
+       TkComm.instance_variable_get(:@cmdtbl).size)
+root.destroy
@@ -0,0 +1,34 @@
+# frozen_string_literal: true
+
+# Replaying synthetic motion events: one Tk.event_generate per event
+# versus one Tk.event_generate_many batch, queued and synchronous.
+#
+# Usage: ruby -Ilib -Iext/tk benchmark/event_generate_many.rb [events]
+
+require 'benchmark'
+require 'tk'
+
+events = (ARGV[0] || 20_000).to_i
+
+canvas = TkCanvas.new(Tk.root, width: 200, height: 200).pack
+hits = 0
+canvas.bind('Motion', proc { hits += 1 })
+Tk.update
+
+batch = Array.new(events) { |i| [canvas, 'Motion', {x: i % 200, y: i / 200 % 200}] }
+
+seconds = Benchmark.realtime do
+  batch.each { |win, type, fields| Tk.event_generate(win, type, fields) }
+end
+printf("event_generate:             %.3fs (%.0f events/s)\n", seconds, events / seconds)
+
+seconds = Benchmark.realtime do
+  Tk.event_generate_many(batch)
+  Tk.update
+end
+printf("event_generate_many queued: %.3fs (%.0f events/s)\n", seconds, events / seconds)
+
+result = Tk.event_generate_many(batch, sync: true)
+printf("event_generate_many sync:   %.3fs (%.0f events/s)\n",
+       result[:time], events / result[:time])
+printf("callbacks run: %d\n", hits)
@@ -0,0 +1,44 @@
+# frozen_string_literal: true
+
+# Interpreter reuse benchmark: new TclTkIp per job vs snapshot + reset.
+#
+# Each job builds a small window tree with callbacks, a proc and a few
+# globals, then throws it away.
+#
+# Usage: ruby -Ilib -Iext/tk benchmark/interp_reset.rb [jobs]
+
+require 'benchmark'
+require 'tcltklib'
+
+jobs = (ARGV[0] || 50).to_i
+
+job = lambda do |ip|
+  ip.tcl_eval(<<~TCL)
+    frame .f
+    for {set i 0} {$i < 50} {incr i} { button .f.b$i -text $i -command {set ::clicked 1} }
+    proc job_helper {} { return 1 }
+    set ::job_result [job_helper]
+  TCL
+  10.times { ip.register_callback(proc {}) }
+end
+
+fresh = Benchmark.realtime do
+  jobs.times do
+    ip = TclTkIp.new
+    job.call(ip)
+    ip.delete
+  end
+end
+
+ip = TclTkIp.new
+ip.snapshot
+reused = Benchmark.realtime do
+  jobs.times do
+    job.call(ip)
+    ip.reset
+  end
+end
+ip.delete
+
+printf("new interp per job: %d jobs %.3fs (%.2fms/job)\n", jobs, fresh, fresh * 1000 / jobs)
+printf("snapshot + reset:   %d jobs %.3fs (%.2fms/job)\n", jobs, reused, reused * 1000 / jobs)
@@ -0,0 +1,38 @@
+# frozen_string_literal: true
+
+# Building a 1000-entry menu: one Menu#add per entry versus one
+# Menu#add_entries call, and rebuilding it the way a lazily populated
+# "recent files" cascade does on every post.
+#
+# Usage: ruby -Ilib -Iext/tk benchmark/menu_entries.rb [entries] [rounds]
+
+require 'benchmark'
+require 'tk'
+
+entries = (ARGV[0] || 1000).to_i
+rounds = (ARGV[1] || 20).to_i
+
+files = Array.new(entries) { |i| "/home/user/project/file_#{i}.rb" }
+specs = files.map { |f| {label: f, command: -> { f }} }
+menu = TkMenu.new(Tk.root, tearoff: false)
+
+seconds = Benchmark.realtime do
+  rounds.times do
+    menu.delete(0, 'end')
+    specs.each { |spec| menu.add(:command, spec) }
+  end
+end
+printf("add per entry: %.3fs (%.1f ms/menu)\n", seconds, seconds * 1000 / rounds)
+
+seconds = Benchmark.realtime do
+  rounds.times { menu.add_entries(specs, replace: true) }
+end
+printf("add_entries:   %.3fs (%.1f ms/menu)\n", seconds, seconds * 1000 / rounds)
+
+recent = menu.add_lazy_cascade(label: 'Open Recent') { specs }
+post = Tk.tk_call(recent.path, 'cget', '-postcommand')
+seconds = Benchmark.realtime do
+  rounds.times { Tk.tk_call('eval', post) }
+end
+printf("lazy cascade:  %.3fs (%.1f ms/post)\n", seconds, seconds * 1000 / rounds)
+printf("registered callbacks: %d\n", TkCore::INTERP.tk_cmd_tbl.size)
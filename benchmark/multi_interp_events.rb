@@ -0,0 +1,47 @@
+# frozen_string_literal: true
+
+# Event throughput with several interpreters active in one process.
+#
+# Each interpreter binds a virtual event to a Ruby callback; events are
+# generated round-robin across interpreters, then requests are queued
+# from one background thread per interpreter. Per-interpreter counters
+# come from Interp#stats.
+#
+# Usage: ruby -Ilib -Iext/tk benchmark/multi_interp_events.rb [events] [interps]
+
+require 'benchmark'
+require 'tk'
+
+events = (ARGV[0] || 20_000).to_i
+count = (ARGV[1] || 4).to_i
+
+interps = [TkCore::INTERP] + Array.new(count - 1) { TclTkIp.new }
+hits = Hash.new(0)
+interps.each_with_index do |ip, i|
+  id = ip.register_callback(proc { hits[i] += 1 })
+  ip._eval("bind . <<Ping>> {ruby_callback #{id}}")
+end
+
+seconds = Benchmark.realtime do
+  events.times { |n| interps[n % count]._eval("event generate . <<Ping>>") }
+end
+printf("%d interps, %d events: %.3fs (%.0f events/s)\n",
+       count, events, seconds, events / seconds)
+
+per_thread = events / count
+seconds = Benchmark.realtime do
+  threads = interps.map do |ip|
+    Thread.new { per_thread.times { ip.queue_for_main(proc {}) } }
+  end
+  TclTkLib.do_one_event(TclTkLib::ALL_EVENTS | TclTkLib::DONT_WAIT) while threads.any?(&:alive?)
+  TclTkLib.do_one_event(TclTkLib::ALL_EVENTS | TclTkLib::DONT_WAIT) while interps.any? { |ip| ip.stats[:pending] > 0 }
+end
+printf("%d threads, %d queued procs: %.3fs (%.0f/s)\n",
+       count, per_thread * count, seconds, per_thread * count / seconds)
+
+interps.each_with_index do |ip, i|
+  s = ip.stats
+  printf("  interp %d: callbacks=%d queued=%d run=%d max_depth=%d\n",
+         i, s[:callbacks], s[:queued], s[:queue_run], s[:max_callback_depth])
+end
+interps.drop(1).each(&:delete)
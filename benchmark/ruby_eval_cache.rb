@@ -0,0 +1,23 @@
+# frozen_string_literal: true
+
+# Repeated Tcl "ruby" command benchmark: a Tcl proc calling back into
+# Ruby source text, as tcltk.rb-style code does in loops.
+#
+# Compares the compiled-code cache against plain rb_eval_string (size 0).
+#
+# Usage: ruby -Ilib -Iext/tk benchmark/ruby_eval_cache.rb [iterations]
+
+require 'benchmark'
+require 'tk'
+
+count = (ARGV[0] || 100_000).to_i
+ip = TkCore::INTERP
+ip.tcl_eval("proc ::bench_ruby {n} { for {set i 0} {$i < $n} {incr i} { ruby {[1, 2, 3].sum * 2} } }")
+
+[[0, "uncached"], [256, "cached"]].each do |size, label|
+  ip.ruby_eval_cache_size = size
+  ip.ruby_eval_cache_clear
+  seconds = Benchmark.realtime { ip.tcl_eval("::bench_ruby #{count}") }
+  printf("%-9s %d ruby calls: %.3fs\n", label, count, seconds)
+end
+p ip.ruby_eval_cache_stats
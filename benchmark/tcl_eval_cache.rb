@@ -0,0 +1,22 @@
+# frozen_string_literal: true
+
+# Repeated tcl_eval benchmark: the same script evaluated many times.
+#
+# Compares the compiled-script cache against plain Tcl_Eval (size 0).
+#
+# Usage: ruby -Ilib -Iext/tk benchmark/tcl_eval_cache.rb [iterations]
+
+require 'benchmark'
+require 'tk'
+
+count = (ARGV[0] || 100_000).to_i
+ip = TkCore::INTERP
+script = "set ::bench_v [expr {[string length abcdef] * 3 + 1}]; incr ::bench_v"
+
+[[0, "uncached"], [256, "cached"]].each do |size, label|
+  ip.script_cache_size = size
+  ip.script_cache_clear
+  seconds = Benchmark.realtime { count.times { ip.tcl_eval(script) } }
+  printf("%-9s %d evals: %.3fs\n", label, count, seconds)
+end
+p ip.script_cache_stats
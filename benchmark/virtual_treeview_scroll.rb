@@ -0,0 +1,45 @@
+# frozen_string_literal: true
+
+# Scroll benchmark: Tk::Tile::VirtualTreeview over a 10M-row model.
+#
+# Measures the cost of jumping (moveto) and stepping (scroll units/pages)
+# through a model far larger than anything a plain Treeview could hold.
+#
+# Usage: ruby -Ilib -Iext/tk benchmark/virtual_treeview_scroll.rb [rows]
+
+require 'benchmark'
+require 'tk'
+require 'tkextlib/tile'
+
+ROWS = Integer(ARGV[0] || 10_000_000)
+
+class BenchModel
+  def row_count = ROWS
+  def rows(first, count)
+    Array.new(count) {|i| n = first + i; { text: "Row #{n}", values: [n, n * 2, "item-#{n}"] } }
+  end
+  def row(n) = rows(n, 1).first
+end
+
+root = TkRoot.new
+tree = Tk::Tile::VirtualTreeview.new(root, model: BenchModel.new,
+                                     columns: %w[n double name], height: 30)
+sb = Tk::Tile::YScrollbar.new(root)
+tree.yscrollbar(sb)
+sb.pack(side: :right, fill: :y)
+tree.pack(fill: :both, expand: true)
+Tk.update
+
+def measure(label, count)
+  t = Benchmark.realtime { count.times {|i| yield i; Tk.update } }
+  printf("%-24s %6d ops  %8.3f ms/op\n", label, count, t * 1000.0 / count)
+end
+
+rng = Random.new(42)
+puts "VirtualTreeview scroll over #{ROWS} rows"
+measure("moveto (random)", 500) { tree.yview_moveto(rng.rand) }
+measure("scroll 1 unit", 2000)  { tree.yview_scroll(1, :units) }
+measure("scroll 1 page", 1000)  { tree.yview_scroll(1, :pages) }
+measure("see_row (random)", 500) { tree.see_row(rng.rand(ROWS)) }
+
+root.destroy
@@ -73,7 +73,13 @@ end
 
 find_tcltk
 
+# Window capture (tkcapture.c) reads pixels with XGetImage on X11 builds
+unless RbConfig::CONFIG['host_os'] =~ /mingw|mswin|darwin/
+  have_library('X11', 'XGetImage', ['X11/Xlib.h']) &&
+    have_func('XGetImage', ['X11/Xlib.h'])
+end
+
 # Source files for the extension
-$srcs = ['tcltkbridge.c', 'tkphoto.c', 'tkfont.c', 'tkutil.c']
+$srcs = ['tcltkbridge.c', 'tkphoto.c', 'tkfont.c', 'tkutil.c', 'tktreeview.c', 'tkselection.c', 'tkvalidate.c', 'tkresize.c', 'tkdestroy.c', 'tkscriptcache.c', 'tkvars.c', 'tkcapture.c', 'tkreset.c', 'tksandbox.c', 'tknamespace.c', 'tkevents.c', 'tkscroll.c', 'tkrecolor.c', 'tkmenu.c', 'tkstyle.c']
 
 create_makefile('tcltklib')
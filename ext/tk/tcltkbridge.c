@@ -147,9 +147,6 @@ struct ruby_thread_event {
 /* Ruby Queue class for thread synchronization */
 static VALUE cQueue = Qundef;
 
-/* Track callback depth for unsafe operation detection */
-static int rbtk_callback_depth = 0;
-
 /* Callback control flow exceptions - for signaling break/continue/return to Tcl */
 static VALUE eTkCallbackBreak;
 static VALUE eTkCallbackContinue;
@@ -165,6 +162,8 @@ interp_mark(void *ptr)
     struct tcltk_interp *tip = ptr;
     rb_gc_mark(tip->callbacks);    /* Mark callback procs so GC doesn't collect them */
     rb_gc_mark(tip->thread_queue); /* Mark procs queued from other threads */
+    script_cache_mark(tip->script_cache); /* Frozen script keys */
+    script_cache_mark(tip->ruby_cache);   /* Compiled Ruby code */
 }
 
 static void
@@ -174,6 +173,8 @@ interp_free(void *ptr)
     if (tip->interp && !tip->deleted) {
         Tcl_DeleteInterp(tip->interp);
     }
+    script_cache_free(tip->script_cache);
+    script_cache_free(tip->ruby_cache);
     xfree(tip);
 }
 
@@ -190,6 +191,8 @@ static void
 interp_deleted_callback(ClientData clientData, Tcl_Interp *interp)
 {
     struct tcltk_interp *tip = (struct tcltk_interp *)clientData;
+    if (tip->script_cache) script_cache_clear(tip->script_cache);
+    if (tip->ruby_cache) script_cache_clear(tip->ruby_cache);
     tip->deleted = 1;
     tip->interp = NULL;  /* Don't hold stale pointer */
 }
@@ -223,6 +226,10 @@ interp_alloc(VALUE klass)
     tip->next_id = 1;
     tip->timer_interval_ms = DEFAULT_TIMER_INTERVAL_MS;
     tip->main_thread_id = NULL;
+    tip->script_cache = NULL;  /* created once Tcl stubs are up */
+    tip->ruby_cache = NULL;
+    tip->callback_depth = 0;
+    memset(&tip->stats, 0, sizeof(tip->stats));
     return obj;
 }
 
@@ -317,6 +324,9 @@ interp_initialize(int argc, VALUE *argv, VALUE self)
         rb_raise(eTclError, "Tcl_InitStubs failed: %s", err);
     }
 
+    tip->script_cache = script_cache_new();
+    tip->ruby_cache = script_cache_new();
+
     /* 4. Set up argc/argv/argv0 before Tcl_Init (required for proper init) */
     Tcl_Eval(tip->interp, "set argc 0; set argv {}; set argv0 tcltkbridge");
 
@@ -423,13 +433,17 @@ ruby_callback_proc(ClientData clientData, Tcl_Interp *interp,
     /* Call the proc with exception protection */
     cargs.proc = proc;
     cargs.args = args;
-    rbtk_callback_depth++;
+    tip->stats.callbacks++;
+    if (++tip->callback_depth > tip->stats.max_callback_depth) {
+        tip->stats.max_callback_depth = tip->callback_depth;
+    }
     result = rb_protect(callback_invoke, (VALUE)&cargs, &state);
-    rbtk_callback_depth--;
+    tip->callback_depth--;
 
     if (state) {
         VALUE errinfo = rb_errinfo();
         rb_set_errinfo(Qnil);
+        tip->stats.callback_errors++;
 
         /* Let SystemExit and Interrupt propagate - don't swallow them */
         if (rb_obj_is_kind_of(errinfo, rb_eSystemExit) ||
@@ -470,20 +484,26 @@ ruby_callback_proc(ClientData clientData, Tcl_Interp *interp,
  * Used by tcltk.rb's callback mechanism.
  * --------------------------------------------------------- */
 
-/* Helper for rb_protect */
+struct ruby_eval_args {
+    struct tcltk_interp *tip;
+    Tcl_Obj *code;
+};
+
+/* Helper for rb_protect - compiled code is cached per source */
 static VALUE
-eval_ruby_string(VALUE arg)
+eval_ruby_code(VALUE arg)
 {
-    return rb_eval_string(StringValueCStr(arg));
+    struct ruby_eval_args *a = (struct ruby_eval_args *)arg;
+    return ruby_code_cache_eval(a->tip, a->code);
 }
 
 static int
 ruby_eval_proc(ClientData clientData, Tcl_Interp *interp,
                int objc, Tcl_Obj *const objv[])
 {
-    VALUE code_str, result;
+    struct ruby_eval_args args;
+    VALUE result;
     int state;
-    const char *code;
 
     if (objc != 2) {
         Tcl_SetResult(interp, (char *)"wrong # args: should be \"ruby code\"",
@@ -491,10 +511,12 @@ ruby_eval_proc(ClientData clientData, Tcl_Interp *interp,
         return TCL_ERROR;
     }
 
-    code = Tcl_GetString(objv[1]);
-    code_str = rb_utf8_str_new_cstr(code);
-
-    result = rb_protect(eval_ruby_string, code_str, &state);
+    args.tip = (struct tcltk_interp *)clientData;
+    args.tip->stats.ruby_evals++;
+    args.code = objv[1];
+    Tcl_IncrRefCount(args.code);
+    result = rb_protect(eval_ruby_code, (VALUE)&args, &state);
+    Tcl_DecrRefCount(args.code);
 
     if (state) {
         VALUE errinfo = rb_errinfo();
@@ -567,8 +589,7 @@ execute_queued_eval(VALUE arg)
     VALUE *args = (VALUE *)arg;
     struct tcltk_interp *tip = (struct tcltk_interp *)args[0];
     VALUE script = args[1];
-    const char *script_cstr = StringValueCStr(script);
-    int result = Tcl_Eval(tip->interp, script_cstr);
+    int result = script_cache_eval(tip, script);
 
     if (result != TCL_OK) {
         rb_raise(eTclError, "%s", Tcl_GetStringResult(tip->interp));
@@ -636,6 +657,7 @@ ruby_thread_event_handler(Tcl_Event *evPtr, int flags)
     /* Pop the command from the GC-protected queue */
     cmd = rb_ary_shift(rte->tip->thread_queue);
     if (NIL_P(cmd)) return 1;
+    rte->tip->stats.queue_run++;
 
     type = rb_hash_aref(cmd, ID2SYM(sym_type));
     queue = rb_hash_aref(cmd, ID2SYM(sym_queue));
@@ -694,6 +716,7 @@ queue_command_internal(struct tcltk_interp *tip, VALUE cmd_hash, int wait_for_re
 
     /* Store command in GC-protected queue */
     rb_ary_push(tip->thread_queue, cmd_hash);
+    tip->stats.queued++;
 
     /* Allocate event - Tcl takes ownership and will free it */
     rte = (struct ruby_thread_event *)ckalloc(sizeof(struct ruby_thread_event));
@@ -765,7 +788,6 @@ interp_tcl_eval(VALUE self, VALUE script)
 {
     struct tcltk_interp *tip = get_interp(self);
     Tcl_ThreadId current = Tcl_GetCurrentThread();
-    const char *script_cstr;
     int result;
 
     StringValue(script);
@@ -778,9 +800,8 @@ interp_tcl_eval(VALUE self, VALUE script)
         return queue_command_internal(tip, cmd_hash, 1);
     }
 
-    /* On main thread - execute directly */
-    script_cstr = StringValueCStr(script);
-    result = Tcl_Eval(tip->interp, script_cstr);
+    /* On main thread - execute directly, reusing compiled bytecode */
+    result = script_cache_eval(tip, script);
 
     if (result != TCL_OK) {
         rb_raise(eTclError, "%s", Tcl_GetStringResult(tip->interp));
@@ -1263,6 +1284,10 @@ interp_create_slave(int argc, VALUE *argv, VALUE self)
     slave->next_id = 1;
     slave->timer_interval_ms = DEFAULT_TIMER_INTERVAL_MS;
     slave->main_thread_id = Tcl_GetCurrentThread();
+    slave->script_cache = script_cache_new();
+    slave->ruby_cache = script_cache_new();
+    slave->callback_depth = 0;
+    memset(&slave->stats, 0, sizeof(slave->stats));
 
     /* Register Ruby integration commands in the slave */
     Tcl_CreateObjCommand(slave->interp, "ruby_callback",
@@ -1304,13 +1329,70 @@ tcltkip_instances(VALUE klass)
 /* ---------------------------------------------------------
  * TclTkLib.in_callback? - Check if currently inside a Tk callback
  *
- * Used to detect unsafe operations (exit/destroy from callback).
+ * True while any live interpreter is running a callback. Used to
+ * detect unsafe operations (exit/destroy from callback).
  * --------------------------------------------------------- */
 
 static VALUE
 lib_in_callback_p(VALUE self)
 {
-    return rbtk_callback_depth > 0 ? Qtrue : Qfalse;
+    long i;
+
+    for (i = 0; i < RARRAY_LEN(live_instances); i++) {
+        struct tcltk_interp *tip;
+        TypedData_Get_Struct(RARRAY_AREF(live_instances, i), struct tcltk_interp,
+                             &interp_type, tip);
+        if (tip->callback_depth > 0) return Qtrue;
+    }
+    return Qfalse;
+}
+
+/* ---------------------------------------------------------
+ * Interp#in_callback? - Check if this interpreter is inside a callback
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_in_callback_p(VALUE self)
+{
+    struct tcltk_interp *tip;
+    TypedData_Get_Struct(self, struct tcltk_interp, &interp_type, tip);
+    return tip->callback_depth > 0 ? Qtrue : Qfalse;
+}
+
+/* ---------------------------------------------------------
+ * Interp#stats - Per-interpreter bridge counters
+ *
+ * Returns Hash:
+ *   :callbacks          - ruby_callback calls
+ *   :callback_errors    - callbacks that raised
+ *   :ruby_evals         - ruby / ruby_eval commands run
+ *   :queued             - requests queued from other threads
+ *   :queue_run          - queued requests run on the main thread
+ *   :pending            - queued requests not yet run
+ *   :callback_depth     - current callback nesting
+ *   :max_callback_depth - deepest nesting seen
+ *   :registered         - callbacks registered with register_callback
+ *
+ * Counters are only ever incremented; diff two calls to measure.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_stats(VALUE self)
+{
+    struct tcltk_interp *tip;
+    VALUE h = rb_hash_new();
+
+    TypedData_Get_Struct(self, struct tcltk_interp, &interp_type, tip);
+    rb_hash_aset(h, ID2SYM(rb_intern("callbacks")), ULONG2NUM(tip->stats.callbacks));
+    rb_hash_aset(h, ID2SYM(rb_intern("callback_errors")), ULONG2NUM(tip->stats.callback_errors));
+    rb_hash_aset(h, ID2SYM(rb_intern("ruby_evals")), ULONG2NUM(tip->stats.ruby_evals));
+    rb_hash_aset(h, ID2SYM(rb_intern("queued")), ULONG2NUM(tip->stats.queued));
+    rb_hash_aset(h, ID2SYM(rb_intern("queue_run")), ULONG2NUM(tip->stats.queue_run));
+    rb_hash_aset(h, ID2SYM(rb_intern("pending")), LONG2NUM(RARRAY_LEN(tip->thread_queue)));
+    rb_hash_aset(h, ID2SYM(rb_intern("callback_depth")), INT2NUM(tip->callback_depth));
+    rb_hash_aset(h, ID2SYM(rb_intern("max_callback_depth")), INT2NUM(tip->stats.max_callback_depth));
+    rb_hash_aset(h, ID2SYM(rb_intern("registered")), LONG2NUM(RHASH_SIZE(tip->callbacks)));
+    return h;
 }
 
 /* ---------------------------------------------------------
@@ -1469,6 +1551,8 @@ Init_tcltklib(void)
     rb_define_method(cTclTkIp, "queue_for_main", interp_queue_for_main, 1);
     rb_define_method(cTclTkIp, "on_main_thread?", interp_on_main_thread_p, 0);
     rb_define_method(cTclTkIp, "create_console", interp_create_console, 0);
+    rb_define_method(cTclTkIp, "in_callback?", interp_in_callback_p, 0);
+    rb_define_method(cTclTkIp, "stats", interp_stats, 0);
 
     /* Photo image functions (tkphoto.c) */
     Init_tkphoto(cTclTkIp);
@@ -1479,6 +1563,54 @@ Init_tcltklib(void)
     /* Utility functions (tkutil.c) */
     Init_tkutil(cTclTkIp);
 
+    /* Treeview bulk functions (tktreeview.c) */
+    Init_tktreeview(cTclTkIp);
+
+    /* Selection streaming functions (tkselection.c) */
+    Init_tkselection(cTclTkIp);
+
+    /* Compiled entry validators (tkvalidate.c) */
+    Init_tkvalidate(cTclTkIp);
+
+    /* Coalesced resize delivery (tkresize.c) */
+    Init_tkresize(cTclTkIp);
+
+    /* Batched destroy notification (tkdestroy.c) */
+    Init_tkdestroy(cTclTkIp);
+
+    /* Compiled-script cache (tkscriptcache.c) */
+    Init_tkscriptcache(cTclTkIp);
+
+    /* Bulk variable and array access (tkvars.c) */
+    Init_tkvars(cTclTkIp);
+
+    /* Window capture and image diff (tkcapture.c) */
+    Init_tkcapture(cTclTkIp);
+
+    /* Snapshot and reset (tkreset.c) */
+    Init_tkreset(cTclTkIp);
+
+    /* Resource-limited child interpreters (tksandbox.c) */
+    Init_tksandbox(cTclTkIp);
+
+    /* Namespace-scoped invocation (tknamespace.c) */
+    Init_tknamespace(cTclTkIp);
+
+    /* Batched event generation (tkevents.c) */
+    Init_tkevents(cTclTkIp);
+
+    /* Scrollbar linkage (tkscroll.c) */
+    Init_tkscroll(cTclTkIp);
+
+    /* Palette recoloring (tkrecolor.c) */
+    Init_tkrecolor(cTclTkIp);
+
+    /* Bulk menu entries (tkmenu.c) */
+    Init_tkmenu(cTclTkIp);
+
+    /* ttk style option resolution (tkstyle.c) */
+    Init_tkstyle(cTclTkIp);
+
     /* Aliases for legacy API compatibility */
     rb_define_alias(cTclTkIp, "_eval", "tcl_eval");
     rb_define_alias(cTclTkIp, "_invoke", "tcl_invoke");
@@ -21,6 +21,17 @@ struct tcltk_interp {
     unsigned long next_id; /* Next callback ID */
     int timer_interval_ms; /* Mainloop timer interval for thread yielding */
     Tcl_ThreadId main_thread_id; /* Thread that created the interp */
+    struct script_cache *script_cache; /* Compiled tcl_eval scripts, or NULL */
+    struct script_cache *ruby_cache;   /* Compiled ruby command sources, or NULL */
+    int callback_depth;       /* Nesting of ruby_callback calls in progress */
+    struct {
+        unsigned long callbacks;       /* ruby_callback calls */
+        unsigned long callback_errors; /* ... that raised */
+        unsigned long ruby_evals;      /* ruby / ruby_eval commands */
+        unsigned long queued;          /* requests queued from other threads */
+        unsigned long queue_run;       /* ... run on the main thread */
+        int max_callback_depth;
+    } stats;
 };
 
 /* Shared globals - defined in tcltkbridge.c */
@@ -39,4 +50,58 @@ void Init_tkfont(VALUE cTclTkIp);
 /* Utility functions - defined in tkutil.c */
 void Init_tkutil(VALUE cTclTkIp);
 
+/* Treeview bulk functions - defined in tktreeview.c */
+void Init_tktreeview(VALUE cTclTkIp);
+
+/* Selection streaming functions - defined in tkselection.c */
+void Init_tkselection(VALUE cTclTkIp);
+
+/* Compiled entry validators - defined in tkvalidate.c */
+void Init_tkvalidate(VALUE cTclTkIp);
+
+/* Compiled-script cache - defined in tkscriptcache.c */
+struct script_cache *script_cache_new(void);
+void script_cache_clear(struct script_cache *sc);
+void script_cache_free(struct script_cache *sc);
+void script_cache_mark(struct script_cache *sc);
+int script_cache_eval(struct tcltk_interp *tip, VALUE script);
+VALUE ruby_code_cache_eval(struct tcltk_interp *tip, Tcl_Obj *code);
+void Init_tkscriptcache(VALUE cTclTkIp);
+
+/* Coalesced resize delivery - defined in tkresize.c */
+void Init_tkresize(VALUE cTclTkIp);
+
+/* Batched destroy notification - defined in tkdestroy.c */
+void Init_tkdestroy(VALUE cTclTkIp);
+
+/* Bulk variable access - defined in tkvars.c */
+void Init_tkvars(VALUE cTclTkIp);
+
+/* Window capture and image diff - defined in tkcapture.c */
+void Init_tkcapture(VALUE cTclTkIp);
+
+/* Interpreter snapshot and reset - defined in tkreset.c */
+void Init_tkreset(VALUE cTclTkIp);
+
+/* Resource-limited sandbox interpreters - defined in tksandbox.c */
+void Init_tksandbox(VALUE cTclTkIp);
+
+/* Namespace-scoped dispatch - defined in tknamespace.c */
+void Init_tknamespace(VALUE cTclTkIp);
+
+/* Batched event generation - defined in tkevents.c */
+void Init_tkevents(VALUE cTclTkIp);
+
+/* Native scrollbar linkage - defined in tkscroll.c */
+void Init_tkscroll(VALUE cTclTkIp);
+
+/* Native palette recoloring - defined in tkrecolor.c */
+void Init_tkrecolor(VALUE cTclTkIp);
+
+/* Bulk menu construction - defined in tkmenu.c */
+void Init_tkmenu(VALUE cTclTkIp);
+
+/* Bulk ttk style option resolution - defined in tkstyle.c */
+void Init_tkstyle(VALUE cTclTkIp);
+
 #endif /* TCLTKBRIDGE_H */
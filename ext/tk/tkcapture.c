@@ -0,0 +1,349 @@
+/* tkcapture.c - Window capture and image comparison for tk-ng
+ *
+ * capture_window reads a mapped Tk window's pixels straight from the
+ * X server (XGetImage on the window's display) into an RGBA string,
+ * the same layout photo_get_image returns. TclTkLib.image_diff compares
+ * two RGBA buffers without the GVL, so several comparisons can run in
+ * parallel from Ruby threads; its inner loops are branch-free byte
+ * arithmetic the compiler can vectorize.
+ */
+
+#include "tcltkbridge.h"
+#include <ruby/thread.h>
+#include <string.h>
+
+#ifdef HAVE_XGETIMAGE
+#include <X11/Xutil.h>
+#endif
+
+#ifdef HAVE_XGETIMAGE
+
+static int
+capture_error(ClientData clientData, XErrorEvent *errEventPtr)
+{
+    *(int *)clientData = 1;
+    return 0;
+}
+
+/* Position and width of a TrueColor channel mask */
+static void
+mask_layout(unsigned long mask, int *shift, unsigned long *max)
+{
+    *shift = 0;
+    if (mask == 0) {
+        *max = 1;
+        return;
+    }
+    while (!(mask & 1)) {
+        mask >>= 1;
+        (*shift)++;
+    }
+    *max = mask;
+}
+
+static void
+ximage_to_rgba(XImage *ximg, Visual *visual, int width, int height, unsigned char *out)
+{
+    int x, y;
+
+    /* Common case: 24-bit TrueColor in 32-bit pixels, no per-pixel calls */
+    if (ximg->bits_per_pixel == 32 && visual->red_mask == 0xff0000 &&
+        visual->green_mask == 0xff00 && visual->blue_mask == 0xff) {
+        int r = ximg->byte_order == LSBFirst ? 2 : 1;
+        int g = ximg->byte_order == LSBFirst ? 1 : 2;
+        int b = ximg->byte_order == LSBFirst ? 0 : 3;
+
+        for (y = 0; y < height; y++) {
+            const unsigned char *src = (const unsigned char *)ximg->data +
+                                       (long)y * ximg->bytes_per_line;
+            unsigned char *dst = out + (long)y * width * 4;
+            for (x = 0; x < width; x++) {
+                dst[x * 4 + 0] = src[x * 4 + r];
+                dst[x * 4 + 1] = src[x * 4 + g];
+                dst[x * 4 + 2] = src[x * 4 + b];
+                dst[x * 4 + 3] = 255;
+            }
+        }
+        return;
+    }
+
+    {
+        int rs, gs, bs;
+        unsigned long rmax, gmax, bmax;
+
+        mask_layout(visual->red_mask, &rs, &rmax);
+        mask_layout(visual->green_mask, &gs, &gmax);
+        mask_layout(visual->blue_mask, &bs, &bmax);
+        for (y = 0; y < height; y++) {
+            unsigned char *dst = out + (long)y * width * 4;
+            for (x = 0; x < width; x++) {
+                unsigned long p = XGetPixel(ximg, x, y);
+                dst[x * 4 + 0] = (unsigned char)((((p & visual->red_mask) >> rs) * 255) / rmax);
+                dst[x * 4 + 1] = (unsigned char)((((p & visual->green_mask) >> gs) * 255) / gmax);
+                dst[x * 4 + 2] = (unsigned char)((((p & visual->blue_mask) >> bs) * 255) / bmax);
+                dst[x * 4 + 3] = 255;
+            }
+        }
+    }
+}
+
+#endif /* HAVE_XGETIMAGE */
+
+/* ---------------------------------------------------------
+ * Interp#capture_window(path) - Read a window's pixels
+ *
+ * Grabs the current contents of a mapped window, including its child
+ * windows, with XGetImage. No screen-grab tool or image file is used.
+ *
+ * Returns Hash {data:, width:, height:} with RGBA data (alpha 255),
+ * the same shape as photo_get_image.
+ *
+ * Raises NotImplementedError on non-X11 builds of Tk.
+ *
+ * See: https://www.x.org/releases/current/doc/man/man3/XGetImage.3.xhtml
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_capture_window(VALUE self, VALUE path)
+{
+#ifdef HAVE_XGETIMAGE
+    struct tcltk_interp *tip = get_interp(self);
+    Tk_Window mainWin, tkwin;
+    Tk_ErrorHandler handler;
+    Visual *visual;
+    XImage *ximg;
+    VALUE data, result;
+    int width, height;
+    int failed = 0;
+
+    StringValue(path);
+    mainWin = Tk_MainWindow(tip->interp);
+    if (!mainWin) {
+        rb_raise(eTclError, "Tk not initialized (no main window)");
+    }
+    tkwin = Tk_NameToWindow(tip->interp, StringValueCStr(path), mainWin);
+    if (!tkwin) {
+        rb_raise(eTclError, "%s", Tcl_GetStringResult(tip->interp));
+    }
+    if (!Tk_IsMapped(tkwin)) {
+        rb_raise(eTclError, "window \"%s\" is not mapped", Tk_PathName(tkwin));
+    }
+
+    visual = Tk_Visual(tkwin);
+    if (visual->class != TrueColor && visual->class != DirectColor) {
+        rb_raise(eTclError, "capture_window needs a TrueColor visual");
+    }
+
+    width = Tk_Width(tkwin);
+    height = Tk_Height(tkwin);
+
+    /* A window partly off screen fails with BadMatch; report, don't abort */
+    handler = Tk_CreateErrorHandler(Tk_Display(tkwin), -1, -1, -1,
+                                    capture_error, (ClientData)&failed);
+    ximg = XGetImage(Tk_Display(tkwin), Tk_WindowId(tkwin), 0, 0,
+                     (unsigned)width, (unsigned)height, AllPlanes, ZPixmap);
+    Tk_DeleteErrorHandler(handler);
+    if (ximg == NULL || failed) {
+        if (ximg) XDestroyImage(ximg);
+        rb_raise(eTclError, "could not read window \"%s\" (off screen?)",
+                 Tk_PathName(tkwin));
+    }
+
+    data = rb_str_new(NULL, (long)width * height * 4);
+    ximage_to_rgba(ximg, visual, width, height, (unsigned char *)RSTRING_PTR(data));
+    XDestroyImage(ximg);
+
+    result = rb_hash_new();
+    rb_hash_aset(result, ID2SYM(rb_intern("data")), data);
+    rb_hash_aset(result, ID2SYM(rb_intern("width")), INT2NUM(width));
+    rb_hash_aset(result, ID2SYM(rb_intern("height")), INT2NUM(height));
+    return result;
+#else
+    get_interp(self);
+    rb_raise(rb_eNotImpError, "capture_window requires an X11 build of Tk");
+    return Qnil;
+#endif
+}
+
+/* ---------------------------------------------------------
+ * Image comparison
+ * --------------------------------------------------------- */
+
+struct diff_job {
+    const unsigned char *expected;
+    const unsigned char *actual;
+    unsigned char *mask;        /* NULL unless requested */
+    unsigned char *overlay;     /* NULL unless requested */
+    long npixels;
+    int tolerance;
+    long count;
+};
+
+#define CHANNEL_DIFF(a, b) ((a) > (b) ? (a) - (b) : (b) - (a))
+
+static void *
+diff_run(void *ptr)
+{
+    struct diff_job *j = ptr;
+    const unsigned char *e = j->expected;
+    const unsigned char *a = j->actual;
+    int tol = j->tolerance;
+    long i, count = 0;
+
+    /* Count pass: one flag per pixel, no branches */
+    for (i = 0; i < j->npixels * 4; i += 4) {
+        count += (CHANNEL_DIFF(e[i], a[i]) > tol) |
+                 (CHANNEL_DIFF(e[i + 1], a[i + 1]) > tol) |
+                 (CHANNEL_DIFF(e[i + 2], a[i + 2]) > tol) |
+                 (CHANNEL_DIFF(e[i + 3], a[i + 3]) > tol);
+    }
+    j->count = count;
+    if (!j->mask) return NULL;
+
+    /* Mask: differing pixels red over a faded copy of expected.
+     * Overlay: expected with differing pixels blended 50% toward red. */
+    for (i = 0; i < j->npixels * 4; i += 4) {
+        int differs = (CHANNEL_DIFF(e[i], a[i]) > tol) |
+                      (CHANNEL_DIFF(e[i + 1], a[i + 1]) > tol) |
+                      (CHANNEL_DIFF(e[i + 2], a[i + 2]) > tol) |
+                      (CHANNEL_DIFF(e[i + 3], a[i + 3]) > tol);
+        int lum = (e[i] * 77 + e[i + 1] * 150 + e[i + 2] * 29) >> 8;
+        int faded = 204 + lum / 5;
+
+        j->mask[i]     = (unsigned char)(differs ? 255 : faded);
+        j->mask[i + 1] = (unsigned char)(differs ? 0 : faded);
+        j->mask[i + 2] = (unsigned char)(differs ? 0 : faded);
+        j->mask[i + 3] = 255;
+        j->overlay[i]     = (unsigned char)(differs ? (e[i] + 255) / 2 : e[i]);
+        j->overlay[i + 1] = (unsigned char)(differs ? e[i + 1] / 2 : e[i + 1]);
+        j->overlay[i + 2] = (unsigned char)(differs ? e[i + 2] / 2 : e[i + 2]);
+        j->overlay[i + 3] = 255;
+    }
+    return NULL;
+}
+
+static VALUE
+diff_without_gvl(VALUE ptr)
+{
+    rb_thread_call_without_gvl(diff_run, (void *)ptr, NULL, NULL);
+    return Qnil;
+}
+
+static VALUE
+diff_unlock(VALUE str)
+{
+    return rb_str_unlocktmp(str);
+}
+
+struct diff_locked {
+    struct diff_job *job;
+    VALUE actual;
+};
+
+/* Lock actual too (expected is already locked) and run the job */
+static VALUE
+diff_lock_actual(VALUE ptr)
+{
+    struct diff_locked *lk = (struct diff_locked *)ptr;
+
+    rb_str_locktmp(lk->actual);
+    return rb_ensure(diff_without_gvl, (VALUE)lk->job, diff_unlock, lk->actual);
+}
+
+/* ---------------------------------------------------------
+ * TclTkLib.image_diff(expected, actual, width, height, opts={})
+ *
+ * Count pixels that differ between two RGBA buffers (the "AE" metric).
+ *
+ * Arguments:
+ *   expected, actual - RGBA Strings, width * height * 4 bytes each
+ *   opts             - Optional hash:
+ *                      :tolerance - per-channel difference still treated
+ *                                   as equal, 0-255 (default 0)
+ *                      :mask      - if true, also return RGBA diff images
+ *
+ * Returns Hash {pixel_diff:, total:} plus, with mask: true,
+ *   :mask    - differing pixels red over a faded copy of expected
+ *   :overlay - expected with differing pixels tinted red
+ *
+ * Runs without the GVL, so Ruby threads can compare images in parallel.
+ * --------------------------------------------------------- */
+
+static VALUE
+lib_image_diff(int argc, VALUE *argv, VALUE self)
+{
+    VALUE expected, actual, width_val, height_val, opts, result;
+    VALUE mask = Qnil, overlay = Qnil;
+    struct diff_job job;
+    long width, height, size;
+
+    rb_scan_args(argc, argv, "41", &expected, &actual, &width_val, &height_val, &opts);
+    StringValue(expected);
+    StringValue(actual);
+    width = NUM2LONG(width_val);
+    height = NUM2LONG(height_val);
+    if (width <= 0 || height <= 0) {
+        rb_raise(rb_eArgError, "width and height must be positive");
+    }
+    size = width * height * 4;
+    if (RSTRING_LEN(expected) != size || RSTRING_LEN(actual) != size) {
+        rb_raise(rb_eArgError, "pixel data size mismatch: expected %ld bytes, got %ld and %ld",
+                 size, RSTRING_LEN(expected), RSTRING_LEN(actual));
+    }
+
+    memset(&job, 0, sizeof(job));
+    job.npixels = width * height;
+    if (!NIL_P(opts)) {
+        VALUE val;
+        Check_Type(opts, T_HASH);
+        val = rb_hash_aref(opts, ID2SYM(rb_intern("tolerance")));
+        if (!NIL_P(val)) job.tolerance = NUM2INT(val);
+        if (job.tolerance < 0 || job.tolerance > 255) {
+            rb_raise(rb_eArgError, "tolerance must be 0-255");
+        }
+        if (RTEST(rb_hash_aref(opts, ID2SYM(rb_intern("mask"))))) {
+            mask = rb_str_new(NULL, size);
+            overlay = rb_str_new(NULL, size);
+            job.mask = (unsigned char *)RSTRING_PTR(mask);
+            job.overlay = (unsigned char *)RSTRING_PTR(overlay);
+        }
+    }
+
+    /* Inputs must not change while other threads run. Both may be the
+     * same String, which can only be locked once; every lock taken is
+     * released even if a later one raises. */
+    job.expected = (const unsigned char *)RSTRING_PTR(expected);
+    job.actual = (const unsigned char *)RSTRING_PTR(actual);
+    rb_str_locktmp(expected);
+    if (actual == expected) {
+        rb_ensure(diff_without_gvl, (VALUE)&job, diff_unlock, expected);
+    } else {
+        struct diff_locked lk;
+
+        lk.job = &job;
+        lk.actual = actual;
+        rb_ensure(diff_lock_actual, (VALUE)&lk, diff_unlock, expected);
+    }
+
+    result = rb_hash_new();
+    rb_hash_aset(result, ID2SYM(rb_intern("pixel_diff")), LONG2NUM(job.count));
+    rb_hash_aset(result, ID2SYM(rb_intern("total")), LONG2NUM(job.npixels));
+    if (!NIL_P(mask)) {
+        rb_hash_aset(result, ID2SYM(rb_intern("mask")), mask);
+        rb_hash_aset(result, ID2SYM(rb_intern("overlay")), overlay);
+    }
+    return result;
+}
+
+/* ---------------------------------------------------------
+ * Init_tkcapture - Register capture and diff functions
+ *
+ * Called from Init_tcltklib in tcltkbridge.c
+ * --------------------------------------------------------- */
+
+void
+Init_tkcapture(VALUE cTclTkIp)
+{
+    rb_define_method(cTclTkIp, "capture_window", interp_capture_window, 1);
+    rb_define_module_function(rb_define_module("TclTkLib"), "image_diff", lib_image_diff, -1);
+}
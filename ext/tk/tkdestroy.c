@@ -0,0 +1,280 @@
+/* tkdestroy.c - Batched widget destroy notification for tk-ng
+ *
+ * A Tk generic event handler collects the path of every window of this
+ * application as Tk destroys it. The collected paths are handed to Ruby
+ * in one call when the Tcl "destroy" command returns (or at idle time
+ * for windows destroyed some other way), instead of one binding script
+ * and one Ruby callback per destroyed widget.
+ */
+
+#include "tcltkbridge.h"
+
+struct destroy_watch {
+    Tcl_Interp *interp;
+    VALUE callback;         /* receives Array of paths */
+    VALUE pending;          /* paths collected since the last flush */
+    int idle_scheduled;
+    int installed;
+};
+
+static ID id_destroy_watch;
+static ID id_call;
+
+static void destroy_idle_flush(ClientData clientData);
+
+static void
+destroy_watch_mark(void *ptr)
+{
+    struct destroy_watch *dw = ptr;
+    rb_gc_mark(dw->callback);
+    rb_gc_mark(dw->pending);
+}
+
+static int destroy_generic(ClientData clientData, XEvent *eventPtr);
+static void destroy_interp_deleted(ClientData clientData, Tcl_Interp *interp);
+
+static void
+destroy_watch_uninstall(struct destroy_watch *dw)
+{
+    if (!dw->installed) return;
+    Tk_DeleteGenericHandler(destroy_generic, (ClientData)dw);
+    Tcl_DontCallWhenDeleted(dw->interp, destroy_interp_deleted, (ClientData)dw);
+    if (dw->idle_scheduled) {
+        Tcl_CancelIdleCall(destroy_idle_flush, (ClientData)dw);
+        dw->idle_scheduled = 0;
+    }
+    dw->installed = 0;
+}
+
+static void
+destroy_watch_free(void *ptr)
+{
+    struct destroy_watch *dw = ptr;
+    destroy_watch_uninstall(dw);
+    xfree(dw);
+}
+
+static const rb_data_type_t destroy_watch_type = {
+    .wrap_struct_name = "TclTkBridge::DestroyWatch",
+    .function = {
+        .dmark = destroy_watch_mark,
+        .dfree = destroy_watch_free,
+        .dsize = NULL,
+    },
+    .flags = RUBY_TYPED_FREE_IMMEDIATELY,
+};
+
+/*
+ * Tk_GenericProc: sees Tk's own DestroyNotify for each window while the
+ * window (and its path) still exists. Never consumes the event.
+ */
+static int
+destroy_generic(ClientData clientData, XEvent *eventPtr)
+{
+    struct destroy_watch *dw = (struct destroy_watch *)clientData;
+    Tk_Window tkwin;
+    const char *path;
+
+    if (eventPtr->type != DestroyNotify ||
+        eventPtr->xdestroywindow.event != eventPtr->xdestroywindow.window) {
+        return 0;
+    }
+    tkwin = Tk_IdToWindow(eventPtr->xany.display, eventPtr->xdestroywindow.window);
+    if (tkwin == NULL || Tk_Interp(tkwin) != dw->interp) return 0;
+    path = Tk_PathName(tkwin);
+    if (path == NULL) return 0;
+
+    rb_ary_push(dw->pending, rb_utf8_str_new_cstr(path));
+    if (!dw->idle_scheduled) {
+        Tcl_DoWhenIdle(destroy_idle_flush, (ClientData)dw);
+        dw->idle_scheduled = 1;
+    }
+    return 0;
+}
+
+/* The interp goes first: stop watching before its windows go away */
+static void
+destroy_interp_deleted(ClientData clientData, Tcl_Interp *interp)
+{
+    destroy_watch_uninstall((struct destroy_watch *)clientData);
+}
+
+static VALUE
+destroy_call(VALUE varg)
+{
+    VALUE *args = (VALUE *)varg;
+    return rb_funcall(args[0], id_call, 1, args[1]);
+}
+
+/* Hand collected paths to Ruby; errors go to the background error handler */
+static void
+destroy_flush(struct destroy_watch *dw)
+{
+    VALUE paths, args[2];
+    Tk_Window mainWin;
+    long i, n;
+    int state;
+
+    if (dw->idle_scheduled) {
+        Tcl_CancelIdleCall(destroy_idle_flush, (ClientData)dw);
+        dw->idle_scheduled = 0;
+    }
+    if (RARRAY_LEN(dw->pending) == 0) return;
+
+    paths = dw->pending;
+    dw->pending = rb_ary_new();
+
+    /* A path recreated before a deferred flush belongs to the new window */
+    mainWin = Tk_MainWindow(dw->interp);
+    if (mainWin) {
+        n = RARRAY_LEN(paths);
+        for (i = n - 1; i >= 0; i--) {
+            VALUE path = RARRAY_AREF(paths, i);
+            if (Tk_NameToWindow(dw->interp, RSTRING_PTR(path), mainWin)) {
+                rb_ary_delete_at(paths, i);
+            }
+        }
+        Tcl_ResetResult(dw->interp);
+    }
+    if (RARRAY_LEN(paths) == 0) return;
+
+    args[0] = dw->callback;
+    args[1] = paths;
+    rb_protect(destroy_call, (VALUE)args, &state);
+    if (state) {
+        VALUE errinfo = rb_errinfo();
+        VALUE msg;
+        rb_set_errinfo(Qnil);
+
+        if (rb_obj_is_kind_of(errinfo, rb_eSystemExit) ||
+            rb_obj_is_kind_of(errinfo, rb_eInterrupt)) {
+            rb_exc_raise(errinfo);
+        }
+        msg = rb_funcall(errinfo, rb_intern("message"), 0);
+        Tcl_SetObjResult(dw->interp, Tcl_NewStringObj(StringValueCStr(msg), -1));
+        Tcl_BackgroundException(dw->interp, TCL_ERROR);
+    }
+}
+
+static void
+destroy_idle_flush(ClientData clientData)
+{
+    struct destroy_watch *dw = (struct destroy_watch *)clientData;
+    dw->idle_scheduled = 0;
+    destroy_flush(dw);
+}
+
+/* Tcl command ::tk::rbDestroyFlush - run as a leave trace on "destroy" */
+static int
+destroy_flush_cmd(ClientData clientData, Tcl_Interp *interp,
+                  RBTK_OBJC_TYPE objc, Tcl_Obj *const objv[])
+{
+    Tcl_Obj *result = Tcl_GetObjResult(interp);
+
+    /* Keep the traced command's result intact */
+    Tcl_IncrRefCount(result);
+    destroy_flush((struct destroy_watch *)clientData);
+    Tcl_SetObjResult(interp, result);
+    Tcl_DecrRefCount(result);
+    return TCL_OK;
+}
+
+static struct destroy_watch *
+destroy_watch_get(VALUE self)
+{
+    VALUE obj = rb_ivar_get(self, id_destroy_watch);
+    struct destroy_watch *dw;
+
+    if (NIL_P(obj)) return NULL;
+    TypedData_Get_Struct(obj, struct destroy_watch, &destroy_watch_type, dw);
+    return dw;
+}
+
+/* ---------------------------------------------------------
+ * Interp#destroy_watch(callback) - Batch widget destroy notifications
+ *
+ * Arguments:
+ *   callback - Object whose #call receives an Array of destroyed paths
+ *
+ * Every window this interpreter's Tk destroys is recorded (children
+ * before parents, as Tk destroys them). The batch is delivered once the
+ * Tcl "destroy" command returns, via an execution trace, or at idle
+ * time for windows destroyed any other way. Paths that exist again by
+ * then (recreated) are left out.
+ *
+ * Replaces any previous callback.
+ *
+ * See: https://www.tcl-lang.org/man/tcl8.6/TkLib/CrtGenHdlr.htm
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_destroy_watch(VALUE self, VALUE callback)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    struct destroy_watch *dw;
+    VALUE obj;
+
+    if (!rb_respond_to(callback, id_call)) {
+        rb_raise(rb_eArgError, "destroy callback must respond to #call");
+    }
+    dw = destroy_watch_get(self);
+    if (dw) {
+        dw->callback = callback;
+        return Qnil;
+    }
+    if (!Tk_MainWindow(tip->interp)) {
+        rb_raise(eTclError, "Tk not initialized (no main window)");
+    }
+
+    obj = TypedData_Make_Struct(rb_cObject, struct destroy_watch, &destroy_watch_type, dw);
+    dw->interp = tip->interp;
+    dw->callback = callback;
+    dw->pending = rb_ary_new();
+    rb_ivar_set(self, id_destroy_watch, obj);
+
+    Tcl_CreateObjCommand(tip->interp, "::tk::rbDestroyFlush", destroy_flush_cmd,
+                         (ClientData)dw, NULL);
+    if (Tcl_EvalEx(tip->interp,
+                   "trace add execution destroy leave ::tk::rbDestroyFlush",
+                   -1, TCL_EVAL_GLOBAL) != TCL_OK) {
+        rb_raise(eTclError, "%s", Tcl_GetStringResult(tip->interp));
+    }
+    Tk_CreateGenericHandler(destroy_generic, (ClientData)dw);
+    Tcl_CallWhenDeleted(tip->interp, destroy_interp_deleted, (ClientData)dw);
+    dw->installed = 1;
+
+    return Qnil;
+}
+
+/* ---------------------------------------------------------
+ * Interp#destroy_flush - Deliver pending destroy notifications now
+ *
+ * Returns nil.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_destroy_flush(VALUE self)
+{
+    struct destroy_watch *dw;
+
+    get_interp(self);
+    dw = destroy_watch_get(self);
+    if (dw) destroy_flush(dw);
+    return Qnil;
+}
+
+/* ---------------------------------------------------------
+ * Init_tkdestroy - Register destroy batching methods on TclTkIp class
+ *
+ * Called from Init_tcltklib in tcltkbridge.c
+ * --------------------------------------------------------- */
+
+void
+Init_tkdestroy(VALUE cTclTkIp)
+{
+    id_destroy_watch = rb_intern("destroy_watch");
+    id_call = rb_intern("call");
+
+    rb_define_method(cTclTkIp, "destroy_watch", interp_destroy_watch, 1);
+    rb_define_method(cTclTkIp, "destroy_flush", interp_destroy_flush, 0);
+}
@@ -0,0 +1,215 @@
+/* tkevents.c - Batched synthetic event generation for tk-ng
+ *
+ * Interp#event_generate_many generates a list of events in one bridge
+ * call. Each event becomes an "event generate" command built straight
+ * into an objv array and run with Tcl_EvalObjv, so replaying thousands
+ * of recorded key and mouse events costs no Ruby option-list building
+ * or Tcl script parsing per event. The "event" and "generate" words are
+ * shared by the whole batch, so the command lookup is cached.
+ */
+
+#include "tcltkbridge.h"
+#include <string.h>
+
+static ID id_path;
+
+static double
+wall_seconds(void)
+{
+    Tcl_Time t;
+    Tcl_GetTime(&t);
+    return t.sec + t.usec / 1e6;
+}
+
+/* Window: path String, or anything with #path (TkWindow) */
+static VALUE
+event_window_str(VALUE win)
+{
+    if (!RB_TYPE_P(win, T_STRING)) {
+        win = rb_respond_to(win, id_path) ? rb_funcall(win, id_path, 0)
+                                          : rb_obj_as_string(win);
+        StringValue(win);
+    }
+    return win;
+}
+
+/* Type: "<Button-1>", "Button-1", :Motion or "<<Virtual>>" */
+static VALUE
+event_type_str(VALUE type)
+{
+    if (SYMBOL_P(type)) type = rb_sym2str(type);
+    StringValue(type);
+    if (RSTRING_LEN(type) > 0 && RSTRING_PTR(type)[0] == '<') return type;
+    return rb_sprintf("<%"PRIsVALUE">", type);
+}
+
+/* Field value: Integers stay integers, true/false become 1/0 */
+static VALUE
+event_value_prep(VALUE val)
+{
+    if (RB_INTEGER_TYPE_P(val)) {
+        NUM2LL(val);  /* range check now, not mid-batch */
+        return val;
+    }
+    if (val == Qtrue) return INT2FIX(1);
+    if (val == Qfalse) return INT2FIX(0);
+    if (NIL_P(val)) return rb_str_new(NULL, 0);
+    if (SYMBOL_P(val)) return rb_sym2str(val);
+    return rb_obj_as_string(val);
+}
+
+static Tcl_Obj *
+event_word_obj(VALUE word)
+{
+    if (RB_INTEGER_TYPE_P(word)) return Tcl_NewWideIntObj(NUM2LL(word));
+    return Tcl_NewStringObj(RSTRING_PTR(word), (RBTK_STRLEN_TYPE)RSTRING_LEN(word));
+}
+
+/* Prepared event: [window, type, has_when, "-field", value, ...] */
+static int
+event_field_i(VALUE key, VALUE val, VALUE words)
+{
+    VALUE name;
+
+    if (SYMBOL_P(key)) key = rb_sym2str(key);
+    key = rb_obj_as_string(key);
+    name = RSTRING_LEN(key) > 0 && RSTRING_PTR(key)[0] == '-'
+         ? rb_str_dup(key) : rb_str_plus(rb_str_new_cstr("-"), key);
+    if (strcmp(StringValueCStr(name), "-when") == 0) rb_ary_store(words, 2, Qtrue);
+    rb_ary_push(words, name);
+    rb_ary_push(words, event_value_prep(val));
+    return ST_CONTINUE;
+}
+
+/* ---------------------------------------------------------
+ * Interp#event_generate_many(events, opts={}) - Generate many events
+ *
+ * events is an Array of [window, type] or [window, type, fields]
+ * tuples: window is a path or TkWindow, type an event pattern with or
+ * without the angle brackets, fields a Hash of event generate options
+ * without the dash ({x: 10, y: 5, button: 1}).
+ *
+ * Options:
+ *   sync: false (default) - each event is queued with -when tail and
+ *                           dispatched by the event loop later
+ *   sync: true            - each event is dispatched before the next
+ *                           one is generated; time includes handling
+ *                           by bindings
+ *
+ * A "when" field on an event overrides the batch mode for that event.
+ * Key events go to the focus window, as with event generate.
+ *
+ * Returns Hash {count:, time:} - events generated and seconds spent.
+ *
+ * Raises TclError naming the failing event's index; events before it
+ * have already been generated.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_event_generate_many(int argc, VALUE *argv, VALUE self)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    VALUE events, opts, prepared, result;
+    Tcl_Obj *event_word, *generate_word, *when_word, *tail_word, **objv;
+    int sync = 0, rc = TCL_OK;
+    long i, n, max_words = 0;
+    double start, elapsed;
+
+    rb_scan_args(argc, argv, "11", &events, &opts);
+    Check_Type(events, T_ARRAY);
+    if (!NIL_P(opts)) {
+        Check_Type(opts, T_HASH);
+        sync = RTEST(rb_hash_aref(opts, ID2SYM(rb_intern("sync"))));
+    }
+
+    /* Convert every event to plain words first, into an Array Ruby code
+     * cannot reach: with sync: true bindings run between events and may
+     * change events, and conversions (#path, #to_s) may raise; neither
+     * must happen once Tcl objects exist. */
+    n = RARRAY_LEN(events);
+    prepared = rb_ary_new2(n);
+    for (i = 0; i < n && i < RARRAY_LEN(events); i++) {
+        VALUE ev = RARRAY_AREF(events, i), words;
+
+        Check_Type(ev, T_ARRAY);
+        if (RARRAY_LEN(ev) < 2 || RARRAY_LEN(ev) > 3) {
+            rb_raise(rb_eArgError, "event %ld: expected [window, type] or [window, type, fields]", i);
+        }
+        if (!SYMBOL_P(RARRAY_AREF(ev, 1))) Check_Type(RARRAY_AREF(ev, 1), T_STRING);
+        words = rb_ary_new_from_args(3, event_window_str(rb_ary_entry(ev, 0)),
+                                     event_type_str(rb_ary_entry(ev, 1)), Qfalse);
+        if (RARRAY_LEN(ev) == 3 && !NIL_P(RARRAY_AREF(ev, 2))) {
+            VALUE fields = RARRAY_AREF(ev, 2);
+            Check_Type(fields, T_HASH);
+            rb_hash_foreach(rb_hash_dup(fields), event_field_i, words);
+        }
+        if (RARRAY_LEN(words) > max_words) max_words = RARRAY_LEN(words);
+        rb_ary_push(prepared, words);
+    }
+    n = RARRAY_LEN(prepared);
+
+    /* event generate win type ?-field value ...? ?-when tail? */
+    objv = ALLOCA_N(Tcl_Obj *, max_words + 3);
+    event_word = Tcl_NewStringObj("event", -1);
+    generate_word = Tcl_NewStringObj("generate", -1);
+    when_word = Tcl_NewStringObj("-when", -1);
+    tail_word = Tcl_NewStringObj("tail", -1);
+    Tcl_IncrRefCount(event_word);
+    Tcl_IncrRefCount(generate_word);
+    Tcl_IncrRefCount(when_word);
+    Tcl_IncrRefCount(tail_word);
+
+    start = wall_seconds();
+    for (i = 0; i < n && rc == TCL_OK; i++) {
+        VALUE words = RARRAY_AREF(prepared, i);
+        long w, nwords = RARRAY_LEN(words);
+        int j, objc = 0;
+
+        objv[objc++] = event_word;
+        objv[objc++] = generate_word;
+        objv[objc++] = event_word_obj(RARRAY_AREF(words, 0));
+        objv[objc++] = event_word_obj(RARRAY_AREF(words, 1));
+        for (w = 3; w < nwords; w++) {
+            objv[objc++] = event_word_obj(RARRAY_AREF(words, w));
+        }
+        if (!sync && !RTEST(RARRAY_AREF(words, 2))) {
+            objv[objc++] = when_word;
+            objv[objc++] = tail_word;
+        }
+
+        for (j = 0; j < objc; j++) Tcl_IncrRefCount(objv[j]);
+        rc = Tcl_EvalObjv(tip->interp, objc, objv, 0);
+        for (j = 0; j < objc; j++) Tcl_DecrRefCount(objv[j]);
+    }
+    elapsed = wall_seconds() - start;
+    RB_GC_GUARD(prepared);
+
+    Tcl_DecrRefCount(event_word);
+    Tcl_DecrRefCount(generate_word);
+    Tcl_DecrRefCount(when_word);
+    Tcl_DecrRefCount(tail_word);
+
+    if (rc != TCL_OK) {
+        rb_raise(eTclError, "event %ld: %s", i - 1, Tcl_GetStringResult(tip->interp));
+    }
+    Tcl_ResetResult(tip->interp);
+
+    result = rb_hash_new();
+    rb_hash_aset(result, ID2SYM(rb_intern("count")), LONG2NUM(n));
+    rb_hash_aset(result, ID2SYM(rb_intern("time")), DBL2NUM(elapsed));
+    return result;
+}
+
+/* ---------------------------------------------------------
+ * Init_tkevents - Register batched event methods on TclTkIp class
+ *
+ * Called from Init_tcltklib in tcltkbridge.c
+ * --------------------------------------------------------- */
+
+void
+Init_tkevents(VALUE cTclTkIp)
+{
+    id_path = rb_intern("path");
+
+    rb_define_method(cTclTkIp, "event_generate_many", interp_event_generate_many, -1);
+}
@@ -0,0 +1,123 @@
+/* tkmenu.c - Bulk menu construction for tk-ng
+ *
+ * Interp#menu_add_entries adds a whole list of menu entries in one
+ * bridge call: each entry becomes a "$menu add type -opt value ..."
+ * command built straight into an objv array and run with Tcl_EvalObjv.
+ * Menus with hundreds of entries that are rebuilt every time they are
+ * posted ("recent files", window lists) then cost one call instead of
+ * one round trip and one option-list conversion per entry.
+ *
+ * Entry commands are prepared on the Ruby side (Tk::Menu#add_entries)
+ * as slots of one dispatcher per menu, so no callback is registered
+ * per entry.
+ */
+
+#include "tcltkbridge.h"
+
+/* ---------------------------------------------------------
+ * Interp#menu_add_entries(path, entries, opts={}) - Add many entries
+ *
+ * entries is an Array of word Arrays, one per entry: the entry type
+ * followed by option/value Strings,
+ *   [["command", "-label", "Open", "-command", "..."], ["separator"]]
+ *
+ * Options:
+ *   replace: true - delete the existing entries first (a tearoff
+ *                   entry is kept, as with "delete 0 end")
+ *
+ * Returns the number of entries added.
+ *
+ * Raises TclError naming the failing entry's index; entries before it
+ * have already been added.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_menu_add_entries(int argc, VALUE *argv, VALUE self)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    VALUE path, entries, opts;
+    Tcl_Obj *menu_word, *add_word, **objv;
+    int replace = 0, rc = TCL_OK;
+    long i, n, max_words = 0;
+
+    rb_scan_args(argc, argv, "21", &path, &entries, &opts);
+    StringValue(path);
+    Check_Type(entries, T_ARRAY);
+    if (!NIL_P(opts)) {
+        Check_Type(opts, T_HASH);
+        replace = RTEST(rb_hash_aref(opts, ID2SYM(rb_intern("replace"))));
+    }
+
+    n = RARRAY_LEN(entries);
+    for (i = 0; i < n; i++) {
+        VALUE entry = RARRAY_AREF(entries, i);
+        long j;
+
+        Check_Type(entry, T_ARRAY);
+        if (RARRAY_LEN(entry) < 1 || RARRAY_LEN(entry) % 2 == 0) {
+            rb_raise(rb_eArgError, "entry %ld: expected [type, option, value, ...]", i);
+        }
+        for (j = 0; j < RARRAY_LEN(entry); j++) {
+            Check_Type(RARRAY_AREF(entry, j), T_STRING);
+        }
+        if (RARRAY_LEN(entry) > max_words) max_words = RARRAY_LEN(entry);
+    }
+
+    menu_word = Tcl_NewStringObj(RSTRING_PTR(path), (RBTK_STRLEN_TYPE)RSTRING_LEN(path));
+    add_word = Tcl_NewStringObj("add", -1);
+    Tcl_IncrRefCount(menu_word);
+    Tcl_IncrRefCount(add_word);
+
+    if (replace) {
+        Tcl_Obj *del[4];
+        int k;
+
+        del[0] = menu_word;
+        del[1] = Tcl_NewStringObj("delete", -1);
+        del[2] = Tcl_NewIntObj(0);
+        del[3] = Tcl_NewStringObj("end", -1);
+        for (k = 1; k < 4; k++) Tcl_IncrRefCount(del[k]);
+        rc = Tcl_EvalObjv(tip->interp, 4, del, 0);
+        for (k = 1; k < 4; k++) Tcl_DecrRefCount(del[k]);
+    }
+
+    /* menu add type ?-option value ...? */
+    objv = ALLOCA_N(Tcl_Obj *, 2 + max_words);
+    objv[0] = menu_word;
+    objv[1] = add_word;
+    for (i = 0; i < n && rc == TCL_OK; i++) {
+        VALUE entry = RARRAY_AREF(entries, i);
+        int j, objc = 2;
+
+        for (j = 0; j < RARRAY_LEN(entry); j++) {
+            VALUE word = RARRAY_AREF(entry, j);
+            objv[objc] = Tcl_NewStringObj(RSTRING_PTR(word), (RBTK_STRLEN_TYPE)RSTRING_LEN(word));
+            Tcl_IncrRefCount(objv[objc]);
+            objc++;
+        }
+        rc = Tcl_EvalObjv(tip->interp, objc, objv, 0);
+        for (j = 2; j < objc; j++) Tcl_DecrRefCount(objv[j]);
+    }
+
+    Tcl_DecrRefCount(menu_word);
+    Tcl_DecrRefCount(add_word);
+
+    if (rc != TCL_OK) {
+        if (i == 0) rb_raise(eTclError, "%s", Tcl_GetStringResult(tip->interp));
+        rb_raise(eTclError, "entry %ld: %s", i - 1, Tcl_GetStringResult(tip->interp));
+    }
+    Tcl_ResetResult(tip->interp);
+    return LONG2NUM(n);
+}
+
+/* ---------------------------------------------------------
+ * Init_tkmenu - Register bulk menu methods on TclTkIp class
+ *
+ * Called from Init_tcltklib in tcltkbridge.c
+ * --------------------------------------------------------- */
+
+void
+Init_tkmenu(VALUE cTclTkIp)
+{
+    rb_define_method(cTclTkIp, "menu_add_entries", interp_menu_add_entries, -1);
+}
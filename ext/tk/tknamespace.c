@@ -0,0 +1,98 @@
+/* tknamespace.c - Namespace-scoped command dispatch for tk-ng
+ *
+ * TkNamespace used to run every command as a "namespace eval ns {...}"
+ * script assembled in Ruby, which Tcl then parsed and compiled on each
+ * call. Interp#ns_invoke hands namespace eval a pure list object built
+ * from the argument objects instead; Tcl evaluates a list without a
+ * string representation directly as one command (the same path
+ * Tcl_EvalObjv takes), so nothing is parsed or compiled.
+ *
+ * The frame is pushed by namespace eval itself because
+ * Tcl_PushCallFrame is not in the public stubs table.
+ */
+
+#include "tcltkbridge.h"
+
+/* ---------------------------------------------------------
+ * Interp#ns_invoke(namespace, *args) - Invoke a command in a namespace
+ *
+ * Same result as tcl_invoke("namespace", "eval", namespace,
+ * [args as a list]) without building or compiling a script. Command
+ * and variable names resolve relative to namespace, which is created
+ * if it does not exist (as namespace eval does).
+ *
+ * Thread-safe: from a background thread the call is queued to the
+ * main thread as the equivalent tcl_invoke.
+ *
+ * Raises TclError if the command fails.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_ns_invoke(int argc, VALUE *argv, VALUE self)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    Tcl_Obj *words[4], **objv;
+    VALUE name;
+    int i, objc, result;
+
+    if (argc < 2) {
+        rb_raise(rb_eArgError, "wrong number of arguments (given %d, expected 2+)", argc);
+    }
+    name = argv[0];
+    StringValue(name);
+    for (i = 1; i < argc; i++) {
+        if (!NIL_P(argv[i])) StringValue(argv[i]);
+    }
+
+    if (Tcl_GetCurrentThread() != tip->main_thread_id) {
+        const char **strs = ALLOCA_N(const char *, argc - 1);
+        char *merged;
+        VALUE script;
+
+        for (i = 1; i < argc; i++) {
+            strs[i - 1] = NIL_P(argv[i]) ? "" : StringValueCStr(argv[i]);
+        }
+        merged = Tcl_Merge(argc - 1, strs);
+        script = rb_utf8_str_new_cstr(merged);
+        Tcl_Free(merged);
+        return rb_funcall(self, rb_intern("tcl_invoke"), 4,
+                          rb_str_new_cstr("namespace"), rb_str_new_cstr("eval"),
+                          name, script);
+    }
+
+    objc = argc - 1;
+    objv = ALLOCA_N(Tcl_Obj *, objc);
+    for (i = 0; i < objc; i++) {
+        VALUE arg = argv[i + 1];
+        objv[i] = NIL_P(arg) ? Tcl_NewObj()
+                             : Tcl_NewStringObj(RSTRING_PTR(arg),
+                                                (RBTK_STRLEN_TYPE)RSTRING_LEN(arg));
+    }
+
+    words[0] = Tcl_NewStringObj("::namespace", -1);
+    words[1] = Tcl_NewStringObj("eval", -1);
+    words[2] = Tcl_NewStringObj(RSTRING_PTR(name), (RBTK_STRLEN_TYPE)RSTRING_LEN(name));
+    words[3] = Tcl_NewListObj(objc, objv);   /* pure list: no string rep */
+    for (i = 0; i < 4; i++) Tcl_IncrRefCount(words[i]);
+
+    result = Tcl_EvalObjv(tip->interp, 4, words, 0);
+
+    for (i = 0; i < 4; i++) Tcl_DecrRefCount(words[i]);
+
+    if (result != TCL_OK) {
+        rb_raise(eTclError, "%s", Tcl_GetStringResult(tip->interp));
+    }
+    return rb_utf8_str_new_cstr(Tcl_GetStringResult(tip->interp));
+}
+
+/* ---------------------------------------------------------
+ * Init_tknamespace - Register namespace dispatch on TclTkIp class
+ *
+ * Called from Init_tcltklib in tcltkbridge.c
+ * --------------------------------------------------------- */
+
+void
+Init_tknamespace(VALUE cTclTkIp)
+{
+    rb_define_method(cTclTkIp, "ns_invoke", interp_ns_invoke, -1);
+}
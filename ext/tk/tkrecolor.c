@@ -0,0 +1,564 @@
+/* tkrecolor.c - Native palette recoloring for tk-ng
+ *
+ * tk_setPalette recolors through tk::RecolorTree, a Tcl proc that runs
+ * several commands per option per window. Interp#recolor_tree does the
+ * same walk from C: one "configure" query and at most one "configure"
+ * update per window, with colors compared as RGB values resolved once
+ * per pass. Options that already have the target color are skipped.
+ * Nothing enters the event loop during the pass, so widgets redraw once
+ * afterwards (at idle), not once per option.
+ *
+ * Interp#ttk_restyle is the themed-widget path: ttk widgets take their
+ * colors from styles, so a theme switch is a batch of "ttk::style
+ * configure/map" calls; ttk refreshes all widgets once at idle.
+ *
+ * Tk's public API has no way to enumerate a Tk_Window's children, so
+ * the walk asks "winfo children" (one objv call per window).
+ */
+
+#include "tcltkbridge.h"
+#include <string.h>
+
+#define RGB_INVALID (-1L)
+
+struct recolor_pass {
+    Tcl_Interp *interp;
+    Tk_Window mainWin;
+    Tcl_HashTable rgb_cache;    /* color name => packed RGB */
+    Tcl_Obj *configure_word;
+    Tcl_Obj **names;            /* dbOption names, parallel to values */
+    Tcl_Obj **values;
+    long *targets;              /* packed RGB of values */
+    long *from;                 /* packed RGB of old colors, or NULL */
+    int ncolors;
+    Tcl_Obj *class_options;     /* dict: *Class.dbOption => value */
+    long windows, configured, options, skipped;
+};
+
+/* Packed 16-bit-per-channel RGB of a color name, cached per pass */
+static long
+recolor_rgb(struct recolor_pass *p, const char *name)
+{
+    Tcl_HashEntry *entry;
+    XColor *color;
+    long rgb = RGB_INVALID;
+    int isNew;
+
+    if (*name == '\0') return RGB_INVALID;
+    entry = Tcl_CreateHashEntry(&p->rgb_cache, name, &isNew);
+    if (!isNew) return (long)(intptr_t)Tcl_GetHashValue(entry);
+
+    color = Tk_GetColor(NULL, p->mainWin, Tk_GetUid(name));
+    if (color) {
+        rgb = ((long)(color->red >> 8) << 16) | ((color->green >> 8) << 8) | (color->blue >> 8);
+        Tk_FreeColor(color);
+    }
+    Tcl_SetHashValue(entry, (ClientData)(intptr_t)rgb);
+    return rgb;
+}
+
+/* Index of dbName in the pass colors, or -1 */
+static int
+recolor_find(struct recolor_pass *p, const char *dbName)
+{
+    int i;
+
+    for (i = 0; i < p->ncolors; i++) {
+        if (strcmp(Tcl_GetString(p->names[i]), dbName) == 0) return i;
+    }
+    return -1;
+}
+
+/*
+ * Should this option change? With from colors: only if it currently
+ * shows the old color. Otherwise (tk::RecolorTree rule): only if it
+ * still has its default - the option database value if there is one,
+ * else the widget's built-in default - i.e. the user did not set it.
+ */
+static int
+recolor_wanted(struct recolor_pass *p, Tk_Window tkwin, int i,
+               Tcl_Obj *const spec[], long current)
+{
+    long expected;
+
+    if (p->from) {
+        expected = p->from[i];
+    } else {
+        Tk_Uid dbValue = Tk_GetOption(tkwin, Tcl_GetString(spec[1]), Tcl_GetString(spec[2]));
+        expected = recolor_rgb(p, dbValue ? dbValue : Tcl_GetString(spec[3]));
+    }
+    return expected != RGB_INVALID && expected == current;
+}
+
+static int
+recolor_window(struct recolor_pass *p, Tcl_Obj *path)
+{
+    Tcl_Interp *interp = p->interp;
+    Tk_Window tkwin;
+    Tcl_Obj *query[2], *current_specs, **specs, *cmd;
+    Tcl_Size nspecs, k;
+    int changed = 0, rc = TCL_OK;
+
+    tkwin = Tk_NameToWindow(interp, Tcl_GetString(path), p->mainWin);
+    if (!tkwin) return TCL_ERROR;
+    p->windows++;
+
+    /* One query for every option; windows without configure are skipped */
+    query[0] = path;
+    query[1] = p->configure_word;
+    if (Tcl_EvalObjv(interp, 2, query, TCL_EVAL_GLOBAL) != TCL_OK) {
+        Tcl_ResetResult(interp);
+        return TCL_OK;
+    }
+    current_specs = Tcl_GetObjResult(interp);
+    Tcl_IncrRefCount(current_specs);
+
+    cmd = Tcl_NewListObj(2, query);
+    Tcl_IncrRefCount(cmd);
+    if (Tcl_ListObjGetElements(NULL, current_specs, &nspecs, &specs) != TCL_OK) nspecs = 0;
+
+    for (k = 0; k < nspecs; k++) {
+        Tcl_Obj **spec;
+        Tcl_Size n;
+        long current;
+        int i;
+
+        /* {-option dbName dbClass default current}; skips aliases */
+        if (Tcl_ListObjGetElements(NULL, specs[k], &n, &spec) != TCL_OK || n != 5) continue;
+        i = recolor_find(p, Tcl_GetString(spec[1]));
+        if (i < 0) continue;
+
+        current = recolor_rgb(p, Tcl_GetString(spec[4]));
+        if (current == p->targets[i]) {
+            p->skipped++;
+            continue;
+        }
+        if (!recolor_wanted(p, tkwin, i, spec, current)) continue;
+
+        Tcl_ListObjAppendElement(NULL, cmd, spec[0]);
+        Tcl_ListObjAppendElement(NULL, cmd, p->values[i]);
+        if (p->class_options) {
+            Tcl_Obj *key = Tcl_ObjPrintf("*%s.%s", Tk_Class(tkwin), Tcl_GetString(spec[1]));
+            Tcl_DictObjPut(NULL, p->class_options, key, p->values[i]);
+        }
+        changed++;
+    }
+    Tcl_DecrRefCount(current_specs);
+
+    /* All of this window's changes in one configure */
+    if (changed) {
+        rc = Tcl_EvalObjEx(interp, cmd, TCL_EVAL_GLOBAL);
+        if (rc == TCL_OK) {
+            p->configured++;
+            p->options += changed;
+        }
+    }
+    Tcl_DecrRefCount(cmd);
+    if (rc == TCL_OK) Tcl_ResetResult(interp);
+    return rc;
+}
+
+/* Breadth-first over path and its descendants */
+static int
+recolor_walk(struct recolor_pass *p, Tcl_Obj *root)
+{
+    Tcl_Obj *queue, *query[3], **children;
+    Tcl_Size head = 0, len, nchildren, k;
+    int rc = TCL_OK;
+
+    queue = Tcl_NewListObj(1, &root);
+    Tcl_IncrRefCount(queue);
+    query[0] = Tcl_NewStringObj("winfo", -1);
+    query[1] = Tcl_NewStringObj("children", -1);
+    Tcl_IncrRefCount(query[0]);
+    Tcl_IncrRefCount(query[1]);
+
+    while (rc == TCL_OK &&
+           Tcl_ListObjLength(NULL, queue, &len) == TCL_OK && head < len) {
+        Tcl_Obj *path;
+
+        Tcl_ListObjIndex(NULL, queue, head++, &path);
+        Tcl_IncrRefCount(path);
+        rc = recolor_window(p, path);
+        if (rc == TCL_OK) {
+            query[2] = path;
+            rc = Tcl_EvalObjv(p->interp, 3, query, TCL_EVAL_GLOBAL);
+            if (rc == TCL_OK &&
+                Tcl_ListObjGetElements(NULL, Tcl_GetObjResult(p->interp),
+                                       &nchildren, &children) == TCL_OK) {
+                for (k = 0; k < nchildren; k++) {
+                    Tcl_ListObjAppendElement(NULL, queue, children[k]);
+                }
+            }
+        }
+        Tcl_DecrRefCount(path);
+    }
+
+    Tcl_DecrRefCount(query[0]);
+    Tcl_DecrRefCount(query[1]);
+    Tcl_DecrRefCount(queue);
+    return rc;
+}
+
+struct color_collect {
+    struct recolor_pass *p;
+    VALUE from;
+};
+
+static VALUE
+color_name(VALUE v)
+{
+    if (SYMBOL_P(v)) return rb_sym2str(v);
+    return rb_obj_as_string(v);
+}
+
+static int
+collect_color_i(VALUE key, VALUE val, VALUE arg)
+{
+    struct color_collect *cc = (struct color_collect *)arg;
+    struct recolor_pass *p = cc->p;
+    VALUE name = color_name(key);
+    VALUE value = color_name(val);
+    int i = p->ncolors++;
+
+    p->names[i] = Tcl_NewStringObj(RSTRING_PTR(name), (RBTK_STRLEN_TYPE)RSTRING_LEN(name));
+    p->values[i] = Tcl_NewStringObj(RSTRING_PTR(value), (RBTK_STRLEN_TYPE)RSTRING_LEN(value));
+    Tcl_IncrRefCount(p->names[i]);
+    Tcl_IncrRefCount(p->values[i]);
+    p->targets[i] = recolor_rgb(p, Tcl_GetString(p->values[i]));
+
+    if (p->from) {
+        VALUE old = rb_hash_lookup2(cc->from, key, Qundef);
+        if (old == Qundef) old = rb_hash_lookup2(cc->from, name, Qundef);
+        if (old == Qundef) old = rb_hash_lookup2(cc->from, ID2SYM(rb_intern_str(name)), Qundef);
+        if (old == Qundef || NIL_P(old)) {
+            p->from[i] = RGB_INVALID;
+        } else {
+            old = color_name(old);
+            p->from[i] = recolor_rgb(p, StringValueCStr(old));
+        }
+    }
+    return ST_CONTINUE;
+}
+
+static void
+recolor_pass_free(struct recolor_pass *p)
+{
+    int i;
+
+    for (i = 0; i < p->ncolors; i++) {
+        Tcl_DecrRefCount(p->names[i]);
+        Tcl_DecrRefCount(p->values[i]);
+    }
+    if (p->class_options) Tcl_DecrRefCount(p->class_options);
+    Tcl_DecrRefCount(p->configure_word);
+    Tcl_DeleteHashTable(&p->rgb_cache);
+}
+
+/* ---------------------------------------------------------
+ * Interp#recolor_tree(path, colors, opts={}) - Recolor a window tree
+ *
+ * colors maps option database names to colors, as for tk_setPalette:
+ * {background: "#333", foreground: "white", selectBackground: ...}.
+ * Every window from path down gets the options it has, in one
+ * configure per window.
+ *
+ * Options:
+ *   from:    Hash of the colors being replaced; an option changes only
+ *            if it currently shows the old color. Without it an option
+ *            changes only if it still has its default (the
+ *            tk::RecolorTree rule), so colors set by the application
+ *            are kept.
+ *   options: true to also record the colors in the option database
+ *            (*Class.name per recolored class at priority 60, and
+ *            *name at widgetDefault) so new widgets match, as
+ *            tk_setPalette does.
+ *
+ * Returns Hash {windows:, configured:, options:, skipped:} - windows
+ * visited, windows changed, options changed, options already right.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_recolor_tree(int argc, VALUE *argv, VALUE self)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    struct recolor_pass p;
+    struct color_collect cc;
+    VALUE path, colors, opts, from = Qnil, result;
+    Tcl_Obj *root;
+    long n;
+    int rc, i, record = 0;
+
+    rb_scan_args(argc, argv, "21", &path, &colors, &opts);
+    Check_Type(colors, T_HASH);
+    if (!NIL_P(opts)) {
+        Check_Type(opts, T_HASH);
+        from = rb_hash_aref(opts, ID2SYM(rb_intern("from")));
+        if (!NIL_P(from)) Check_Type(from, T_HASH);
+        record = RTEST(rb_hash_aref(opts, ID2SYM(rb_intern("options"))));
+    }
+    path = color_name(path);
+
+    memset(&p, 0, sizeof(p));
+    p.interp = tip->interp;
+    p.mainWin = Tk_MainWindow(tip->interp);
+    if (!p.mainWin) {
+        rb_raise(eTclError, "Tk not initialized (no main window)");
+    }
+    n = (long)RHASH_SIZE(colors);
+    p.names = ALLOCA_N(Tcl_Obj *, n + 1);
+    p.values = ALLOCA_N(Tcl_Obj *, n + 1);
+    p.targets = ALLOCA_N(long, n + 1);
+    p.from = NIL_P(from) ? NULL : ALLOCA_N(long, n + 1);
+    Tcl_InitHashTable(&p.rgb_cache, TCL_STRING_KEYS);
+    p.configure_word = Tcl_NewStringObj("configure", -1);
+    Tcl_IncrRefCount(p.configure_word);
+    if (record) {
+        p.class_options = Tcl_NewDictObj();
+        Tcl_IncrRefCount(p.class_options);
+    }
+
+    cc.p = &p;
+    cc.from = from;
+    rb_hash_foreach(colors, collect_color_i, (VALUE)&cc);
+    for (i = 0; i < p.ncolors; i++) {
+        if (p.targets[i] == RGB_INVALID) {
+            VALUE msg = rb_sprintf("unknown color name \"%s\"", Tcl_GetString(p.values[i]));
+            recolor_pass_free(&p);
+            rb_exc_raise(rb_exc_new_str(eTclError, msg));
+        }
+    }
+
+    root = Tcl_NewStringObj(RSTRING_PTR(path), (RBTK_STRLEN_TYPE)RSTRING_LEN(path));
+    Tcl_IncrRefCount(root);
+    rc = recolor_walk(&p, root);
+    Tcl_DecrRefCount(root);
+
+    if (rc == TCL_OK && record) {
+        Tcl_DictSearch search;
+        Tcl_Obj *key, *value;
+        int done;
+
+        /* After the walk: the database held the old defaults until now */
+        Tcl_DictObjFirst(NULL, p.class_options, &search, &key, &value, &done);
+        for (; !done; Tcl_DictObjNext(&search, &key, &value, &done)) {
+            Tk_AddOption(p.mainWin, Tcl_GetString(key), Tcl_GetString(value), 60);
+        }
+        Tcl_DictObjDone(&search);
+        for (i = 0; i < p.ncolors; i++) {
+            Tcl_Obj *pattern = Tcl_ObjPrintf("*%s", Tcl_GetString(p.names[i]));
+            Tcl_IncrRefCount(pattern);
+            Tk_AddOption(p.mainWin, Tcl_GetString(pattern), Tcl_GetString(p.values[i]),
+                         TK_WIDGET_DEFAULT_PRIO);
+            Tcl_DecrRefCount(pattern);
+        }
+    }
+
+    if (rc != TCL_OK) {
+        VALUE msg = rb_utf8_str_new_cstr(Tcl_GetStringResult(tip->interp));
+        recolor_pass_free(&p);
+        rb_exc_raise(rb_exc_new_str(eTclError, msg));
+    }
+
+    result = rb_hash_new();
+    rb_hash_aset(result, ID2SYM(rb_intern("windows")), LONG2NUM(p.windows));
+    rb_hash_aset(result, ID2SYM(rb_intern("configured")), LONG2NUM(p.configured));
+    rb_hash_aset(result, ID2SYM(rb_intern("options")), LONG2NUM(p.options));
+    rb_hash_aset(result, ID2SYM(rb_intern("skipped")), LONG2NUM(p.skipped));
+    recolor_pass_free(&p);
+    return result;
+}
+
+/* ---------------------------------------------------------
+ * ttk styles
+ * --------------------------------------------------------- */
+
+struct restyle_pass {
+    Tcl_Interp *interp;
+    Tcl_Obj *style_word;    /* ttk::style */
+    Tcl_Obj *name;          /* style being changed */
+    const char *subcmd;     /* "configure" or "map" */
+    Tcl_Obj *cmd;           /* pending update for this style */
+    long changed, skipped;
+    int error;
+};
+
+static Tcl_Obj *
+restyle_option(VALUE key)
+{
+    VALUE name = color_name(key);
+    const char *s = StringValueCStr(name);
+    return (s[0] == '-') ? Tcl_NewStringObj(s, -1) : Tcl_ObjPrintf("-%s", s);
+}
+
+/* Map values: [["active", "#fff"], ["!disabled", "#000"]] or a Tcl list */
+static Tcl_Obj *
+restyle_value(VALUE val)
+{
+    if (RB_TYPE_P(val, T_ARRAY)) {
+        Tcl_Obj *list = Tcl_NewListObj(0, NULL);
+        long i;
+
+        for (i = 0; i < RARRAY_LEN(val); i++) {
+            VALUE item = RARRAY_AREF(val, i);
+            if (RB_TYPE_P(item, T_ARRAY)) {
+                long j;
+                for (j = 0; j < RARRAY_LEN(item); j++) {
+                    Tcl_ListObjAppendElement(NULL, list, restyle_value(RARRAY_AREF(item, j)));
+                }
+            } else {
+                Tcl_ListObjAppendElement(NULL, list, restyle_value(item));
+            }
+        }
+        return list;
+    }
+    val = color_name(val);
+    return Tcl_NewStringObj(RSTRING_PTR(val), (RBTK_STRLEN_TYPE)RSTRING_LEN(val));
+}
+
+/* Same value? Compared as strings, and as lists for map specs */
+static int
+restyle_same(Tcl_Obj *a, Tcl_Obj *b)
+{
+    Tcl_Obj **av, **bv;
+    Tcl_Size an, bn, i;
+
+    if (strcmp(Tcl_GetString(a), Tcl_GetString(b)) == 0) return 1;
+    if (Tcl_ListObjGetElements(NULL, a, &an, &av) != TCL_OK ||
+        Tcl_ListObjGetElements(NULL, b, &bn, &bv) != TCL_OK || an != bn || an < 2) {
+        return 0;
+    }
+    for (i = 0; i < an; i++) {
+        if (strcmp(Tcl_GetString(av[i]), Tcl_GetString(bv[i])) != 0) return 0;
+    }
+    return 1;
+}
+
+static int
+restyle_option_i(VALUE key, VALUE val, VALUE arg)
+{
+    struct restyle_pass *r = (struct restyle_pass *)arg;
+    Tcl_Obj *query[4], *option, *value;
+
+    option = restyle_option(key);
+    value = restyle_value(val);
+    Tcl_IncrRefCount(option);
+    Tcl_IncrRefCount(value);
+
+    query[0] = r->style_word;
+    query[1] = Tcl_NewStringObj(r->subcmd, -1);
+    query[2] = r->name;
+    query[3] = option;
+    Tcl_IncrRefCount(query[1]);
+    if (Tcl_EvalObjv(r->interp, 4, query, TCL_EVAL_GLOBAL) == TCL_OK &&
+        restyle_same(Tcl_GetObjResult(r->interp), value)) {
+        r->skipped++;
+    } else {
+        Tcl_ListObjAppendElement(NULL, r->cmd, option);
+        Tcl_ListObjAppendElement(NULL, r->cmd, value);
+        r->changed++;
+    }
+    Tcl_DecrRefCount(query[1]);
+    Tcl_DecrRefCount(option);
+    Tcl_DecrRefCount(value);
+    Tcl_ResetResult(r->interp);
+    return ST_CONTINUE;
+}
+
+/* ttk::style configure|map style -opt value ... for the changed options */
+static void
+restyle_apply(struct restyle_pass *r, const char *subcmd, VALUE settings)
+{
+    Tcl_Size before;
+
+    if (NIL_P(settings) || r->error) return;
+    Check_Type(settings, T_HASH);
+    r->subcmd = subcmd;
+    r->cmd = Tcl_NewListObj(0, NULL);
+    Tcl_IncrRefCount(r->cmd);
+    Tcl_ListObjAppendElement(NULL, r->cmd, r->style_word);
+    Tcl_ListObjAppendElement(NULL, r->cmd, Tcl_NewStringObj(subcmd, -1));
+    Tcl_ListObjAppendElement(NULL, r->cmd, r->name);
+    Tcl_ListObjLength(NULL, r->cmd, &before);
+
+    rb_hash_foreach(settings, restyle_option_i, (VALUE)r);
+
+    {
+        Tcl_Size after;
+        Tcl_ListObjLength(NULL, r->cmd, &after);
+        if (after > before && Tcl_EvalObjEx(r->interp, r->cmd, TCL_EVAL_GLOBAL) != TCL_OK) {
+            r->error = 1;
+        }
+    }
+    Tcl_DecrRefCount(r->cmd);
+    r->cmd = NULL;
+}
+
+static int
+restyle_style_i(VALUE key, VALUE val, VALUE arg)
+{
+    struct restyle_pass *r = (struct restyle_pass *)arg;
+    VALUE name = color_name(key);
+
+    Check_Type(val, T_HASH);
+    r->name = Tcl_NewStringObj(RSTRING_PTR(name), (RBTK_STRLEN_TYPE)RSTRING_LEN(name));
+    Tcl_IncrRefCount(r->name);
+    restyle_apply(r, "configure", rb_hash_aref(val, ID2SYM(rb_intern("configure"))));
+    restyle_apply(r, "map", rb_hash_aref(val, ID2SYM(rb_intern("map"))));
+    Tcl_DecrRefCount(r->name);
+    r->name = NULL;
+    return r->error ? ST_STOP : ST_CONTINUE;
+}
+
+/* ---------------------------------------------------------
+ * Interp#ttk_restyle(styles) - Apply many ttk style settings at once
+ *
+ * styles maps style names to {configure: {option => value},
+ * map: {option => [[statespec, value], ...]}}; "." is the root style.
+ * Options whose current setting already matches are skipped; the rest
+ * go out as one "ttk::style configure" and one "ttk::style map" per
+ * style. Ttk redraws its widgets once, at idle, after the batch.
+ *
+ * Returns Hash {changed:, skipped:} counted in options.
+ * Raises TclError if ttk rejects a setting.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_ttk_restyle(VALUE self, VALUE styles)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    struct restyle_pass r;
+    VALUE result;
+
+    Check_Type(styles, T_HASH);
+    memset(&r, 0, sizeof(r));
+    r.interp = tip->interp;
+    r.style_word = Tcl_NewStringObj("::ttk::style", -1);
+    Tcl_IncrRefCount(r.style_word);
+
+    rb_hash_foreach(styles, restyle_style_i, (VALUE)&r);
+    Tcl_DecrRefCount(r.style_word);
+
+    if (r.error) {
+        rb_raise(eTclError, "%s", Tcl_GetStringResult(tip->interp));
+    }
+    Tcl_ResetResult(tip->interp);
+
+    result = rb_hash_new();
+    rb_hash_aset(result, ID2SYM(rb_intern("changed")), LONG2NUM(r.changed));
+    rb_hash_aset(result, ID2SYM(rb_intern("skipped")), LONG2NUM(r.skipped));
+    return result;
+}
+
+/* ---------------------------------------------------------
+ * Init_tkrecolor - Register recoloring methods on TclTkIp class
+ *
+ * Called from Init_tcltklib in tcltkbridge.c
+ * --------------------------------------------------------- */
+
+void
+Init_tkrecolor(VALUE cTclTkIp)
+{
+    rb_define_method(cTclTkIp, "recolor_tree", interp_recolor_tree, -1);
+    rb_define_method(cTclTkIp, "ttk_restyle", interp_ttk_restyle, 1);
+}
@@ -0,0 +1,353 @@
+/* tkreset.c - Interpreter snapshot and reset for tk-ng
+ *
+ * Interp#snapshot records what exists in the interpreter: commands and
+ * namespaces (walked from ::), global variables, loaded packages,
+ * bindings on "." and "all", and registered Ruby callbacks. Interp#reset brings the interpreter back
+ * to that point without creating a new one: it destroys the children
+ * of ".", cancels pending "after" events, deletes whatever was created
+ * since the snapshot and drops queued cross-thread requests.
+ *
+ * Creating an interpreter runs Tcl_Init, Tk_Init and every init hook;
+ * a reset only walks the namespace tree once.
+ *
+ * Shared libraries cannot be unloaded, and "load" of a library the
+ * interpreter already has skips its init function, so a package whose
+ * commands were deleted could never be required again. Snapshot puts
+ * an execution trace on "load" that records the commands, namespaces
+ * and packages each load creates; reset leaves those in place.
+ */
+
+#include "tcltkbridge.h"
+
+struct reset_snapshot {
+    Tcl_Obj *state;     /* dict: commands, namespaces, globals, packages */
+    VALUE callback_ids; /* Hash: callback id => true */
+};
+
+static ID id_reset_snapshot;
+
+static void
+reset_snapshot_mark(void *ptr)
+{
+    struct reset_snapshot *rs = ptr;
+    rb_gc_mark(rs->callback_ids);
+}
+
+static void
+reset_snapshot_free(void *ptr)
+{
+    struct reset_snapshot *rs = ptr;
+    if (rs->state) Tcl_DecrRefCount(rs->state);
+    xfree(rs);
+}
+
+static const rb_data_type_t reset_snapshot_type = {
+    .wrap_struct_name = "TclTkBridge::ResetSnapshot",
+    .function = {
+        .dmark = reset_snapshot_mark,
+        .dfree = reset_snapshot_free,
+        .dsize = NULL,
+    },
+    .flags = RUBY_TYPED_FREE_IMMEDIATELY,
+};
+
+/* Installed by snapshot (idempotent), before the state walk so its own
+ * procs are part of the snapshot */
+static const char load_watch_script[] =
+    "namespace eval ::tk::rbReset {\n"
+    "    variable kept\n"
+    "    variable stack {}\n"
+    "    if {![info exists kept]} { set kept {commands {} namespaces {} packages {}} }\n"
+    "    proc state {} {\n"
+    "        set st {commands {} namespaces {} packages {}}\n"
+    "        set queue ::\n"
+    "        while {[llength $queue]} {\n"
+    "            set queue [lassign $queue ns]\n"
+    "            dict set st namespaces $ns 1\n"
+    "            foreach c [info commands [string trimright $ns :]::*] { dict set st commands $c 1 }\n"
+    "            lappend queue {*}[namespace children $ns]\n"
+    "        }\n"
+    "        foreach p [package names] {\n"
+    "            if {![catch {package present $p}]} { dict set st packages $p 1 }\n"
+    "        }\n"
+    "        return $st\n"
+    "    }\n"
+    "    proc enter args {\n"
+    "        variable stack\n"
+    "        lappend stack [state]\n"
+    "        return\n"
+    "    }\n"
+    "    proc leave args {\n"
+    "        variable stack\n"
+    "        variable kept\n"
+    "        if {![llength $stack]} return\n"
+    "        set before [lindex $stack end]\n"
+    "        set stack [lrange $stack 0 end-1]\n"
+    "        dict for {kind names} [state] {\n"
+    "            foreach name [dict keys $names] {\n"
+    "                if {![dict exists $before $kind $name]} { dict set kept $kind $name 1 }\n"
+    "            }\n"
+    "        }\n"
+    "        return\n"
+    "    }\n"
+    "}\n"
+    "trace remove execution ::load enter ::tk::rbReset::enter\n"
+    "trace remove execution ::load leave ::tk::rbReset::leave\n"
+    "trace add execution ::load enter ::tk::rbReset::enter\n"
+    "trace add execution ::load leave ::tk::rbReset::leave\n";
+
+/*
+ * Both scripts run as apply lambdas so they add no commands or globals
+ * of their own. The namespace walk is shared: snapshot collects every
+ * namespace and command, reset prunes what the snapshot lacks.
+ */
+static const char snapshot_script[] =
+    "apply {{} {\n"
+    "    set cmds {}; set nss {}; set globals {}; set pkgs {}\n"
+    "    set queue ::\n"
+    "    while {[llength $queue]} {\n"
+    "        set queue [lassign $queue ns]\n"
+    "        dict set nss $ns 1\n"
+    "        foreach c [info commands [string trimright $ns :]::*] { dict set cmds $c 1 }\n"
+    "        lappend queue {*}[namespace children $ns]\n"
+    "    }\n"
+    "    foreach v [info globals] { dict set globals $v 1 }\n"
+    "    foreach p [package names] {\n"
+    "        if {![catch {package present $p}]} { dict set pkgs $p 1 }\n"
+    "    }\n"
+    "    set binds {}\n"
+    "    if {[info commands ::bind] ne {}} {\n"
+    "        foreach tag {. all} { foreach e [bind $tag] { dict set binds $tag $e [bind $tag $e] } }\n"
+    "    }\n"
+    "    dict create commands $cmds namespaces $nss globals $globals packages $pkgs bindings $binds\n"
+    "}}";
+
+static const char reset_script[] =
+    "{snap} {\n"
+    "    set windows 0; set cmds 0; set nss 0; set vars 0\n"
+    "    if {[info commands ::winfo] ne {}} {\n"
+    "        foreach w [winfo children .] { if {![catch {destroy $w}]} { incr windows } }\n"
+    "    }\n"
+    "    foreach id [after info] { after cancel $id }\n"
+    "    set keep [dict get $snap bindings]\n"
+    "    if {[info commands ::bind] ne {}} {\n"
+    "        foreach tag {. all} {\n"
+    "            foreach e [bind $tag] {\n"
+    "                if {![dict exists $keep $tag $e]} { bind $tag $e {} }\n"
+    "            }\n"
+    "            if {[dict exists $keep $tag]} {\n"
+    "                dict for {e script} [dict get $keep $tag] { bind $tag $e $script }\n"
+    "            }\n"
+    "        }\n"
+    "    }\n"
+    "    set loaded {commands {} namespaces {} packages {}}\n"
+    "    if {[info exists ::tk::rbReset::kept]} { set loaded $::tk::rbReset::kept }\n"
+    "    set keep [dict merge [dict get $snap packages] [dict get $loaded packages]]\n"
+    "    foreach p [package names] {\n"
+    "        if {[dict exists $keep $p] || [catch {package present $p} v]} continue\n"
+    "        set s [package ifneeded $p $v]\n"
+    "        package forget $p\n"
+    "        if {$s ne {}} { package ifneeded $p $v $s }\n"
+    "    }\n"
+    "    set keep_ns [dict merge [dict get $snap namespaces] [dict get $loaded namespaces]]\n"
+    "    set keep_cmds [dict merge [dict get $snap commands] [dict get $loaded commands]]\n"
+    "    set queue ::\n"
+    "    while {[llength $queue]} {\n"
+    "        set queue [lassign $queue ns]\n"
+    "        foreach c [info commands [string trimright $ns :]::*] {\n"
+    "            if {![dict exists $keep_cmds $c] && ![catch {rename $c {}}]} { incr cmds }\n"
+    "        }\n"
+    "        foreach child [namespace children $ns] {\n"
+    "            if {[dict exists $keep_ns $child]} {\n"
+    "                lappend queue $child\n"
+    "            } elseif {![catch {namespace delete $child}]} {\n"
+    "                incr nss\n"
+    "            }\n"
+    "        }\n"
+    "    }\n"
+    "    set keep [dict get $snap globals]\n"
+    "    foreach v [info globals] {\n"
+    "        if {[dict exists $keep $v]} continue\n"
+    "        foreach t [trace info variable ::$v] { trace remove variable ::$v {*}$t }\n"
+    "        unset -nocomplain ::$v\n"
+    "        incr vars\n"
+    "    }\n"
+    "    list $windows $cmds $nss $vars\n"
+    "}";
+
+static struct reset_snapshot *
+reset_snapshot_get(VALUE self)
+{
+    VALUE obj = rb_ivar_get(self, id_reset_snapshot);
+    struct reset_snapshot *rs;
+
+    if (NIL_P(obj)) return NULL;
+    TypedData_Get_Struct(obj, struct reset_snapshot, &reset_snapshot_type, rs);
+    return rs;
+}
+
+static int
+collect_callback_id(VALUE key, VALUE val, VALUE ids)
+{
+    rb_hash_aset(ids, key, Qtrue);
+    return ST_CONTINUE;
+}
+
+static int
+drop_new_callback(VALUE key, VALUE val, VALUE ids)
+{
+    return rb_hash_lookup2(ids, key, Qundef) == Qundef ? ST_DELETE : ST_CONTINUE;
+}
+
+/* Answer threads blocked on queued requests; their commands will not run */
+static void
+reset_thread_queue(struct tcltk_interp *tip)
+{
+    VALUE err = Qnil;
+    long i;
+
+    for (i = 0; i < RARRAY_LEN(tip->thread_queue); i++) {
+        VALUE cmd = RARRAY_AREF(tip->thread_queue, i);
+        VALUE queue = rb_hash_aref(cmd, ID2SYM(rb_intern("queue")));
+
+        if (NIL_P(queue)) continue;
+        if (NIL_P(err)) err = rb_exc_new_cstr(eTclError, "interpreter was reset");
+        rb_funcall(queue, rb_intern("push"), 1, rb_ary_new3(2, Qnil, err));
+    }
+    rb_ary_clear(tip->thread_queue);
+}
+
+/* ---------------------------------------------------------
+ * Interp#snapshot - Record the state Interp#reset returns to
+ *
+ * Records commands and namespaces (recursively from ::), global
+ * variables, loaded packages, bindings on "." and "all" and registered
+ * callback IDs. Take it once
+ * the application's libraries are loaded; a later snapshot replaces it.
+ * Also starts watching "load" so reset can spare what it creates.
+ *
+ * Returns nil.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_snapshot(VALUE self)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    struct reset_snapshot *rs;
+    Tcl_Obj *state;
+    VALUE obj;
+
+    if (Tcl_EvalEx(tip->interp, load_watch_script, -1, TCL_EVAL_GLOBAL) != TCL_OK ||
+        Tcl_EvalEx(tip->interp, snapshot_script, -1, TCL_EVAL_GLOBAL) != TCL_OK) {
+        rb_raise(eTclError, "%s", Tcl_GetStringResult(tip->interp));
+    }
+    state = Tcl_GetObjResult(tip->interp);
+    Tcl_IncrRefCount(state);
+    Tcl_ResetResult(tip->interp);
+
+    rs = reset_snapshot_get(self);
+    if (!rs) {
+        obj = TypedData_Make_Struct(rb_cObject, struct reset_snapshot,
+                                    &reset_snapshot_type, rs);
+        rs->callback_ids = Qnil;
+        rb_ivar_set(self, id_reset_snapshot, obj);
+    }
+    if (rs->state) Tcl_DecrRefCount(rs->state);
+    rs->state = state;
+    rs->callback_ids = rb_hash_new();
+    rb_hash_foreach(tip->callbacks, collect_callback_id, rs->callback_ids);
+
+    return Qnil;
+}
+
+/* ---------------------------------------------------------
+ * Interp#reset - Return the interpreter to its snapshot
+ *
+ * In order:
+ *   - destroys every child of "." ("." itself stays)
+ *   - cancels pending "after" events
+ *   - restores the bindings on "." and "all"
+ *   - forgets packages loaded since the snapshot (they can be
+ *     required again), except those a shared library provided
+ *   - deletes namespaces and commands created since the snapshot,
+ *     except those created by loading a shared library
+ *   - removes traces from, then unsets, new global variables
+ *   - unregisters callbacks registered since the snapshot
+ *   - drops queued cross-thread requests; waiting threads get TclError
+ *   - clears the compiled-script caches
+ *
+ * Ruby-side hooks (TkCore re-runs init_ip_env/add_tk_procs) are the
+ * caller's business.
+ *
+ * Returns Hash of counts: {windows:, commands:, namespaces:,
+ * variables:, callbacks:}
+ *
+ * Raises TclError if no snapshot was taken.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_reset(VALUE self)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    struct reset_snapshot *rs = reset_snapshot_get(self);
+    Tcl_Obj *words[3], *cmd, **counts;
+    Tcl_Size n;
+    long callbacks;
+    VALUE result;
+    int rc;
+
+    if (!rs) {
+        rb_raise(eTclError, "no snapshot to reset to (call snapshot first)");
+    }
+
+    words[0] = Tcl_NewStringObj("apply", -1);
+    words[1] = Tcl_NewStringObj(reset_script, -1);
+    words[2] = rs->state;
+    cmd = Tcl_NewListObj(3, words);
+    Tcl_IncrRefCount(cmd);
+    rc = Tcl_EvalObjEx(tip->interp, cmd, TCL_EVAL_GLOBAL | TCL_EVAL_DIRECT);
+    Tcl_DecrRefCount(cmd);
+    if (rc != TCL_OK ||
+        Tcl_ListObjGetElements(tip->interp, Tcl_GetObjResult(tip->interp),
+                               &n, &counts) != TCL_OK || n != 4) {
+        rb_raise(eTclError, "reset failed: %s", Tcl_GetStringResult(tip->interp));
+    }
+
+    result = rb_hash_new();
+    {
+        static const char *const keys[] = {"windows", "commands", "namespaces", "variables"};
+        Tcl_Size i;
+        for (i = 0; i < 4; i++) {
+            long v = 0;
+            Tcl_GetLongFromObj(NULL, counts[i], &v);
+            rb_hash_aset(result, ID2SYM(rb_intern(keys[i])), LONG2NUM(v));
+        }
+    }
+    Tcl_ResetResult(tip->interp);
+
+    callbacks = RHASH_SIZE(tip->callbacks);
+    rb_hash_foreach(tip->callbacks, drop_new_callback, rs->callback_ids);
+    callbacks -= RHASH_SIZE(tip->callbacks);
+    rb_hash_aset(result, ID2SYM(rb_intern("callbacks")), LONG2NUM(callbacks));
+
+    reset_thread_queue(tip);
+    if (tip->script_cache) script_cache_clear(tip->script_cache);
+    if (tip->ruby_cache) script_cache_clear(tip->ruby_cache);
+
+    return result;
+}
+
+/* ---------------------------------------------------------
+ * Init_tkreset - Register snapshot/reset methods on TclTkIp class
+ *
+ * Called from Init_tcltklib in tcltkbridge.c
+ * --------------------------------------------------------- */
+
+void
+Init_tkreset(VALUE cTclTkIp)
+{
+    id_reset_snapshot = rb_intern("reset_snapshot");
+
+    rb_define_method(cTclTkIp, "snapshot", interp_snapshot, 0);
+    rb_define_method(cTclTkIp, "reset", interp_reset, 0);
+}
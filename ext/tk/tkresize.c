@@ -0,0 +1,389 @@
+/* tkresize.c - Coalesced <Configure> delivery for tk-ng
+ *
+ * Watches windows with C-level Tk event handlers instead of bind
+ * scripts. Each ConfigureNotify only records the latest size; Ruby is
+ * called once per changed window per idle pass (or after a quiet
+ * period), so intermediate resize events never reach Ruby.
+ */
+
+#include "tcltkbridge.h"
+#include <string.h>
+
+struct resize_group;
+
+/* One watched window */
+struct resize_watcher {
+    Tk_Window tkwin;            /* NULL once the window is destroyed */
+    char *path;
+    int width, height;          /* last delivered size, -1 = never */
+    int new_width, new_height;  /* latest seen size */
+    int dirty;
+    struct resize_group *group;
+};
+
+/* Windows sharing one callback and one debounce policy */
+struct resize_group {
+    Tcl_Interp *interp;
+    VALUE callback;
+    VALUE obj;                  /* wrapping Ruby object (not marked) */
+    VALUE ip;                   /* owning Interp (not marked) */
+    VALUE id;                   /* key in the Interp's registry */
+    int delay_ms;               /* 0 = next idle pass ("frame") */
+    int batch;                  /* deliver all changes in one call */
+    int pending;                /* idle handler or timer scheduled */
+    Tcl_TimerToken timer;
+    long count;
+    struct resize_watcher **watchers;
+};
+
+static ID id_resize_groups;
+static ID id_resize_next_id;
+static ID id_call;
+
+static void resize_event(ClientData clientData, XEvent *eventPtr);
+static void resize_flush(ClientData clientData);
+
+static void
+resize_group_mark(void *ptr)
+{
+    struct resize_group *g = ptr;
+    rb_gc_mark(g->callback);
+}
+
+static void
+resize_group_cancel(struct resize_group *g)
+{
+    if (!g->pending) return;
+    if (g->delay_ms > 0) {
+        Tcl_DeleteTimerHandler(g->timer);
+    } else {
+        Tcl_CancelIdleCall(resize_flush, (ClientData)g);
+    }
+    g->pending = 0;
+}
+
+/* Detach from Tk and free the watchers; the group stays allocated */
+static void
+resize_group_release(struct resize_group *g)
+{
+    long i;
+
+    resize_group_cancel(g);
+    for (i = 0; i < g->count; i++) {
+        struct resize_watcher *w = g->watchers[i];
+        if (w->tkwin) {
+            Tk_DeleteEventHandler(w->tkwin, StructureNotifyMask, resize_event,
+                                  (ClientData)w);
+        }
+        ckfree(w->path);
+        ckfree((char *)w);
+    }
+    if (g->watchers) ckfree((char *)g->watchers);
+    g->watchers = NULL;
+    g->count = 0;
+}
+
+static void
+resize_group_free(void *ptr)
+{
+    struct resize_group *g = ptr;
+    resize_group_release(g);
+    xfree(g);
+}
+
+static size_t
+resize_group_memsize(const void *ptr)
+{
+    const struct resize_group *g = ptr;
+    return sizeof(struct resize_group) +
+           (size_t)g->count * (sizeof(struct resize_watcher) + sizeof(void *));
+}
+
+static const rb_data_type_t resize_group_type = {
+    .wrap_struct_name = "TclTkBridge::ResizeGroup",
+    .function = {
+        .dmark = resize_group_mark,
+        .dfree = resize_group_free,
+        .dsize = resize_group_memsize,
+    },
+    .flags = RUBY_TYPED_FREE_IMMEDIATELY,
+};
+
+static VALUE
+resize_registry(VALUE self)
+{
+    VALUE reg = rb_ivar_get(self, id_resize_groups);
+    if (NIL_P(reg)) {
+        reg = rb_hash_new();
+        rb_ivar_set(self, id_resize_groups, reg);
+    }
+    return reg;
+}
+
+static void
+resize_schedule(struct resize_group *g)
+{
+    if (g->delay_ms > 0) {
+        /* Quiet period: every event pushes delivery back */
+        if (g->pending) Tcl_DeleteTimerHandler(g->timer);
+        g->timer = Tcl_CreateTimerHandler(g->delay_ms, resize_flush, (ClientData)g);
+        g->pending = 1;
+    } else if (!g->pending) {
+        Tcl_DoWhenIdle(resize_flush, (ClientData)g);
+        g->pending = 1;
+    }
+}
+
+/* Last window gone: release the group and drop it from the registry */
+static void
+resize_group_orphaned(struct resize_group *g)
+{
+    long i;
+
+    for (i = 0; i < g->count; i++) {
+        if (g->watchers[i]->tkwin) return;
+    }
+    resize_group_release(g);
+    rb_hash_delete(resize_registry(g->ip), g->id);
+}
+
+static void
+resize_event(ClientData clientData, XEvent *eventPtr)
+{
+    struct resize_watcher *w = (struct resize_watcher *)clientData;
+
+    if (eventPtr->type == DestroyNotify) {
+        /* Tk removes the handler itself; w may be freed below */
+        w->tkwin = NULL;
+        w->dirty = 0;
+        resize_group_orphaned(w->group);
+        return;
+    }
+    if (eventPtr->type != ConfigureNotify) return;
+
+    w->new_width = eventPtr->xconfigure.width;
+    w->new_height = eventPtr->xconfigure.height;
+    w->dirty = (w->new_width != w->width || w->new_height != w->height);
+    if (w->dirty) resize_schedule(w->group);
+}
+
+struct resize_call_args {
+    VALUE callback;
+    VALUE args;
+};
+
+static VALUE
+resize_call(VALUE varg)
+{
+    struct resize_call_args *a = (struct resize_call_args *)varg;
+    return rb_funcall2(a->callback, id_call, (int)RARRAY_LEN(a->args),
+                       RARRAY_CONST_PTR(a->args));
+}
+
+/* Run the callback; errors go to Tcl's background error handler */
+static int
+resize_invoke(struct resize_group *g, VALUE args)
+{
+    struct resize_call_args a;
+    int state;
+
+    a.callback = g->callback;
+    a.args = args;
+    rb_protect(resize_call, (VALUE)&a, &state);
+    if (state) {
+        VALUE errinfo = rb_errinfo();
+        VALUE msg;
+        rb_set_errinfo(Qnil);
+
+        if (rb_obj_is_kind_of(errinfo, rb_eSystemExit) ||
+            rb_obj_is_kind_of(errinfo, rb_eInterrupt)) {
+            rb_exc_raise(errinfo);
+        }
+        msg = rb_funcall(errinfo, rb_intern("message"), 0);
+        Tcl_SetObjResult(g->interp, Tcl_NewStringObj(StringValueCStr(msg), -1));
+        Tcl_BackgroundException(g->interp, TCL_ERROR);
+        return 0;
+    }
+    return 1;
+}
+
+static void
+resize_flush(ClientData clientData)
+{
+    struct resize_group *g = (struct resize_group *)clientData;
+    VALUE keep = g->obj;    /* an unwatch in the callback must not free g */
+    VALUE changes = Qnil;
+    long i;
+
+    g->pending = 0;
+    if (g->batch) changes = rb_ary_new();
+
+    for (i = 0; i < g->count; i++) {
+        struct resize_watcher *w = g->watchers[i];
+        VALUE path;
+
+        if (!w->dirty || w->tkwin == NULL) continue;
+        w->dirty = 0;
+        w->width = w->new_width;
+        w->height = w->new_height;
+        path = rb_utf8_str_new_cstr(w->path);
+        if (g->batch) {
+            rb_ary_push(changes, rb_ary_new_from_args(3, path,
+                        INT2NUM(w->width), INT2NUM(w->height)));
+        } else {
+            /* The callback may unwatch this group; stop if it did */
+            resize_invoke(g, rb_ary_new_from_args(3, path,
+                          INT2NUM(w->width), INT2NUM(w->height)));
+            if (g->count == 0) break;
+        }
+    }
+    if (g->batch && RARRAY_LEN(changes) > 0) {
+        resize_invoke(g, rb_ary_new_from_args(1, changes));
+    }
+    RB_GC_GUARD(keep);
+}
+
+/* ---------------------------------------------------------
+ * Interp#resize_watch(paths, callback, delay_ms, batch)
+ *
+ * Deliver coalesced size changes for a set of windows.
+ * A C-level StructureNotify handler records only the latest size of
+ * each window; no bind script runs and no Ruby code is called per event.
+ *
+ * Arguments:
+ *   paths    - Array of Tk window paths
+ *   callback - Object responding to #call
+ *   delay_ms - 0: deliver on the next idle pass (once per frame);
+ *              >0: deliver after delay_ms without further resizes
+ *   batch    - false: callback.call(path, width, height) per window;
+ *              true:  callback.call([[path, width, height], ...]) once
+ *
+ * Only windows whose size changed since the last delivery are reported.
+ * Destroyed windows drop out silently; when the last one is destroyed
+ * the watch ends as if resize_unwatch had been called.
+ *
+ * Returns an Integer watch id for resize_unwatch.
+ *
+ * See: https://www.tcl-lang.org/man/tcl8.6/TkLib/EventHndlr.htm
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_resize_watch(VALUE self, VALUE paths, VALUE callback, VALUE delay_ms,
+                    VALUE batch)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    struct resize_group *g;
+    Tk_Window mainWin;
+    Tk_Window *wins;
+    VALUE obj, reg, id;
+    long i, n;
+
+    Check_Type(paths, T_ARRAY);
+    if (!rb_respond_to(callback, id_call)) {
+        rb_raise(rb_eArgError, "resize callback must respond to #call");
+    }
+    if (NUM2INT(delay_ms) < 0) {
+        rb_raise(rb_eArgError, "delay must not be negative");
+    }
+    mainWin = Tk_MainWindow(tip->interp);
+    if (!mainWin) {
+        rb_raise(eTclError, "Tk not initialized (no main window)");
+    }
+
+    /* Resolve every path before touching Tk, so errors leave no handlers */
+    n = RARRAY_LEN(paths);
+    wins = ALLOCA_N(Tk_Window, n > 0 ? n : 1);
+    for (i = 0; i < n; i++) {
+        VALUE path = rb_ary_entry(paths, i);
+        if (!RB_TYPE_P(path, T_STRING)) path = rb_obj_as_string(path);
+        wins[i] = Tk_NameToWindow(tip->interp, StringValueCStr(path), mainWin);
+        if (!wins[i]) {
+            rb_raise(eTclError, "%s", Tcl_GetStringResult(tip->interp));
+        }
+    }
+
+    obj = TypedData_Make_Struct(rb_cObject, struct resize_group, &resize_group_type, g);
+    g->interp = tip->interp;
+    g->callback = callback;
+    g->obj = obj;
+    g->delay_ms = NUM2INT(delay_ms);
+    g->batch = RTEST(batch);
+    g->watchers = (struct resize_watcher **)ckalloc(sizeof(void *) * (size_t)(n > 0 ? n : 1));
+
+    for (i = 0; i < n; i++) {
+        struct resize_watcher *w = (struct resize_watcher *)ckalloc(sizeof(struct resize_watcher));
+        const char *path = Tk_PathName(wins[i]);
+
+        w->tkwin = wins[i];
+        w->path = ckalloc((unsigned)strlen(path) + 1);
+        strcpy(w->path, path);
+        w->width = w->height = -1;
+        w->new_width = w->new_height = -1;
+        w->dirty = 0;
+        w->group = g;
+        g->watchers[g->count++] = w;
+        Tk_CreateEventHandler(wins[i], StructureNotifyMask, resize_event, (ClientData)w);
+    }
+
+    reg = resize_registry(self);
+    id = rb_ivar_get(self, id_resize_next_id);
+    id = LONG2NUM(NIL_P(id) ? 1 : NUM2LONG(id) + 1);
+    rb_ivar_set(self, id_resize_next_id, id);
+    g->ip = self;
+    g->id = id;
+    rb_hash_aset(reg, id, obj);
+    return id;
+}
+
+/* ---------------------------------------------------------
+ * Interp#resize_unwatch(id)
+ *
+ * Stop a watch created by resize_watch. Pending deliveries are dropped.
+ * Returns true if the watch existed.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_resize_unwatch(VALUE self, VALUE id)
+{
+    struct resize_group *g;
+    VALUE obj;
+
+    get_interp(self);
+    obj = rb_hash_delete(resize_registry(self), id);
+    if (NIL_P(obj)) return Qfalse;
+
+    TypedData_Get_Struct(obj, struct resize_group, &resize_group_type, g);
+    resize_group_release(g);
+    return Qtrue;
+}
+
+/* ---------------------------------------------------------
+ * Interp#resize_watches
+ *
+ * Returns the ids of the active watches.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_resize_watches(VALUE self)
+{
+    get_interp(self);
+    return rb_funcall(resize_registry(self), rb_intern("keys"), 0);
+}
+
+/* ---------------------------------------------------------
+ * Init_tkresize - Register resize coalescing methods on TclTkIp class
+ *
+ * Called from Init_tcltklib in tcltkbridge.c
+ * --------------------------------------------------------- */
+
+void
+Init_tkresize(VALUE cTclTkIp)
+{
+    id_resize_groups = rb_intern("resize_groups");
+    id_resize_next_id = rb_intern("resize_next_id");
+    id_call = rb_intern("call");
+
+    rb_define_method(cTclTkIp, "resize_watch", interp_resize_watch, 4);
+    rb_define_method(cTclTkIp, "resize_unwatch", interp_resize_unwatch, 1);
+    rb_define_method(cTclTkIp, "resize_watches", interp_resize_watches, 0);
+}
@@ -0,0 +1,444 @@
+/* tksandbox.c - Resource-limited safe child interpreters for tk-ng
+ *
+ * Interp#create_sandbox makes a safe child (as create_slave does) and
+ * puts Tcl's resource limits on it: a command budget
+ * (Tcl_LimitSetCommands) and a wall-clock budget (Tcl_LimitSetTime).
+ * Budgets are per Interp#sandbox_eval call, so a runaway plugin script
+ * gets an error instead of spinning the UI thread. Host functionality
+ * is exposed only through the aliases given at creation (or added
+ * later with Interp#sandbox_expose).
+ *
+ * Tcl keeps no per-interpreter memory accounting, so there is no memory
+ * limit; the limit handler counts every time a budget runs out.
+ */
+
+#include "tcltkbridge.h"
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+struct sandbox {
+    Tcl_Interp *interp;
+    Tcl_Interp *parent;     /* target interpreter for String aliases */
+    long command_limit;     /* commands per eval, 0 = unlimited */
+    long time_limit_ms;     /* wall ms per eval, 0 = unlimited */
+    int granularity;        /* time limit checked every N commands */
+    VALUE procs;            /* Hash: alias name => callable (GC-marked) */
+    unsigned long evals;
+    unsigned long limit_hits;
+    unsigned long errors;
+    double cpu_time;        /* seconds of thread CPU inside sandbox_eval */
+    double wall_time;
+    long commands;          /* commands run inside sandbox_eval */
+    Tcl_ObjCmdProc *cmdcount_proc;  /* ::tcl::info::cmdcount, taken at creation */
+    ClientData cmdcount_data;
+};
+
+static ID id_sandbox;
+static ID id_call;
+static VALUE eLimitError;
+
+static void
+sandbox_mark(void *ptr)
+{
+    struct sandbox *sb = ptr;
+    rb_gc_mark(sb->procs);
+}
+
+static const rb_data_type_t sandbox_type = {
+    .wrap_struct_name = "TclTkBridge::Sandbox",
+    .function = {
+        .dmark = sandbox_mark,
+        .dfree = RUBY_TYPED_DEFAULT_FREE,
+        .dsize = NULL,
+    },
+    .flags = RUBY_TYPED_FREE_IMMEDIATELY,
+};
+
+static struct sandbox *
+sandbox_get(VALUE self)
+{
+    VALUE obj = rb_ivar_get(self, id_sandbox);
+    struct sandbox *sb;
+
+    if (NIL_P(obj)) {
+        rb_raise(eTclError, "interpreter is not a sandbox (use create_sandbox)");
+    }
+    TypedData_Get_Struct(obj, struct sandbox, &sandbox_type, sb);
+    return sb;
+}
+
+/* Seconds of CPU used by the calling thread */
+static double
+thread_cpu_seconds(void)
+{
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+#elif defined(_WIN32)
+    FILETIME created, exited, kernel, user;
+    ULARGE_INTEGER k, u;
+    GetThreadTimes(GetCurrentThread(), &created, &exited, &kernel, &user);
+    k.LowPart = kernel.dwLowDateTime; k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime; u.HighPart = user.dwHighDateTime;
+    return (k.QuadPart + u.QuadPart) / 1e7;
+#else
+    return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+static double
+wall_seconds(void)
+{
+    Tcl_Time t;
+    Tcl_GetTime(&t);
+    return t.sec + t.usec / 1e6;
+}
+
+/* Tcl_LimitHandlerProc: a budget ran out; Tcl unwinds the script */
+static void
+sandbox_limit_hit(ClientData clientData, Tcl_Interp *interp)
+{
+    ((struct sandbox *)clientData)->limit_hits++;
+}
+
+/*
+ * Commands executed so far by the child. The implementation of "info
+ * cmdcount" is called directly: the child can redefine info, or remap
+ * the ensemble, but not the function captured before it ran any code.
+ */
+static long
+sandbox_cmdcount(struct sandbox *sb)
+{
+    Tcl_Obj *word = Tcl_NewStringObj("cmdcount", -1);
+    long n = 0;
+
+    Tcl_IncrRefCount(word);
+    if (sb->cmdcount_proc(sb->cmdcount_data, sb->interp, 1, &word) == TCL_OK) {
+        Tcl_GetLongFromObj(NULL, Tcl_GetObjResult(sb->interp), &n);
+    }
+    Tcl_DecrRefCount(word);
+    Tcl_ResetResult(sb->interp);
+    return n;
+}
+
+/*
+ * Clear any exceeded state and arm fresh budgets. The command budget is
+ * re-armed after each eval too, so code the child runs from events
+ * (after, bind) between evals stays bounded. The time budget is only
+ * armed while an eval runs (timed): a deadline left over from the last
+ * eval would fail every later event handler in the child.
+ */
+static long
+sandbox_arm(struct sandbox *sb, int timed)
+{
+    long count;
+
+    Tcl_LimitTypeReset(sb->interp, TCL_LIMIT_COMMANDS);
+    Tcl_LimitTypeReset(sb->interp, TCL_LIMIT_TIME);
+    count = sandbox_cmdcount(sb);
+
+    if (sb->command_limit > 0) {
+        Tcl_LimitSetCommands(sb->interp, (int)(count + sb->command_limit));
+        Tcl_LimitTypeSet(sb->interp, TCL_LIMIT_COMMANDS);
+    }
+    if (timed && sb->time_limit_ms > 0) {
+        Tcl_Time deadline;
+        Tcl_GetTime(&deadline);
+        deadline.sec += sb->time_limit_ms / 1000;
+        deadline.usec += (sb->time_limit_ms % 1000) * 1000;
+        if (deadline.usec >= 1000000) {
+            deadline.sec++;
+            deadline.usec -= 1000000;
+        }
+        Tcl_LimitSetTime(sb->interp, &deadline);
+        Tcl_LimitSetGranularity(sb->interp, TCL_LIMIT_TIME, sb->granularity);
+        Tcl_LimitTypeSet(sb->interp, TCL_LIMIT_TIME);
+    }
+    return count;
+}
+
+/* ---------------------------------------------------------
+ * Host aliases backed by Ruby callables
+ * --------------------------------------------------------- */
+
+struct alias_call {
+    VALUE callable;
+    VALUE args;
+};
+
+static VALUE
+alias_invoke(VALUE varg)
+{
+    struct alias_call *ac = (struct alias_call *)varg;
+    return rb_funcallv(ac->callable, id_call, (int)RARRAY_LEN(ac->args),
+                       RARRAY_CONST_PTR(ac->args));
+}
+
+static int
+sandbox_alias_proc(ClientData clientData, Tcl_Interp *interp,
+                   RBTK_OBJC_TYPE objc, Tcl_Obj *const objv[])
+{
+    struct alias_call ac;
+    VALUE result;
+    int i, state;
+
+    ac.callable = (VALUE)clientData;
+    ac.args = rb_ary_new_capa(objc - 1);
+    for (i = 1; i < objc; i++) {
+        Tcl_Size len;
+        const char *s = Tcl_GetStringFromObj(objv[i], &len);
+        rb_ary_push(ac.args, rb_utf8_str_new(s, (long)len));
+    }
+
+    result = rb_protect(alias_invoke, (VALUE)&ac, &state);
+    if (state) {
+        VALUE errinfo = rb_errinfo();
+        VALUE msg;
+        rb_set_errinfo(Qnil);
+
+        if (rb_obj_is_kind_of(errinfo, rb_eSystemExit) ||
+            rb_obj_is_kind_of(errinfo, rb_eInterrupt)) {
+            rb_exc_raise(errinfo);
+        }
+        msg = rb_funcall(errinfo, rb_intern("message"), 0);
+        Tcl_SetObjResult(interp, Tcl_NewStringObj(RSTRING_PTR(msg),
+                                                  (RBTK_STRLEN_TYPE)RSTRING_LEN(msg)));
+        return TCL_ERROR;
+    }
+    if (!NIL_P(result)) {
+        VALUE str = rb_obj_as_string(result);
+        Tcl_SetObjResult(interp, Tcl_NewStringObj(RSTRING_PTR(str),
+                                                  (RBTK_STRLEN_TYPE)RSTRING_LEN(str)));
+    }
+    return TCL_OK;
+}
+
+/*
+ * Expose one host command: a String names a command in the parent
+ * (Tcl_CreateAlias), anything responding to #call is called with the
+ * string arguments.
+ */
+static void
+sandbox_expose(struct sandbox *sb, VALUE name, VALUE target)
+{
+    const char *cname;
+
+    name = rb_obj_as_string(name);
+    cname = StringValueCStr(name);
+
+    if (RB_TYPE_P(target, T_STRING)) {
+        if (Tcl_CreateAlias(sb->interp, cname, sb->parent, StringValueCStr(target),
+                            0, NULL) != TCL_OK) {
+            rb_raise(eTclError, "%s", Tcl_GetStringResult(sb->interp));
+        }
+        return;
+    }
+    if (!rb_respond_to(target, id_call)) {
+        rb_raise(rb_eArgError, "alias %s must be a command name or respond to #call", cname);
+    }
+    rb_hash_aset(sb->procs, name, target);
+    Tcl_CreateObjCommand(sb->interp, cname, sandbox_alias_proc, (ClientData)target, NULL);
+}
+
+static int
+expose_each(VALUE name, VALUE target, VALUE arg)
+{
+    sandbox_expose((struct sandbox *)arg, name, target);
+    return ST_CONTINUE;
+}
+
+static long
+limit_option(VALUE opts, const char *key)
+{
+    VALUE v = rb_hash_aref(opts, ID2SYM(rb_intern(key)));
+    long n;
+
+    if (NIL_P(v)) return 0;
+    n = NUM2LONG(v);
+    if (n < 0) rb_raise(rb_eArgError, "%s must be >= 0 (got %ld)", key, n);
+    return n;
+}
+
+/* ---------------------------------------------------------
+ * Interp#create_sandbox(name, opts = {}) - Safe child with limits
+ *
+ * Arguments:
+ *   name - Child interpreter name
+ *   opts - Options hash
+ *
+ * Options:
+ *   :commands    - Commands allowed per sandbox_eval (default 0 = no limit)
+ *   :time_ms     - Wall-clock ms allowed per sandbox_eval (default 0)
+ *   :granularity - Check the time limit every N commands (default 10)
+ *   :aliases     - Hash name => target exposed in the child. A String
+ *                  target names a command in this interpreter; a
+ *                  callable receives the arguments as Strings and its
+ *                  result (to_s) becomes the command result.
+ *
+ * The child is always a safe interpreter. Returns the child TclTkIp.
+ *
+ * See: https://www.tcl-lang.org/man/tcl8.6/TclLib/Limit.htm
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_create_sandbox(int argc, VALUE *argv, VALUE self)
+{
+    struct tcltk_interp *parent = get_interp(self);
+    struct tcltk_interp *child;
+    struct sandbox *sb;
+    Tcl_CmdInfo info;
+    VALUE name, opts, obj, child_ip, aliases;
+
+    rb_scan_args(argc, argv, "11", &name, &opts);
+    if (NIL_P(opts)) opts = rb_hash_new();
+    Check_Type(opts, T_HASH);
+
+    child_ip = rb_funcall(self, rb_intern("create_slave"), 2, name, Qtrue);
+    child = get_interp(child_ip);
+    if (!Tcl_GetCommandInfo(child->interp, "::tcl::info::cmdcount", &info) || !info.objProc) {
+        rb_funcall(child_ip, rb_intern("delete"), 0);
+        rb_raise(eTclError, "sandbox: ::tcl::info::cmdcount not available");
+    }
+
+    obj = TypedData_Make_Struct(rb_cObject, struct sandbox, &sandbox_type, sb);
+    sb->interp = child->interp;
+    sb->parent = parent->interp;
+    sb->cmdcount_proc = info.objProc;
+    sb->cmdcount_data = info.objClientData;
+    sb->procs = rb_hash_new();
+    sb->command_limit = limit_option(opts, "commands");
+    sb->time_limit_ms = limit_option(opts, "time_ms");
+    sb->granularity = (int)limit_option(opts, "granularity");
+    if (sb->granularity == 0) sb->granularity = 10;
+    rb_ivar_set(child_ip, id_sandbox, obj);
+
+    Tcl_LimitAddHandler(sb->interp, TCL_LIMIT_COMMANDS, sandbox_limit_hit, (ClientData)sb, NULL);
+    Tcl_LimitAddHandler(sb->interp, TCL_LIMIT_TIME, sandbox_limit_hit, (ClientData)sb, NULL);
+
+    aliases = rb_hash_aref(opts, ID2SYM(rb_intern("aliases")));
+    if (!NIL_P(aliases)) {
+        Check_Type(aliases, T_HASH);
+        rb_hash_foreach(aliases, expose_each, (VALUE)sb);
+    }
+
+    /* Budget event-driven code from the start */
+    sandbox_arm(sb, 0);
+    return child_ip;
+}
+
+/* ---------------------------------------------------------
+ * Interp#sandbox_eval(script) - Evaluate within the sandbox limits
+ *
+ * Arms fresh command/time budgets, evaluates script in the child and
+ * records CPU time, wall time and commands used.
+ *
+ * Returns the result String.
+ * Raises TclTkLib::LimitError when a budget ran out, TclError for
+ * other script errors.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_sandbox_eval(VALUE self, VALUE script)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    struct sandbox *sb = sandbox_get(self);
+    double cpu0, wall0;
+    long count0;
+    int rc, exceeded;
+    VALUE result;
+
+    StringValue(script);
+    count0 = sandbox_arm(sb, 1);
+    cpu0 = thread_cpu_seconds();
+    wall0 = wall_seconds();
+
+    rc = Tcl_EvalEx(tip->interp, RSTRING_PTR(script),
+                    (RBTK_STRLEN_TYPE)RSTRING_LEN(script), TCL_EVAL_GLOBAL);
+
+    sb->cpu_time += thread_cpu_seconds() - cpu0;
+    sb->wall_time += wall_seconds() - wall0;
+    sb->evals++;
+    exceeded = Tcl_LimitExceeded(tip->interp);
+    result = rb_utf8_str_new_cstr(Tcl_GetStringResult(tip->interp));
+
+    /* Re-arm without the deadline (clears the exceeded state) and
+     * measure from the new count */
+    sb->commands += sandbox_arm(sb, 0) - count0;
+
+    if (rc != TCL_OK) {
+        sb->errors++;
+        rb_exc_raise(rb_exc_new_str(exceeded ? eLimitError : eTclError, result));
+    }
+    return result;
+}
+
+/* ---------------------------------------------------------
+ * Interp#sandbox_expose(name, target) - Add a host alias later
+ *
+ * Same targets as create_sandbox's :aliases.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_sandbox_expose(VALUE self, VALUE name, VALUE target)
+{
+    get_interp(self);
+    sandbox_expose(sandbox_get(self), name, target);
+    return Qnil;
+}
+
+/* ---------------------------------------------------------
+ * Interp#sandbox_stats - Usage counters for a sandbox
+ *
+ * Returns Hash:
+ *   :evals      - sandbox_eval calls
+ *   :errors     - evals that raised
+ *   :limit_hits - times a command or time budget ran out
+ *   :commands   - commands run inside sandbox_eval
+ *   :cpu_time   - thread CPU seconds inside sandbox_eval
+ *   :wall_time  - wall seconds inside sandbox_eval
+ *   :limits     - {commands:, time_ms:}
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_sandbox_stats(VALUE self)
+{
+    struct sandbox *sb = sandbox_get(self);
+    VALUE h = rb_hash_new();
+    VALUE limits = rb_hash_new();
+
+    rb_hash_aset(h, ID2SYM(rb_intern("evals")), ULONG2NUM(sb->evals));
+    rb_hash_aset(h, ID2SYM(rb_intern("errors")), ULONG2NUM(sb->errors));
+    rb_hash_aset(h, ID2SYM(rb_intern("limit_hits")), ULONG2NUM(sb->limit_hits));
+    rb_hash_aset(h, ID2SYM(rb_intern("commands")), LONG2NUM(sb->commands));
+    rb_hash_aset(h, ID2SYM(rb_intern("cpu_time")), DBL2NUM(sb->cpu_time));
+    rb_hash_aset(h, ID2SYM(rb_intern("wall_time")), DBL2NUM(sb->wall_time));
+    rb_hash_aset(limits, ID2SYM(rb_intern("commands")), LONG2NUM(sb->command_limit));
+    rb_hash_aset(limits, ID2SYM(rb_intern("time_ms")), LONG2NUM(sb->time_limit_ms));
+    rb_hash_aset(h, ID2SYM(rb_intern("limits")), limits);
+    return h;
+}
+
+/* ---------------------------------------------------------
+ * Init_tksandbox - Register sandbox methods on TclTkIp class
+ *
+ * Called from Init_tcltklib in tcltkbridge.c
+ * --------------------------------------------------------- */
+
+void
+Init_tksandbox(VALUE cTclTkIp)
+{
+    id_sandbox = rb_intern("sandbox");
+    id_call = rb_intern("call");
+
+    /* Raised when a sandbox command or time budget runs out */
+    eLimitError = rb_define_class_under(rb_define_module("TclTkLib"), "LimitError", eTclError);
+
+    rb_define_method(cTclTkIp, "create_sandbox", interp_create_sandbox, -1);
+    rb_define_method(cTclTkIp, "sandbox_eval", interp_sandbox_eval, 1);
+    rb_define_method(cTclTkIp, "sandbox_expose", interp_sandbox_expose, 2);
+    rb_define_method(cTclTkIp, "sandbox_stats", interp_sandbox_stats, 0);
+}
@@ -0,0 +1,468 @@
+/* tkscriptcache.c - Compiled-code caches for tcl_eval and the ruby command
+ *
+ * Tcl_Eval(interp, cstr) compiles the script from scratch on every call
+ * because no Tcl_Obj survives to hold the bytecode. The script cache
+ * keeps one refcounted Tcl_Obj per script and evaluates it with
+ * Tcl_EvalObjEx, so repeated scripts reuse Tcl's compiled bytecode.
+ * Frozen Ruby Strings are looked up by identity (the String is kept
+ * alive by the cache); other Strings by content, and only once the same
+ * content has been evaluated twice, so one-shot interpolated scripts
+ * are neither compiled nor pinned. Scripts above SCRIPT_CACHE_MAX_BYTES
+ * are never cached. Uncached scripts are evaluated directly, as
+ * Tcl_Eval does, without building bytecode.
+ *
+ * The other direction works the same way: the Tcl "ruby" / "ruby_eval"
+ * commands used rb_eval_string, reparsing the Ruby source on every call.
+ * The Ruby code cache keeps a compiled RubyVM::InstructionSequence per
+ * source, looked up by Tcl_Obj identity (a literal in a compiled Tcl
+ * proc is the same object every call) and then by content.
+ *
+ * Both caches are bounded with LRU eviction.
+ */
+
+#include "tcltkbridge.h"
+#include <string.h>
+
+#define SCRIPT_CACHE_DEFAULT_SIZE 256
+#define SCRIPT_CACHE_MAX_BYTES 16384
+#define SCRIPT_SEEN_MIN 64          /* seen table is cleared past max(this, 2 * capacity) */
+
+struct script_entry {
+    Tcl_Obj *obj;               /* script cache: compiled script;
+                                 * code cache: last Tcl_Obj seen with this source */
+    VALUE key;                  /* frozen String (identity table), else Qnil */
+    VALUE iseq;                 /* code cache: compiled InstructionSequence */
+    Tcl_HashEntry *hentry;
+    Tcl_HashEntry *ident;       /* code cache: by_identity entry for obj */
+    struct script_entry *prev, *next;   /* LRU list, head = most recent */
+};
+
+struct script_cache {
+    Tcl_HashTable by_identity;  /* VALUE or Tcl_Obj * -> entry */
+    Tcl_HashTable by_content;   /* script text -> entry */
+    Tcl_HashTable seen;         /* script cache: content hash of scripts run once */
+    long nseen;
+    struct script_entry *head, *tail;
+    long count, capacity;
+    unsigned long hits, misses, evictions, direct;
+};
+
+static VALUE cISeq;
+static ID id_compile;
+static ID id_eval;
+
+struct script_cache *
+script_cache_new(void)
+{
+    struct script_cache *sc = (struct script_cache *)ckalloc(sizeof(struct script_cache));
+    memset(sc, 0, sizeof(struct script_cache));
+    Tcl_InitHashTable(&sc->by_identity, TCL_ONE_WORD_KEYS);
+    Tcl_InitHashTable(&sc->by_content, TCL_STRING_KEYS);
+    Tcl_InitHashTable(&sc->seen, TCL_ONE_WORD_KEYS);
+    sc->capacity = SCRIPT_CACHE_DEFAULT_SIZE;
+    return sc;
+}
+
+static void
+lru_unlink(struct script_cache *sc, struct script_entry *e)
+{
+    if (e->prev) e->prev->next = e->next; else sc->head = e->next;
+    if (e->next) e->next->prev = e->prev; else sc->tail = e->prev;
+    e->prev = e->next = NULL;
+}
+
+static void
+lru_push_front(struct script_cache *sc, struct script_entry *e)
+{
+    e->prev = NULL;
+    e->next = sc->head;
+    if (sc->head) sc->head->prev = e;
+    sc->head = e;
+    if (!sc->tail) sc->tail = e;
+}
+
+static void
+lru_touch(struct script_cache *sc, struct script_entry *e)
+{
+    sc->hits++;
+    if (e != sc->head) {
+        lru_unlink(sc, e);
+        lru_push_front(sc, e);
+    }
+}
+
+static void
+entry_drop(struct script_cache *sc, struct script_entry *e)
+{
+    lru_unlink(sc, e);
+    Tcl_DeleteHashEntry(e->hentry);
+    if (e->ident) Tcl_DeleteHashEntry(e->ident);
+    /* Safe while the code runs: the evaluator holds its own reference */
+    if (e->obj) Tcl_DecrRefCount(e->obj);
+    ckfree((char *)e);
+    sc->count--;
+}
+
+static void
+seen_clear(struct script_cache *sc)
+{
+    Tcl_DeleteHashTable(&sc->seen);
+    Tcl_InitHashTable(&sc->seen, TCL_ONE_WORD_KEYS);
+    sc->nseen = 0;
+}
+
+void
+script_cache_clear(struct script_cache *sc)
+{
+    while (sc->head) entry_drop(sc, sc->head);
+    seen_clear(sc);
+}
+
+void
+script_cache_free(struct script_cache *sc)
+{
+    if (!sc) return;
+    script_cache_clear(sc);
+    Tcl_DeleteHashTable(&sc->by_identity);
+    Tcl_DeleteHashTable(&sc->by_content);
+    Tcl_DeleteHashTable(&sc->seen);
+    ckfree((char *)sc);
+}
+
+/* Keep identity keys alive: a recycled address must not hit a stale entry */
+void
+script_cache_mark(struct script_cache *sc)
+{
+    struct script_entry *e;
+    if (!sc) return;
+    for (e = sc->head; e; e = e->next) {
+        if (!NIL_P(e->key)) rb_gc_mark(e->key);
+        if (!NIL_P(e->iseq)) rb_gc_mark(e->iseq);
+    }
+}
+
+static void
+evict_to(struct script_cache *sc, long limit)
+{
+    while (sc->count > limit && sc->tail) {
+        entry_drop(sc, sc->tail);
+        sc->evictions++;
+    }
+}
+
+static struct script_entry *
+entry_new(struct script_cache *sc, Tcl_HashEntry *hentry)
+{
+    struct script_entry *e = (struct script_entry *)ckalloc(sizeof(struct script_entry));
+    e->obj = NULL;
+    e->key = Qnil;
+    e->iseq = Qnil;
+    e->hentry = hentry;
+    e->ident = NULL;
+    Tcl_SetHashValue(hentry, e);
+    lru_push_front(sc, e);
+    sc->count++;
+    return e;
+}
+
+/* First sighting of a non-frozen script's content? Records it if so. */
+static int
+script_seen_first(struct script_cache *sc, VALUE script)
+{
+    Tcl_HashEntry *hentry;
+    long limit = sc->capacity * 2 > SCRIPT_SEEN_MIN ? sc->capacity * 2 : SCRIPT_SEEN_MIN;
+    /* A hash collision only caches a script one run early */
+    char *key = (char *)(uintptr_t)rb_str_hash(script);
+    int isNew;
+
+    if (sc->nseen >= limit) seen_clear(sc);
+    hentry = Tcl_CreateHashEntry(&sc->seen, key, &isNew);
+    if (isNew) {
+        sc->nseen++;
+        return 1;
+    }
+    Tcl_DeleteHashEntry(hentry);
+    sc->nseen--;
+    return 0;
+}
+
+/* Cached Tcl_Obj for script, creating (and possibly evicting) on a miss.
+ * NULL if the script should not be cached. */
+static Tcl_Obj *
+script_cache_lookup(struct script_cache *sc, VALUE script)
+{
+    struct script_entry *e;
+    Tcl_HashEntry *hentry;
+    int frozen = OBJ_FROZEN(script);
+    int isNew;
+
+    if (frozen) {
+        hentry = Tcl_FindHashEntry(&sc->by_identity, (char *)script);
+    } else {
+        hentry = Tcl_FindHashEntry(&sc->by_content, RSTRING_PTR(script));
+    }
+    if (hentry) {
+        e = (struct script_entry *)Tcl_GetHashValue(hentry);
+        lru_touch(sc, e);
+        return e->obj;
+    }
+
+    if (RSTRING_LEN(script) > SCRIPT_CACHE_MAX_BYTES) return NULL;
+    if (!frozen && script_seen_first(sc, script)) return NULL;
+
+    if (frozen) {
+        hentry = Tcl_CreateHashEntry(&sc->by_identity, (char *)script, &isNew);
+    } else {
+        hentry = Tcl_CreateHashEntry(&sc->by_content, RSTRING_PTR(script), &isNew);
+    }
+    sc->misses++;
+    e = entry_new(sc, hentry);
+    e->obj = Tcl_NewStringObj(RSTRING_PTR(script), (RBTK_STRLEN_TYPE)RSTRING_LEN(script));
+    Tcl_IncrRefCount(e->obj);
+    e->key = frozen ? script : Qnil;
+    evict_to(sc, sc->capacity);
+    return e->obj;
+}
+
+/*
+ * Evaluate script through the cache. Same contract as Tcl_Eval: returns
+ * the Tcl completion code with the result left in the interp.
+ */
+int
+script_cache_eval(struct tcltk_interp *tip, VALUE script)
+{
+    struct script_cache *sc = tip->script_cache;
+    Tcl_Obj *obj;
+    int result;
+
+    StringValueCStr(script);    /* reject embedded NULs like Tcl_Eval did */
+    if (sc == NULL || sc->capacity == 0) {
+        return Tcl_Eval(tip->interp, RSTRING_PTR(script));
+    }
+
+    obj = script_cache_lookup(sc, script);
+    if (obj == NULL) {
+        /* Evaluated directly: no bytecode is built for a one-shot script */
+        sc->direct++;
+        return Tcl_EvalEx(tip->interp, RSTRING_PTR(script),
+                          (RBTK_STRLEN_TYPE)RSTRING_LEN(script), 0);
+    }
+    Tcl_IncrRefCount(obj);
+    result = Tcl_EvalObjEx(tip->interp, obj, 0);
+    Tcl_DecrRefCount(obj);
+    return result;
+}
+
+/* Point the identity table at code, the Tcl_Obj most recently seen */
+static void
+code_entry_bind(struct script_cache *sc, struct script_entry *e, Tcl_Obj *code)
+{
+    int isNew;
+
+    if (e->ident) {
+        Tcl_DeleteHashEntry(e->ident);
+        Tcl_DecrRefCount(e->obj);
+    }
+    /* Holding a reference makes code shared, so Tcl never edits it in place */
+    Tcl_IncrRefCount(code);
+    e->obj = code;
+    e->ident = Tcl_CreateHashEntry(&sc->by_identity, (char *)code, &isNew);
+    Tcl_SetHashValue(e->ident, e);
+}
+
+/* Compiled InstructionSequence for code; may raise SyntaxError on a miss */
+static VALUE
+code_cache_lookup(struct script_cache *sc, Tcl_Obj *code)
+{
+    struct script_entry *e;
+    Tcl_HashEntry *hentry;
+    const char *src;
+    VALUE iseq;
+    int isNew;
+
+    hentry = Tcl_FindHashEntry(&sc->by_identity, (char *)code);
+    if (hentry) {
+        e = (struct script_entry *)Tcl_GetHashValue(hentry);
+        lru_touch(sc, e);
+        return e->iseq;
+    }
+
+    src = Tcl_GetString(code);
+    hentry = Tcl_FindHashEntry(&sc->by_content, src);
+    if (hentry) {
+        e = (struct script_entry *)Tcl_GetHashValue(hentry);
+        lru_touch(sc, e);
+        code_entry_bind(sc, e, code);
+        return e->iseq;
+    }
+
+    /* Compile before touching the tables so a SyntaxError leaves no entry */
+    sc->misses++;
+    iseq = rb_funcall(cISeq, id_compile, 1, rb_utf8_str_new_cstr(src));
+
+    hentry = Tcl_CreateHashEntry(&sc->by_content, src, &isNew);
+    e = entry_new(sc, hentry);
+    e->iseq = iseq;
+    code_entry_bind(sc, e, code);
+    evict_to(sc, sc->capacity);
+    return iseq;
+}
+
+/*
+ * Evaluate the Ruby source in code at top level, as rb_eval_string does,
+ * reusing the compiled InstructionSequence. Raises on error; callers wrap
+ * it in rb_protect.
+ */
+VALUE
+ruby_code_cache_eval(struct tcltk_interp *tip, Tcl_Obj *code)
+{
+    struct script_cache *sc = tip->ruby_cache;
+    VALUE iseq;
+
+    if (sc == NULL || sc->capacity == 0) {
+        return rb_eval_string(Tcl_GetString(code));
+    }
+    /* iseq stays on the stack: nested ruby calls may evict its entry */
+    iseq = code_cache_lookup(sc, code);
+    return rb_funcall(iseq, id_eval, 0);
+}
+
+static struct script_cache *
+cache_get(struct script_cache *sc)
+{
+    if (sc == NULL) {
+        rb_raise(eTclError, "interpreter not initialized");
+    }
+    return sc;
+}
+
+static VALUE
+cache_stats(struct script_cache *sc)
+{
+    unsigned long lookups = sc->hits + sc->misses;
+    VALUE h = rb_hash_new();
+
+    rb_hash_aset(h, ID2SYM(rb_intern("size")), LONG2NUM(sc->count));
+    rb_hash_aset(h, ID2SYM(rb_intern("capacity")), LONG2NUM(sc->capacity));
+    rb_hash_aset(h, ID2SYM(rb_intern("hits")), ULONG2NUM(sc->hits));
+    rb_hash_aset(h, ID2SYM(rb_intern("misses")), ULONG2NUM(sc->misses));
+    rb_hash_aset(h, ID2SYM(rb_intern("evictions")), ULONG2NUM(sc->evictions));
+    rb_hash_aset(h, ID2SYM(rb_intern("direct")), ULONG2NUM(sc->direct));
+    rb_hash_aset(h, ID2SYM(rb_intern("hit_rate")),
+                 DBL2NUM(lookups ? (double)sc->hits / (double)lookups : 0.0));
+    return h;
+}
+
+static VALUE
+cache_set_size(struct script_cache *sc, VALUE size)
+{
+    long n = NUM2LONG(size);
+
+    if (n < 0) {
+        rb_raise(rb_eArgError, "cache size must not be negative");
+    }
+    sc->capacity = n;
+    evict_to(sc, n);
+    return size;
+}
+
+static VALUE
+cache_reset(struct script_cache *sc)
+{
+    script_cache_clear(sc);
+    sc->hits = sc->misses = sc->evictions = sc->direct = 0;
+    return Qnil;
+}
+
+/* ---------------------------------------------------------
+ * Interp#script_cache_stats - Script cache counters
+ *
+ * Returns Hash {size:, capacity:, hits:, misses:, evictions:, direct:,
+ * hit_rate:}; direct counts scripts evaluated without caching (first
+ * run of a non-frozen script, or too large).
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_script_cache_stats(VALUE self)
+{
+    return cache_stats(cache_get(get_interp(self)->script_cache));
+}
+
+/* ---------------------------------------------------------
+ * Interp#script_cache_size=(n) - Set the maximum number of cached scripts
+ *
+ * 0 disables caching (plain Tcl_Eval). Shrinking evicts LRU entries.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_set_script_cache_size(VALUE self, VALUE size)
+{
+    return cache_set_size(cache_get(get_interp(self)->script_cache), size);
+}
+
+/* ---------------------------------------------------------
+ * Interp#script_cache_clear - Drop all cached scripts and reset counters
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_script_cache_clear(VALUE self)
+{
+    return cache_reset(cache_get(get_interp(self)->script_cache));
+}
+
+/* ---------------------------------------------------------
+ * Interp#ruby_eval_cache_stats - Counters for the ruby/ruby_eval commands
+ *
+ * Returns Hash {size:, capacity:, hits:, misses:, evictions:, direct:,
+ * hit_rate:} (direct is always 0 here)
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_ruby_eval_cache_stats(VALUE self)
+{
+    return cache_stats(cache_get(get_interp(self)->ruby_cache));
+}
+
+/* ---------------------------------------------------------
+ * Interp#ruby_eval_cache_size=(n) - Set the maximum number of compiled
+ * Ruby sources kept for the ruby/ruby_eval commands
+ *
+ * 0 disables caching (plain rb_eval_string). Shrinking evicts LRU entries.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_set_ruby_eval_cache_size(VALUE self, VALUE size)
+{
+    return cache_set_size(cache_get(get_interp(self)->ruby_cache), size);
+}
+
+/* ---------------------------------------------------------
+ * Interp#ruby_eval_cache_clear - Drop compiled Ruby sources, reset counters
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_ruby_eval_cache_clear(VALUE self)
+{
+    return cache_reset(cache_get(get_interp(self)->ruby_cache));
+}
+
+/* ---------------------------------------------------------
+ * Init_tkscriptcache - Register script cache methods on TclTkIp class
+ *
+ * Called from Init_tcltklib in tcltkbridge.c
+ * --------------------------------------------------------- */
+
+void
+Init_tkscriptcache(VALUE cTclTkIp)
+{
+    cISeq = rb_path2class("RubyVM::InstructionSequence");
+    id_compile = rb_intern("compile");
+    id_eval = rb_intern("eval");
+
+    rb_define_method(cTclTkIp, "script_cache_stats", interp_script_cache_stats, 0);
+    rb_define_method(cTclTkIp, "script_cache_size=", interp_set_script_cache_size, 1);
+    rb_define_method(cTclTkIp, "script_cache_clear", interp_script_cache_clear, 0);
+    rb_define_method(cTclTkIp, "ruby_eval_cache_stats", interp_ruby_eval_cache_stats, 0);
+    rb_define_method(cTclTkIp, "ruby_eval_cache_size=", interp_set_ruby_eval_cache_size, 1);
+    rb_define_method(cTclTkIp, "ruby_eval_cache_clear", interp_ruby_eval_cache_clear, 0);
+}
@@ -0,0 +1,778 @@
+/* tkscroll.c - Native scrollbar linkage for tk-ng
+ *
+ * Interp#scroll_link wires a scrollable widget and a scrollbar to each
+ * other with Tcl command prefixes ("$bar set", "$widget yview"), so
+ * scrolling and dragging never leave Tcl. An optional observer command
+ * is told the visible fraction at most once per idle pass ("frame"): a
+ * small C command sits in -yscrollcommand, forwards every update to the
+ * scrollbar and only records the latest fractions for the observer.
+ *
+ * The observer is a Tcl command prefix (typically an rb_out command
+ * from install_cmd), so its lifetime stays with the widget's callback
+ * table; this file holds no Ruby objects.
+ */
+
+#include "tcltkbridge.h"
+#include <math.h>
+#include <string.h>
+
+/* Observed link: the -{x,y}scrollcommand of one widget */
+struct scroll_link {
+    Tcl_Interp *interp;
+    Tcl_Command token;
+    Tk_Window tkwin;        /* scrolled widget, NULL once destroyed */
+    Tcl_Obj *bar;           /* scrollbar path, or NULL */
+    Tcl_Obj *notify;        /* observer command prefix */
+    Tcl_Obj *first, *last;  /* latest fractions, not yet delivered */
+    int pending;            /* idle notify scheduled */
+};
+
+static Tcl_Obj *
+rstring_obj(VALUE str)
+{
+    StringValue(str);
+    return Tcl_NewStringObj(RSTRING_PTR(str), (RBTK_STRLEN_TYPE)RSTRING_LEN(str));
+}
+
+static char
+scroll_axis(VALUE axis)
+{
+    const char *s;
+
+    if (SYMBOL_P(axis)) axis = rb_sym2str(axis);
+    s = StringValueCStr(axis);
+    if ((s[0] != 'x' && s[0] != 'y') || s[1] != '\0') {
+        rb_raise(rb_eArgError, "axis must be :x or :y (got %s)", s);
+    }
+    return s[0];
+}
+
+/* Run objv (objects may be fresh; they are released afterwards) */
+static int
+scroll_evalv(Tcl_Interp *interp, int objc, Tcl_Obj **objv)
+{
+    int i, rc;
+
+    for (i = 0; i < objc; i++) Tcl_IncrRefCount(objv[i]);
+    rc = Tcl_EvalObjv(interp, objc, objv, TCL_EVAL_GLOBAL);
+    for (i = 0; i < objc; i++) Tcl_DecrRefCount(objv[i]);
+    return rc;
+}
+
+/* $path configure -option value */
+static int
+scroll_try_configure(Tcl_Interp *interp, Tcl_Obj *path, const char *option, Tcl_Obj *value)
+{
+    Tcl_Obj *objv[4];
+
+    objv[0] = path;
+    objv[1] = Tcl_NewStringObj("configure", -1);
+    objv[2] = Tcl_NewStringObj(option, -1);
+    objv[3] = value;
+    return scroll_evalv(interp, 4, objv);
+}
+
+/* Same, raising TclError on failure */
+static void
+scroll_configure(Tcl_Interp *interp, Tcl_Obj *path, const char *option, Tcl_Obj *value)
+{
+    if (scroll_try_configure(interp, path, option, value) != TCL_OK) {
+        rb_raise(eTclError, "%s", Tcl_GetStringResult(interp));
+    }
+    Tcl_ResetResult(interp);
+}
+
+/* Call an observer prefix with two more words; errors go to bgerror */
+static void
+scroll_observe(Tcl_Interp *interp, Tcl_Obj *notify, Tcl_Obj *first, Tcl_Obj *last)
+{
+    Tcl_Obj *cmd = Tcl_DuplicateObj(notify);
+
+    Tcl_IncrRefCount(cmd);
+    Tcl_ListObjAppendElement(NULL, cmd, first);
+    Tcl_ListObjAppendElement(NULL, cmd, last);
+    if (Tcl_EvalObjEx(interp, cmd, TCL_EVAL_GLOBAL) != TCL_OK) {
+        Tcl_BackgroundException(interp, TCL_ERROR);
+    }
+    Tcl_DecrRefCount(cmd);
+}
+
+static void
+scroll_notify(ClientData clientData)
+{
+    struct scroll_link *link = (struct scroll_link *)clientData;
+
+    link->pending = 0;
+    scroll_observe(link->interp, link->notify, link->first, link->last);
+}
+
+/* -{x,y}scrollcommand: forward to the scrollbar, remember for observer */
+static int
+scroll_link_cmd(ClientData clientData, Tcl_Interp *interp,
+                RBTK_OBJC_TYPE objc, Tcl_Obj *const objv[])
+{
+    struct scroll_link *link = (struct scroll_link *)clientData;
+
+    if (objc != 3) {
+        Tcl_WrongNumArgs(interp, 1, objv, "first last");
+        return TCL_ERROR;
+    }
+    if (link->bar) {
+        Tcl_Obj *set[4];
+        int rc;
+
+        set[0] = link->bar;
+        set[1] = Tcl_NewStringObj("set", 3);
+        set[2] = objv[1];
+        set[3] = objv[2];
+        rc = scroll_evalv(interp, 4, set);
+        if (rc != TCL_OK) return rc;
+    }
+
+    Tcl_IncrRefCount(objv[1]);
+    Tcl_IncrRefCount(objv[2]);
+    if (link->first) Tcl_DecrRefCount(link->first);
+    if (link->last) Tcl_DecrRefCount(link->last);
+    link->first = objv[1];
+    link->last = objv[2];
+    if (!link->pending) {
+        Tcl_DoWhenIdle(scroll_notify, (ClientData)link);
+        link->pending = 1;
+    }
+    return TCL_OK;
+}
+
+static void
+scroll_link_destroyed(ClientData clientData, XEvent *eventPtr)
+{
+    struct scroll_link *link = (struct scroll_link *)clientData;
+
+    if (eventPtr->type != DestroyNotify) return;
+    link->tkwin = NULL;
+    Tcl_DeleteCommandFromToken(link->interp, link->token);
+}
+
+static void
+scroll_link_delete(ClientData clientData)
+{
+    struct scroll_link *link = (struct scroll_link *)clientData;
+
+    if (link->pending) Tcl_CancelIdleCall(scroll_notify, (ClientData)link);
+    if (link->tkwin) {
+        Tk_DeleteEventHandler(link->tkwin, StructureNotifyMask,
+                              scroll_link_destroyed, (ClientData)link);
+    }
+    if (link->bar) Tcl_DecrRefCount(link->bar);
+    Tcl_DecrRefCount(link->notify);
+    if (link->first) Tcl_DecrRefCount(link->first);
+    if (link->last) Tcl_DecrRefCount(link->last);
+    ckfree((char *)link);
+}
+
+/* ---------------------------------------------------------
+ * Interp#scroll_link(widget, scrollbar, axis, observer=nil)
+ *
+ * Link a widget and a scrollbar along axis (:x or :y) in Tcl:
+ *   widget -{x,y}scrollcommand  -> "scrollbar set"
+ *   scrollbar -command          -> "widget {x,y}view"
+ *
+ * observer is a Tcl command prefix called with the first and last
+ * visible fractions, at most once per idle pass however many scroll
+ * updates happened. With an observer the scrollcommand is a C command
+ * named rb_scroll<axis><widget>; it goes away with the widget.
+ *
+ * scrollbar may be nil to only observe the widget.
+ *
+ * Returns nil. Raises TclError if a path is not a window.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_scroll_link(int argc, VALUE *argv, VALUE self)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    VALUE widget, bar, axis_arg, observer;
+    Tcl_Obj *wobj, *bobj = NULL, *cmd, *name;
+    Tk_Window mainWin, tkwin;
+    char axis, option[16];
+
+    rb_scan_args(argc, argv, "31", &widget, &bar, &axis_arg, &observer);
+    axis = scroll_axis(axis_arg);
+    mainWin = Tk_MainWindow(tip->interp);
+    if (!mainWin) {
+        rb_raise(eTclError, "Tk not initialized (no main window)");
+    }
+    tkwin = Tk_NameToWindow(tip->interp, StringValueCStr(widget), mainWin);
+    if (!tkwin) {
+        rb_raise(eTclError, "%s", Tcl_GetStringResult(tip->interp));
+    }
+    if (NIL_P(bar) && NIL_P(observer)) {
+        rb_raise(rb_eArgError, "scroll_link needs a scrollbar or an observer");
+    }
+    snprintf(option, sizeof(option), "-%cscrollcommand", axis);
+
+    wobj = rstring_obj(widget);
+    Tcl_IncrRefCount(wobj);
+    /* Relinking replaces any previous observer command */
+    name = Tcl_ObjPrintf("::rb_scroll%c%s", axis, Tcl_GetString(wobj));
+    Tcl_IncrRefCount(name);
+    Tcl_DeleteCommand(tip->interp, Tcl_GetString(name));
+    if (!NIL_P(bar)) {
+        Tcl_Obj *view[2];
+
+        if (!Tk_NameToWindow(tip->interp, StringValueCStr(bar), mainWin)) {
+            Tcl_DecrRefCount(wobj);
+            Tcl_DecrRefCount(name);
+            rb_raise(eTclError, "%s", Tcl_GetStringResult(tip->interp));
+        }
+        bobj = rstring_obj(bar);
+        Tcl_IncrRefCount(bobj);
+        view[0] = wobj;
+        view[1] = Tcl_ObjPrintf("%cview", axis);
+        scroll_configure(tip->interp, bobj, "-command", Tcl_NewListObj(2, view));
+    }
+
+    if (NIL_P(observer)) {
+        Tcl_Obj *set[2];
+
+        set[0] = bobj;
+        set[1] = Tcl_NewStringObj("set", 3);
+        cmd = Tcl_NewListObj(2, set);
+    } else {
+        struct scroll_link *link;
+        Tcl_Obj *notify = rstring_obj(observer);
+        Tcl_Size n;
+
+        if (Tcl_ListObjLength(tip->interp, notify, &n) != TCL_OK || n == 0) {
+            Tcl_DecrRefCount(wobj);
+            Tcl_DecrRefCount(name);
+            if (bobj) Tcl_DecrRefCount(bobj);
+            rb_raise(rb_eArgError, "observer must be a Tcl command prefix");
+        }
+        cmd = name;
+        link = (struct scroll_link *)ckalloc(sizeof(struct scroll_link));
+        link->interp = tip->interp;
+        link->tkwin = tkwin;
+        link->bar = bobj;
+        link->notify = notify;
+        Tcl_IncrRefCount(notify);
+        if (bobj) Tcl_IncrRefCount(bobj);
+        link->first = link->last = NULL;
+        link->pending = 0;
+        link->token = Tcl_CreateObjCommand(tip->interp, Tcl_GetString(cmd),
+                                           scroll_link_cmd, (ClientData)link,
+                                           scroll_link_delete);
+        Tk_CreateEventHandler(tkwin, StructureNotifyMask, scroll_link_destroyed,
+                              (ClientData)link);
+    }
+
+    scroll_configure(tip->interp, wobj, option, cmd);
+    Tcl_DecrRefCount(wobj);
+    Tcl_DecrRefCount(name);
+    if (bobj) Tcl_DecrRefCount(bobj);
+    return Qnil;
+}
+
+/* ---------------------------------------------------------
+ * Scroll groups
+ *
+ * A group is a Tcl command (rb_scrollgroup<N>) that keeps several
+ * widgets scrolled to the same fraction along one axis:
+ *
+ *   $group view moveto|scroll ...  - scrollbar -command: move every member
+ *   $group set path first last     - member -{x,y}scrollcommand
+ *   $group add path / remove path
+ *   $group scrollbar path          - attach the shared scrollbar
+ *   $group members / fractions / delete
+ *
+ * When one member scrolls by itself (wheel, keys, selection drag), the
+ * others are moved to its first fraction. The moves report back through
+ * their scrollcommands; until those reports have run (one idle pass) they
+ * only update the member's visible span, so members whose views snap to
+ * whole lines cannot push each other back and forth. The shared
+ * scrollbar shows the group position with the smallest visible span.
+ * --------------------------------------------------------- */
+
+struct scroll_group;
+
+struct scroll_member {
+    Tk_Window tkwin;
+    Tcl_Obj *path;
+    double first, last;
+    int reported;
+    struct scroll_group *group;
+};
+
+struct scroll_group {
+    Tcl_Interp *interp;
+    Tcl_Command token;
+    Tcl_Obj *name;
+    Tcl_Obj *view;          /* "xview" or "yview" */
+    char option[16];        /* "-xscrollcommand" or "-yscrollcommand" */
+    Tcl_Obj *bar;           /* shared scrollbar path, or NULL */
+    Tcl_Obj *notify;        /* observer prefix, or NULL */
+    double first, last;     /* group position */
+    struct scroll_member *leader; /* member that started the current move */
+    int settling;           /* followers' reports pending after a move */
+    int notify_pending;
+    long count, capacity;
+    struct scroll_member **members;
+};
+
+static unsigned long scroll_group_next_id;
+
+static void scroll_member_event(ClientData clientData, XEvent *eventPtr);
+
+static void
+scroll_group_settled(ClientData clientData)
+{
+    struct scroll_group *g = (struct scroll_group *)clientData;
+
+    g->settling = 0;
+    g->leader = NULL;
+}
+
+static void
+scroll_group_notify(ClientData clientData)
+{
+    struct scroll_group *g = (struct scroll_group *)clientData;
+
+    g->notify_pending = 0;
+    scroll_observe(g->interp, g->notify, Tcl_NewDoubleObj(g->first),
+                   Tcl_NewDoubleObj(g->last));
+}
+
+static long
+scroll_group_find(struct scroll_group *g, const char *path)
+{
+    long i;
+
+    for (i = 0; i < g->count; i++) {
+        if (strcmp(Tcl_GetString(g->members[i]->path), path) == 0) return i;
+    }
+    return -1;
+}
+
+/* Show the group position on the scrollbar and tell the observer */
+static void
+scroll_group_show(struct scroll_group *g)
+{
+    double span = 1.0;
+    long i;
+
+    for (i = 0; i < g->count; i++) {
+        struct scroll_member *m = g->members[i];
+        if (m->reported && m->last - m->first < span) span = m->last - m->first;
+    }
+    g->last = g->first + span;
+    if (g->last > 1.0) g->last = 1.0;
+
+    if (g->bar) {
+        Tcl_Obj *set[4];
+
+        set[0] = g->bar;
+        set[1] = Tcl_NewStringObj("set", 3);
+        set[2] = Tcl_NewDoubleObj(g->first);
+        set[3] = Tcl_NewDoubleObj(g->last);
+        if (scroll_evalv(g->interp, 4, set) != TCL_OK) {
+            Tcl_BackgroundException(g->interp, TCL_ERROR);
+        }
+    }
+    if (g->notify && !g->notify_pending) {
+        Tcl_DoWhenIdle(scroll_group_notify, (ClientData)g);
+        g->notify_pending = 1;
+    }
+}
+
+/* Move every member except lead to fraction; their reports settle first */
+static int
+scroll_group_moveto(struct scroll_group *g, struct scroll_member *lead, double fraction)
+{
+    long i;
+
+    g->first = fraction;
+    g->leader = lead;
+    for (i = 0; i < g->count; i++) {
+        struct scroll_member *m = g->members[i];
+        Tcl_Obj *objv[4];
+
+        if (m == lead || m->tkwin == NULL) continue;
+        objv[0] = m->path;
+        objv[1] = g->view;
+        objv[2] = Tcl_NewStringObj("moveto", -1);
+        objv[3] = Tcl_NewDoubleObj(fraction);
+        if (scroll_evalv(g->interp, 4, objv) != TCL_OK) return TCL_ERROR;
+    }
+    Tcl_ResetResult(g->interp);
+    if (!g->settling) {
+        /* Queued after the members' own scrollcommand updates */
+        Tcl_DoWhenIdle(scroll_group_settled, (ClientData)g);
+        g->settling = 1;
+    }
+    scroll_group_show(g);
+    return TCL_OK;
+}
+
+static void
+scroll_member_free(struct scroll_member *m)
+{
+    if (m->tkwin) {
+        Tk_DeleteEventHandler(m->tkwin, StructureNotifyMask, scroll_member_event,
+                              (ClientData)m);
+    }
+    Tcl_DecrRefCount(m->path);
+    ckfree((char *)m);
+}
+
+static void
+scroll_group_drop(struct scroll_group *g, long i)
+{
+    if (g->leader == g->members[i]) g->leader = NULL;
+    scroll_member_free(g->members[i]);
+    memmove(&g->members[i], &g->members[i + 1],
+            sizeof(struct scroll_member *) * (size_t)(g->count - i - 1));
+    g->count--;
+}
+
+static void
+scroll_member_event(ClientData clientData, XEvent *eventPtr)
+{
+    struct scroll_member *m = (struct scroll_member *)clientData;
+    struct scroll_group *g = m->group;
+    long i;
+
+    if (eventPtr->type != DestroyNotify) return;
+    m->tkwin = NULL;
+    if (g->leader == m) g->leader = NULL;
+    for (i = 0; i < g->count; i++) {
+        if (g->members[i] == m) {
+            scroll_group_drop(g, i);
+            break;
+        }
+    }
+}
+
+static int
+scroll_group_attach(struct scroll_group *g, Tcl_Obj *path)
+{
+    struct scroll_member *m;
+    Tk_Window tkwin;
+    Tcl_Obj *words[3];
+
+    tkwin = Tk_NameToWindow(g->interp, Tcl_GetString(path), Tk_MainWindow(g->interp));
+    if (!tkwin) return TCL_ERROR;
+    if (scroll_group_find(g, Tcl_GetString(path)) >= 0) return TCL_OK;
+
+    words[0] = g->name;
+    words[1] = Tcl_NewStringObj("set", 3);
+    words[2] = path;
+    if (scroll_try_configure(g->interp, path, g->option, Tcl_NewListObj(3, words)) != TCL_OK) {
+        return TCL_ERROR;
+    }
+
+    if (g->count == g->capacity) {
+        g->capacity = g->capacity ? g->capacity * 2 : 4;
+        g->members = (struct scroll_member **)ckrealloc((char *)g->members,
+                        sizeof(struct scroll_member *) * (size_t)g->capacity);
+    }
+    m = (struct scroll_member *)ckalloc(sizeof(struct scroll_member));
+    m->tkwin = tkwin;
+    m->path = path;
+    Tcl_IncrRefCount(path);
+    m->first = 0.0;
+    m->last = 1.0;
+    m->reported = 0;
+    m->group = g;
+    g->members[g->count++] = m;
+    Tk_CreateEventHandler(tkwin, StructureNotifyMask, scroll_member_event, (ClientData)m);
+
+    /* A new member joins at the group position */
+    if (g->count > 1) {
+        Tcl_Obj *objv[4];
+
+        objv[0] = path;
+        objv[1] = g->view;
+        objv[2] = Tcl_NewStringObj("moveto", -1);
+        objv[3] = Tcl_NewDoubleObj(g->first);
+        return scroll_evalv(g->interp, 4, objv);
+    }
+    return TCL_OK;
+}
+
+/* path may be a fresh object; the member keeps its own reference */
+static int
+scroll_group_add(struct scroll_group *g, Tcl_Obj *path)
+{
+    int rc;
+
+    Tcl_IncrRefCount(path);
+    rc = scroll_group_attach(g, path);
+    Tcl_DecrRefCount(path);
+    return rc;
+}
+
+static void
+scroll_group_delete(ClientData clientData)
+{
+    struct scroll_group *g = (struct scroll_group *)clientData;
+    long i;
+
+    if (g->settling) Tcl_CancelIdleCall(scroll_group_settled, (ClientData)g);
+    if (g->notify_pending) Tcl_CancelIdleCall(scroll_group_notify, (ClientData)g);
+    for (i = 0; i < g->count; i++) {
+        struct scroll_member *m = g->members[i];
+        if (m->tkwin && !Tcl_InterpDeleted(g->interp)) {
+            scroll_try_configure(g->interp, m->path, g->option, Tcl_NewObj());
+        }
+        scroll_member_free(m);
+    }
+    Tcl_ResetResult(g->interp);
+    if (g->members) ckfree((char *)g->members);
+    if (g->bar) Tcl_DecrRefCount(g->bar);
+    if (g->notify) Tcl_DecrRefCount(g->notify);
+    Tcl_DecrRefCount(g->view);
+    Tcl_DecrRefCount(g->name);
+    ckfree((char *)g);
+}
+
+static int
+scroll_group_set_bar(struct scroll_group *g, Tcl_Obj *bar)
+{
+    Tcl_Obj *words[2];
+
+    if (Tcl_GetCharLength(bar) == 0) {
+        if (g->bar) Tcl_DecrRefCount(g->bar);
+        g->bar = NULL;
+        return TCL_OK;
+    }
+    words[0] = g->name;
+    words[1] = Tcl_NewStringObj("view", 4);
+    Tcl_IncrRefCount(bar);
+    if (scroll_try_configure(g->interp, bar, "-command", Tcl_NewListObj(2, words)) != TCL_OK) {
+        Tcl_DecrRefCount(bar);
+        return TCL_ERROR;
+    }
+    if (g->bar) Tcl_DecrRefCount(g->bar);
+    g->bar = bar;
+    scroll_group_show(g);
+    return TCL_OK;
+}
+
+static int
+scroll_group_cmd(ClientData clientData, Tcl_Interp *interp,
+                 RBTK_OBJC_TYPE objc, Tcl_Obj *const objv[])
+{
+    static const char *const subcmds[] = {
+        "add", "delete", "fractions", "members", "remove", "scrollbar",
+        "set", "view", NULL
+    };
+    enum { G_ADD, G_DELETE, G_FRACTIONS, G_MEMBERS, G_REMOVE, G_SCROLLBAR,
+           G_SET, G_VIEW };
+    struct scroll_group *g = (struct scroll_group *)clientData;
+    int index;
+    long i;
+
+    if (objc < 2) {
+        Tcl_WrongNumArgs(interp, 1, objv, "subcommand ?arg ...?");
+        return TCL_ERROR;
+    }
+    if (Tcl_GetIndexFromObj(interp, objv[1], subcmds, "subcommand", 0, &index) != TCL_OK) {
+        return TCL_ERROR;
+    }
+
+    switch (index) {
+    case G_SET: {
+        struct scroll_member *m;
+        double first, last;
+
+        if (objc != 5) {
+            Tcl_WrongNumArgs(interp, 2, objv, "path first last");
+            return TCL_ERROR;
+        }
+        i = scroll_group_find(g, Tcl_GetString(objv[2]));
+        if (i < 0) return TCL_OK;   /* late report from a removed member */
+        if (Tcl_GetDoubleFromObj(interp, objv[3], &first) != TCL_OK ||
+            Tcl_GetDoubleFromObj(interp, objv[4], &last) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        m = g->members[i];
+        m->first = first;
+        m->last = last;
+        m->reported = 1;
+        if ((!g->settling || m == g->leader) && fabs(first - g->first) > 1e-9) {
+            /* This member scrolled on its own: it leads */
+            return scroll_group_moveto(g, m, first);
+        }
+        scroll_group_show(g);
+        return TCL_OK;
+    }
+    case G_VIEW: {
+        struct scroll_member *lead = NULL;
+        Tcl_Obj **words, *query[2];
+        Tcl_Size n;
+        double first;
+        int j, rc;
+
+        if (objc < 3) {
+            Tcl_WrongNumArgs(interp, 2, objv, "moveto fraction | scroll number what");
+            return TCL_ERROR;
+        }
+        if (strcmp(Tcl_GetString(objv[2]), "moveto") == 0) {
+            if (objc != 4) {
+                Tcl_WrongNumArgs(interp, 2, objv, "moveto fraction");
+                return TCL_ERROR;
+            }
+            if (Tcl_GetDoubleFromObj(interp, objv[3], &first) != TCL_OK) return TCL_ERROR;
+            if (first < 0.0) first = 0.0;
+            if (first > 1.0) first = 1.0;
+            return scroll_group_moveto(g, NULL, first);
+        }
+        /* scroll: the first member takes the step, the rest follow it */
+        for (i = 0; i < g->count && !lead; i++) {
+            if (g->members[i]->tkwin) lead = g->members[i];
+        }
+        if (!lead) return TCL_OK;
+        words = (Tcl_Obj **)ckalloc(sizeof(Tcl_Obj *) * (size_t)objc);
+        words[0] = lead->path;
+        words[1] = g->view;
+        for (j = 2; j < objc; j++) words[j] = objv[j];
+        rc = scroll_evalv(interp, (int)objc, words);
+        ckfree((char *)words);
+        if (rc != TCL_OK) return TCL_ERROR;
+
+        query[0] = lead->path;
+        query[1] = g->view;
+        if (scroll_evalv(interp, 2, query) != TCL_OK ||
+            Tcl_ListObjGetElements(interp, Tcl_GetObjResult(interp), &n, &words) != TCL_OK ||
+            n < 2 || Tcl_GetDoubleFromObj(interp, words[0], &first) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        return scroll_group_moveto(g, lead, first);
+    }
+    case G_ADD:
+    case G_REMOVE:
+        if (objc != 3) {
+            Tcl_WrongNumArgs(interp, 2, objv, "path");
+            return TCL_ERROR;
+        }
+        if (index == G_ADD) return scroll_group_add(g, objv[2]);
+        i = scroll_group_find(g, Tcl_GetString(objv[2]));
+        if (i >= 0) {
+            if (g->members[i]->tkwin) {
+                scroll_try_configure(interp, objv[2], g->option, Tcl_NewObj());
+                Tcl_ResetResult(interp);
+            }
+            scroll_group_drop(g, i);
+        }
+        return TCL_OK;
+    case G_SCROLLBAR:
+        if (objc == 2) {
+            if (g->bar) Tcl_SetObjResult(interp, g->bar);
+            return TCL_OK;
+        }
+        if (objc != 3) {
+            Tcl_WrongNumArgs(interp, 2, objv, "?path?");
+            return TCL_ERROR;
+        }
+        return scroll_group_set_bar(g, objv[2]);
+    case G_MEMBERS: {
+        Tcl_Obj *list = Tcl_NewListObj(0, NULL);
+        for (i = 0; i < g->count; i++) {
+            Tcl_ListObjAppendElement(NULL, list, g->members[i]->path);
+        }
+        Tcl_SetObjResult(interp, list);
+        return TCL_OK;
+    }
+    case G_FRACTIONS: {
+        Tcl_Obj *pair[2];
+        pair[0] = Tcl_NewDoubleObj(g->first);
+        pair[1] = Tcl_NewDoubleObj(g->last);
+        Tcl_SetObjResult(interp, Tcl_NewListObj(2, pair));
+        return TCL_OK;
+    }
+    case G_DELETE:
+        Tcl_DeleteCommandFromToken(interp, g->token);
+        return TCL_OK;
+    }
+    return TCL_OK;
+}
+
+/* ---------------------------------------------------------
+ * Interp#scroll_group(paths, axis, scrollbar=nil, observer=nil)
+ *
+ * Create a scroll group: a Tcl command that keeps the widgets in paths
+ * at the same scroll fraction along axis and drives one shared
+ * scrollbar, with no Ruby code run while scrolling. observer, a Tcl
+ * command prefix, gets the group's first and last fractions at most
+ * once per idle pass.
+ *
+ * Members and scrollbar can be changed later through the command
+ * ("$group add path", "$group scrollbar path", ...); members leave the
+ * group when destroyed.
+ *
+ * Returns the group command name.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_scroll_group(int argc, VALUE *argv, VALUE self)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    VALUE paths, axis_arg, bar, observer, name;
+    struct scroll_group *g;
+    char axis;
+    long i;
+
+    rb_scan_args(argc, argv, "22", &paths, &axis_arg, &bar, &observer);
+    Check_Type(paths, T_ARRAY);
+    axis = scroll_axis(axis_arg);
+    if (!Tk_MainWindow(tip->interp)) {
+        rb_raise(eTclError, "Tk not initialized (no main window)");
+    }
+
+    g = (struct scroll_group *)ckalloc(sizeof(struct scroll_group));
+    memset(g, 0, sizeof(*g));
+    g->interp = tip->interp;
+    g->name = Tcl_ObjPrintf("::rb_scrollgroup%lu", ++scroll_group_next_id);
+    Tcl_IncrRefCount(g->name);
+    g->view = Tcl_ObjPrintf("%cview", axis);
+    Tcl_IncrRefCount(g->view);
+    snprintf(g->option, sizeof(g->option), "-%cscrollcommand", axis);
+    g->last = 1.0;
+    if (!NIL_P(observer)) {
+        g->notify = rstring_obj(observer);
+        Tcl_IncrRefCount(g->notify);
+    }
+    g->token = Tcl_CreateObjCommand(tip->interp, Tcl_GetString(g->name),
+                                    scroll_group_cmd, (ClientData)g,
+                                    scroll_group_delete);
+    name = rb_utf8_str_new_cstr(Tcl_GetString(g->name));
+
+    /* On error the group is deleted, which unhooks members added so far */
+    for (i = 0; i < RARRAY_LEN(paths); i++) {
+        VALUE path = rb_ary_entry(paths, i);
+        if (!RB_TYPE_P(path, T_STRING)) path = rb_obj_as_string(path);
+        if (scroll_group_add(g, rstring_obj(path)) != TCL_OK) break;
+    }
+    if (i == RARRAY_LEN(paths) && !NIL_P(bar)) {
+        if (scroll_group_set_bar(g, rstring_obj(bar)) != TCL_OK) i = -1;
+    }
+    if (i != RARRAY_LEN(paths)) {
+        VALUE msg = rb_utf8_str_new_cstr(Tcl_GetStringResult(tip->interp));
+        Tcl_DeleteCommandFromToken(tip->interp, g->token);
+        rb_exc_raise(rb_exc_new_str(eTclError, msg));
+    }
+    Tcl_ResetResult(tip->interp);
+    return name;
+}
+
+/* ---------------------------------------------------------
+ * Init_tkscroll - Register scrollbar linkage methods on TclTkIp class
+ *
+ * Called from Init_tcltklib in tcltkbridge.c
+ * --------------------------------------------------------- */
+
+void
+Init_tkscroll(VALUE cTclTkIp)
+{
+    rb_define_method(cTclTkIp, "scroll_link", interp_scroll_link, -1);
+    rb_define_method(cTclTkIp, "scroll_group", interp_scroll_group, -1);
+}
@@ -0,0 +1,404 @@
+/* tkselection.c - Selection/clipboard streaming C functions for tk-ng
+ *
+ * Lazy selection providers (Tk_CreateSelHandler) that hand Tk byte
+ * ranges straight from a Ruby String or provider object, and chunked
+ * selection reads (Tk_GetSelection) that yield each piece as it arrives.
+ * Neither path builds the whole payload as one Tcl string.
+ */
+
+#include "tcltkbridge.h"
+#include <string.h>
+
+#if TK_MAJOR_VERSION >= 9
+typedef Tcl_Size rbtk_sel_size;
+#else
+typedef int rbtk_sel_size;
+#endif
+
+/* One registered handler: (window, selection, target) => provider */
+struct sel_provider {
+    Tk_Window tkwin;    /* NULL once the window is gone or handler removed */
+    Atom selection;
+    Atom target;
+    VALUE provider;     /* frozen String, or object responding to #call */
+    VALUE owner;        /* Interp object holding the registry */
+    VALUE key;          /* registry key */
+};
+
+static void
+sel_provider_mark(void *ptr)
+{
+    struct sel_provider *sp = ptr;
+    rb_gc_mark(sp->provider);
+    rb_gc_mark(sp->owner);
+    rb_gc_mark(sp->key);
+}
+
+static size_t
+sel_provider_memsize(const void *ptr)
+{
+    return sizeof(struct sel_provider);
+}
+
+static const rb_data_type_t sel_provider_type = {
+    .wrap_struct_name = "TclTkBridge::SelectionProvider",
+    .function = {
+        .dmark = sel_provider_mark,
+        .dfree = RUBY_TYPED_DEFAULT_FREE,
+        .dsize = sel_provider_memsize,
+    },
+    .flags = RUBY_TYPED_FREE_IMMEDIATELY,
+};
+
+static ID id_selection_providers;
+static ID id_call;
+
+/* Registry Hash stored as a hidden ivar on the Interp object */
+static VALUE
+provider_registry(VALUE self)
+{
+    VALUE reg = rb_ivar_get(self, id_selection_providers);
+    if (NIL_P(reg)) {
+        reg = rb_hash_new();
+        rb_ivar_set(self, id_selection_providers, reg);
+    }
+    return reg;
+}
+
+/* Length of buf[0..len) without a trailing incomplete UTF-8 sequence */
+static long
+utf8_complete_len(const char *buf, long len)
+{
+    long i = len;
+    unsigned char lead;
+    long need;
+
+    while (i > 0 && ((unsigned char)buf[i - 1] & 0xC0) == 0x80) i--;
+    if (i == 0) return len;
+    lead = (unsigned char)buf[i - 1];
+    if (lead < 0x80) return len;
+    need = (lead >= 0xF0) ? 4 : (lead >= 0xE0) ? 3 : 2;
+    return (len - (i - 1) >= need) ? len : i - 1;
+}
+
+struct provider_call_args {
+    VALUE provider;
+    long offset;
+    long max_bytes;
+};
+
+static VALUE
+provider_call(VALUE varg)
+{
+    struct provider_call_args *a = (struct provider_call_args *)varg;
+    VALUE chunk = rb_funcall(a->provider, id_call, 2,
+                             LONG2NUM(a->offset), LONG2NUM(a->max_bytes));
+    if (!NIL_P(chunk)) StringValue(chunk);
+    return chunk;
+}
+
+/*
+ * Copy provider chunks into buffer until it is full or the provider
+ * returns nil/"". Providers may return fewer bytes than asked for, but
+ * Tk treats a short chunk as the end of the selection, so keep asking.
+ * Returns bytes copied, or -1 if the provider raised.
+ */
+static long
+sel_provider_fill(struct sel_provider *sp, long offset, char *buffer, long maxBytes)
+{
+    long filled = 0;
+
+    while (filled < maxBytes) {
+        struct provider_call_args args;
+        VALUE chunk;
+        long len;
+        int state;
+
+        args.provider = sp->provider;
+        args.offset = offset + filled;
+        args.max_bytes = maxBytes - filled;
+        chunk = rb_protect(provider_call, (VALUE)&args, &state);
+        if (state) {
+            VALUE errinfo = rb_errinfo();
+            rb_set_errinfo(Qnil);
+            if (rb_obj_is_kind_of(errinfo, rb_eSystemExit) ||
+                rb_obj_is_kind_of(errinfo, rb_eInterrupt)) {
+                rb_exc_raise(errinfo);
+            }
+            rb_warn("selection provider raised: %"PRIsVALUE, errinfo);
+            return -1;
+        }
+        if (NIL_P(chunk) || RSTRING_LEN(chunk) == 0) break;
+        len = RSTRING_LEN(chunk);
+        if (len > maxBytes - filled) len = maxBytes - filled;
+        memcpy(buffer + filled, RSTRING_PTR(chunk), (size_t)len);
+        filled += len;
+    }
+    return filled;
+}
+
+/* Tk_SelectionProc: copy at most maxBytes starting at offset into buffer */
+static rbtk_sel_size
+sel_provider_proc(ClientData clientData, rbtk_sel_size offset, char *buffer,
+                  rbtk_sel_size maxBytes)
+{
+    struct sel_provider *sp = (struct sel_provider *)clientData;
+    long avail;
+
+    if (!RB_TYPE_P(sp->provider, T_STRING)) {
+        return (rbtk_sel_size)sel_provider_fill(sp, (long)offset, buffer, (long)maxBytes);
+    }
+
+    avail = RSTRING_LEN(sp->provider) - (long)offset;
+    if (avail <= 0) return 0;
+    if (avail > (long)maxBytes) avail = (long)maxBytes;
+    memcpy(buffer, RSTRING_PTR(sp->provider) + offset, (size_t)avail);
+    return (rbtk_sel_size)avail;
+}
+
+/* Window destroyed: Tk drops its handlers, so drop ours from the registry */
+static void
+sel_provider_event(ClientData clientData, XEvent *eventPtr)
+{
+    struct sel_provider *sp = (struct sel_provider *)clientData;
+
+    if (eventPtr->type != DestroyNotify || sp->tkwin == NULL) return;
+    sp->tkwin = NULL;
+    rb_hash_delete(provider_registry(sp->owner), sp->key);
+}
+
+static void
+sel_provider_release(struct sel_provider *sp)
+{
+    if (sp->tkwin == NULL) return;
+    Tk_DeleteSelHandler(sp->tkwin, sp->selection, sp->target);
+    Tk_DeleteEventHandler(sp->tkwin, StructureNotifyMask, sel_provider_event,
+                          (ClientData)sp);
+    sp->tkwin = NULL;
+}
+
+static Tk_Window
+window_for(struct tcltk_interp *tip, VALUE path)
+{
+    Tk_Window mainWin, tkwin;
+
+    StringValue(path);
+    mainWin = Tk_MainWindow(tip->interp);
+    if (!mainWin) {
+        rb_raise(eTclError, "Tk not initialized");
+    }
+    tkwin = Tk_NameToWindow(tip->interp, StringValueCStr(path), mainWin);
+    if (!tkwin) {
+        rb_raise(eTclError, "%s", Tcl_GetStringResult(tip->interp));
+    }
+    return tkwin;
+}
+
+static VALUE
+provider_key(VALUE path, VALUE selection, VALUE target)
+{
+    return rb_str_freeze(rb_sprintf("%"PRIsVALUE" %"PRIsVALUE" %"PRIsVALUE,
+                                    path, selection, target));
+}
+
+/* ---------------------------------------------------------
+ * Interp#selection_provide(win_path, provider, selection, target, format)
+ *
+ * Serve a selection target lazily from Ruby.
+ * Tk asks for the data in chunks (offset, maxBytes); each chunk is copied
+ * straight from the provider into Tk's buffer - the payload never becomes
+ * a Tcl string.
+ *
+ * Arguments:
+ *   win_path  - Tk path of the window handling the selection
+ *   provider  - String (served by byte range with no Ruby calls), or an
+ *               object whose #call(offset, max_bytes) returns the String
+ *               starting at offset (at most max_bytes used; nil or "" = end)
+ *   selection - Selection atom name (e.g., "PRIMARY", "CLIPBOARD")
+ *   target    - Target type (e.g., "STRING", "UTF8_STRING")
+ *   format    - Format returned to the requester (e.g., "STRING")
+ *
+ * Replaces any earlier handler for the same window/selection/target.
+ * The handler is dropped automatically when the window is destroyed.
+ *
+ * See: https://www.tcl-lang.org/man/tcl/TkLib/CrtSelHdlr.html
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_selection_provide(VALUE self, VALUE win_path, VALUE provider,
+                         VALUE selection, VALUE target, VALUE format)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    struct sel_provider *sp, *old;
+    Tk_Window tkwin;
+    VALUE reg, key, obj, prev;
+
+    StringValue(selection);
+    StringValue(target);
+    StringValue(format);
+    if (RB_TYPE_P(provider, T_STRING)) {
+        provider = rb_str_new_frozen(provider);  /* shares the buffer */
+    } else if (!rb_respond_to(provider, id_call)) {
+        rb_raise(rb_eArgError, "selection provider must be a String or respond to #call");
+    }
+    tkwin = window_for(tip, win_path);
+
+    reg = provider_registry(self);
+    key = provider_key(win_path, selection, target);
+    prev = rb_hash_lookup(reg, key);
+    if (!NIL_P(prev)) {
+        TypedData_Get_Struct(prev, struct sel_provider, &sel_provider_type, old);
+        sel_provider_release(old);
+    }
+
+    obj = TypedData_Make_Struct(rb_cObject, struct sel_provider, &sel_provider_type, sp);
+    sp->tkwin = tkwin;
+    sp->selection = Tk_InternAtom(tkwin, StringValueCStr(selection));
+    sp->target = Tk_InternAtom(tkwin, StringValueCStr(target));
+    sp->provider = provider;
+    sp->owner = self;
+    sp->key = key;
+
+    Tk_CreateSelHandler(tkwin, sp->selection, sp->target, sel_provider_proc,
+                        (ClientData)sp, Tk_InternAtom(tkwin, StringValueCStr(format)));
+    Tk_CreateEventHandler(tkwin, StructureNotifyMask, sel_provider_event, (ClientData)sp);
+    rb_hash_aset(reg, key, obj);
+
+    return Qnil;
+}
+
+/* ---------------------------------------------------------
+ * Interp#selection_unprovide(win_path, selection, target)
+ *
+ * Remove a handler installed by selection_provide.
+ * Returns true if one was removed.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_selection_unprovide(VALUE self, VALUE win_path, VALUE selection, VALUE target)
+{
+    struct sel_provider *sp;
+    VALUE reg, key, obj;
+
+    get_interp(self);
+    StringValue(win_path);
+    StringValue(selection);
+    StringValue(target);
+
+    reg = provider_registry(self);
+    key = provider_key(win_path, selection, target);
+    obj = rb_hash_delete(reg, key);
+    if (NIL_P(obj)) return Qfalse;
+
+    TypedData_Get_Struct(obj, struct sel_provider, &sel_provider_type, sp);
+    sel_provider_release(sp);
+    return Qtrue;
+}
+
+/* Tk_GetSelProc state for selection_each */
+struct sel_reader {
+    int state;
+    long total;
+    char carry[4];      /* incomplete UTF-8 tail held for the next portion */
+    long ncarry;
+};
+
+static int
+sel_reader_proc(ClientData clientData, Tcl_Interp *interp, const char *portion)
+{
+    struct sel_reader *r = (struct sel_reader *)clientData;
+    long len = (long)strlen(portion);
+    long keep;
+    VALUE chunk;
+
+    /* Portions may split a character; yield whole characters only */
+    chunk = rb_utf8_str_new(r->carry, r->ncarry);
+    rb_str_cat(chunk, portion, len);
+    keep = RSTRING_LEN(chunk) - utf8_complete_len(RSTRING_PTR(chunk), RSTRING_LEN(chunk));
+    if (keep > 0) {
+        memcpy(r->carry, RSTRING_PTR(chunk) + RSTRING_LEN(chunk) - keep, (size_t)keep);
+        rb_str_set_len(chunk, RSTRING_LEN(chunk) - keep);
+    }
+    r->ncarry = keep;
+    if (RSTRING_LEN(chunk) == 0) return TCL_OK;
+
+    r->total += RSTRING_LEN(chunk);
+    rb_protect(rb_yield, chunk, &r->state);
+    if (r->state) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("selection read aborted", -1));
+        return TCL_ERROR;
+    }
+    return TCL_OK;
+}
+
+/* ---------------------------------------------------------
+ * Interp#selection_each(win_path, selection, target) { |chunk| ... }
+ *
+ * Read a selection (or "CLIPBOARD") incrementally.
+ * Yields each portion as Tk receives it instead of concatenating the
+ * whole payload first. Chunks are UTF-8 Strings that never end in the
+ * middle of a character.
+ *
+ * Arguments:
+ *   win_path  - Window whose display is queried (e.g., ".")
+ *   selection - Selection atom name (e.g., "PRIMARY", "CLIPBOARD")
+ *   target    - Target type (e.g., "STRING", "UTF8_STRING")
+ *
+ * Returns total number of bytes yielded.
+ * Raises TclError if the selection does not exist or lacks the target.
+ *
+ * See: https://www.tcl-lang.org/man/tcl/TkLib/GetSelect.html
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_selection_each(VALUE self, VALUE win_path, VALUE selection, VALUE target)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    struct sel_reader r;
+    Tk_Window tkwin;
+    int result;
+
+    rb_need_block();
+    StringValue(selection);
+    StringValue(target);
+    tkwin = window_for(tip, win_path);
+
+    r.state = 0;
+    r.total = 0;
+    r.ncarry = 0;
+    result = Tk_GetSelection(tip->interp, tkwin,
+                             Tk_InternAtom(tkwin, StringValueCStr(selection)),
+                             Tk_InternAtom(tkwin, StringValueCStr(target)),
+                             sel_reader_proc, (ClientData)&r);
+
+    if (r.state) {
+        Tcl_ResetResult(tip->interp);
+        rb_jump_tag(r.state);
+    }
+    if (result != TCL_OK) {
+        rb_raise(eTclError, "%s", Tcl_GetStringResult(tip->interp));
+    }
+    if (r.ncarry > 0) {
+        r.total += r.ncarry;
+        rb_yield(rb_utf8_str_new(r.carry, r.ncarry));
+    }
+
+    return LONG2NUM(r.total);
+}
+
+/* ---------------------------------------------------------
+ * Init_tkselection - Register selection methods on TclTkIp class
+ *
+ * Called from Init_tcltklib in tcltkbridge.c
+ * --------------------------------------------------------- */
+
+void
+Init_tkselection(VALUE cTclTkIp)
+{
+    id_selection_providers = rb_intern("selection_providers");
+    id_call = rb_intern("call");
+
+    rb_define_method(cTclTkIp, "selection_provide", interp_selection_provide, 5);
+    rb_define_method(cTclTkIp, "selection_unprovide", interp_selection_unprovide, 3);
+    rb_define_method(cTclTkIp, "selection_each", interp_selection_each, 3);
+}
@@ -0,0 +1,179 @@
+/* tkstyle.c - Bulk ttk style option resolution for tk-ng
+ *
+ * Interp#ttk_style_options resolves every option a ttk style uses in
+ * one bridge call: the options of each element in the style's layout,
+ * plus the options configured on the style and the styles it inherits
+ * from ("Big.TButton" -> "TButton" -> "."), each looked up with
+ * "ttk::style lookup". Tk::Tile::Style.prefetch fills its lookup cache
+ * from the result, so themed-widget code deriving colors and padding
+ * pays one call per style instead of one Tcl evaluation per option.
+ */
+
+#include "tcltkbridge.h"
+#include <string.h>
+
+struct style_query {
+    Tcl_Interp *interp;
+    Tcl_Obj *style_word;    /* ::ttk::style */
+    Tcl_Obj *options;       /* dict: -option => "" (ordered set) */
+};
+
+/* ::ttk::style sub ?arg ...?; result left in interp */
+static int
+style_eval(struct style_query *q, const char *sub, int argc, Tcl_Obj *const args[])
+{
+    Tcl_Obj *objv[6];
+    int objc = 0, i, rc;
+
+    objv[objc++] = q->style_word;
+    objv[objc++] = Tcl_NewStringObj(sub, -1);
+    for (i = 0; i < argc && objc < 6; i++) objv[objc++] = args[i];
+    for (i = 0; i < objc; i++) Tcl_IncrRefCount(objv[i]);
+    rc = Tcl_EvalObjv(q->interp, objc, objv, TCL_EVAL_GLOBAL);
+    for (i = 0; i < objc; i++) Tcl_DecrRefCount(objv[i]);
+    return rc;
+}
+
+static void
+style_add_options(struct style_query *q, Tcl_Obj *names, int stride)
+{
+    Tcl_Obj **elems, *empty = Tcl_NewObj();
+    Tcl_Size n, i;
+
+    Tcl_IncrRefCount(empty);
+    if (Tcl_ListObjGetElements(NULL, names, &n, &elems) == TCL_OK) {
+        for (i = 0; i < n; i += stride) {
+            Tcl_DictObjPut(NULL, q->options, elems[i], empty);
+        }
+    }
+    Tcl_DecrRefCount(empty);
+}
+
+/* Layout: {element {-option value ... -children {element {...} ...}}} */
+static void
+style_layout_options(struct style_query *q, Tcl_Obj *layout)
+{
+    Tcl_Obj **items, **spec;
+    Tcl_Size n, i, nspec, k;
+
+    if (Tcl_ListObjGetElements(NULL, layout, &n, &items) != TCL_OK) return;
+    for (i = 0; i + 1 < n; i += 2) {
+        Tcl_Obj *args[2];
+
+        args[0] = Tcl_NewStringObj("options", -1);
+        args[1] = items[i];
+        if (style_eval(q, "element", 2, args) == TCL_OK) {
+            style_add_options(q, Tcl_GetObjResult(q->interp), 1);
+        }
+        if (Tcl_ListObjGetElements(NULL, items[i + 1], &nspec, &spec) != TCL_OK) continue;
+        for (k = 0; k + 1 < nspec; k += 2) {
+            if (strcmp(Tcl_GetString(spec[k]), "-children") == 0) {
+                style_layout_options(q, spec[k + 1]);
+            }
+        }
+    }
+}
+
+/* Options configured on style, its parents and "." */
+static void
+style_configured_options(struct style_query *q, const char *style)
+{
+    const char *parent = style;
+
+    for (;;) {
+        Tcl_Obj *name = Tcl_NewStringObj(parent, -1);
+        const char *dot;
+
+        if (style_eval(q, "configure", 1, &name) == TCL_OK) {
+            style_add_options(q, Tcl_GetObjResult(q->interp), 2);
+        }
+        if (strcmp(parent, ".") == 0) break;
+        dot = strchr(parent, '.');
+        parent = (dot && dot[1]) ? dot + 1 : ".";
+    }
+}
+
+/* ---------------------------------------------------------
+ * Interp#ttk_style_options(style, state="") - Resolve a style's options
+ *
+ * Returns Hash {"option" => value} for every option used by the
+ * elements of style's layout or configured on style or a style it
+ * inherits from, as "ttk::style lookup style -option ?state?" returns
+ * it in the current theme. Option names have no leading dash. state
+ * is a state spec such as "pressed !disabled"; "" is the normal state.
+ *
+ * Styles without a layout (such as ".") resolve just their configured
+ * options.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_ttk_style_options(int argc, VALUE *argv, VALUE self)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    struct style_query q;
+    VALUE style, state, result;
+    Tcl_Obj *style_obj, *state_obj = NULL, *key, *value;
+    Tcl_DictSearch search;
+    int done;
+
+    rb_scan_args(argc, argv, "11", &style, &state);
+    StringValue(style);
+    if (!NIL_P(state)) {
+        StringValue(state);
+        if (RSTRING_LEN(state) > 0) {
+            state_obj = Tcl_NewStringObj(RSTRING_PTR(state), (RBTK_STRLEN_TYPE)RSTRING_LEN(state));
+            Tcl_IncrRefCount(state_obj);
+        }
+    }
+
+    q.interp = tip->interp;
+    q.style_word = Tcl_NewStringObj("::ttk::style", -1);
+    q.options = Tcl_NewDictObj();
+    Tcl_IncrRefCount(q.style_word);
+    Tcl_IncrRefCount(q.options);
+    style_obj = Tcl_NewStringObj(RSTRING_PTR(style), (RBTK_STRLEN_TYPE)RSTRING_LEN(style));
+    Tcl_IncrRefCount(style_obj);
+
+    if (style_eval(&q, "layout", 1, &style_obj) == TCL_OK) {
+        Tcl_Obj *layout = Tcl_GetObjResult(q.interp);
+        Tcl_IncrRefCount(layout);
+        style_layout_options(&q, layout);
+        Tcl_DecrRefCount(layout);
+    }
+    style_configured_options(&q, StringValueCStr(style));
+
+    result = rb_hash_new();
+    Tcl_DictObjFirst(NULL, q.options, &search, &key, &value, &done);
+    for (; !done; Tcl_DictObjNext(&search, &key, &value, &done)) {
+        const char *opt = Tcl_GetString(key);
+        Tcl_Obj *args[3];
+
+        /* lookup style -option ?state? */
+        args[0] = style_obj;
+        args[1] = key;
+        args[2] = state_obj;
+        if (style_eval(&q, "lookup", state_obj ? 3 : 2, args) != TCL_OK) continue;
+        rb_hash_aset(result, rb_utf8_str_new_cstr(opt[0] == '-' ? opt + 1 : opt),
+                     rb_utf8_str_new_cstr(Tcl_GetStringResult(q.interp)));
+    }
+    Tcl_DictObjDone(&search);
+
+    Tcl_DecrRefCount(style_obj);
+    Tcl_DecrRefCount(q.options);
+    Tcl_DecrRefCount(q.style_word);
+    if (state_obj) Tcl_DecrRefCount(state_obj);
+    Tcl_ResetResult(tip->interp);
+    return result;
+}
+
+/* ---------------------------------------------------------
+ * Init_tkstyle - Register ttk style methods on TclTkIp class
+ *
+ * Called from Init_tcltklib in tcltkbridge.c
+ * --------------------------------------------------------- */
+
+void
+Init_tkstyle(VALUE cTclTkIp)
+{
+    rb_define_method(cTclTkIp, "ttk_style_options", interp_ttk_style_options, -1);
+}
@@ -0,0 +1,759 @@
+/* tktreeview.c - ttk::treeview bulk C functions for tk-ng
+ *
+ * Bulk row operations for ttk::treeview: insert, column fetch and sort.
+ * These functions build Tcl list objects directly from Ruby arrays,
+ * avoiding per-row Ruby wrapper objects and option hash conversion.
+ */
+
+#include "tcltkbridge.h"
+#include <ruby/util.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Cell value as a String (nil stays nil); runs the value's #to_s */
+static VALUE
+cell_to_str(VALUE val)
+{
+    if (NIL_P(val) || RB_TYPE_P(val, T_STRING)) return val;
+    return rb_obj_as_string(val);
+}
+
+/* Convert a cell String (or nil) to a new (unshared) Tcl_Obj */
+static Tcl_Obj *
+cell_to_obj(VALUE str)
+{
+    if (NIL_P(str)) {
+        return Tcl_NewObj();
+    }
+    return Tcl_NewStringObj(RSTRING_PTR(str), RSTRING_LEN(str));
+}
+
+/* Fetch cell (row, col) from row-major or columnar data */
+static VALUE
+fetch_cell(VALUE data, int columnar, long row, long col)
+{
+    VALUE line = rb_ary_entry(data, columnar ? col : row);
+    if (NIL_P(line)) return Qnil;
+    return rb_ary_entry(line, columnar ? row : col);
+}
+
+/* ---------------------------------------------------------
+ * Interp#treeview_insert_rows(tree_path, parent, index, data, opts=nil)
+ *
+ * Insert many rows into a ttk::treeview in one C call.
+ * Each row's -values list is built directly as a Tcl list object.
+ *
+ * Arguments:
+ *   tree_path - Tk path of the treeview (e.g., ".f.tree")
+ *   parent    - Parent item id ("" for top level)
+ *   index     - Insert position ("end" or an integer, advanced per row)
+ *   data      - Array of row arrays (row-major), or Array of column
+ *               arrays when :columnar is true
+ *   opts      - Optional hash:
+ *               :columnar - data is column-major (default false)
+ *               :map      - Array of Integer: for each treeview column,
+ *                           the source column index in data (-1 = empty).
+ *                           Default: identity (data already in -columns order)
+ *               :text     - Array of per-row strings for the tree column
+ *               :tags     - Tcl list string of tags applied to every row
+ *
+ * Returns Array of inserted item ids (Strings).
+ *
+ * See: https://www.tcl-lang.org/man/tcl/TkCmd/ttk_treeview.html#M52
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_treeview_insert_rows(int argc, VALUE *argv, VALUE self)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    VALUE tree_path, parent, index, data, opts;
+    VALUE map = Qnil, text = Qnil, tags = Qnil;
+    VALUE ids, rows, texts = Qnil;
+    int columnar = 0;
+    int index_is_int = 0;
+    long next_index = 0;
+    long nrows, ncols, nmap = 0, row, col, i;
+    long *map_idx = NULL;
+    Tcl_Obj *prefix[4];
+    Tcl_Obj *values_opt, *text_opt, *tags_opt, *tags_obj = NULL;
+
+    rb_scan_args(argc, argv, "41", &tree_path, &parent, &index, &data, &opts);
+
+    StringValue(tree_path);
+    Check_Type(data, T_ARRAY);
+    if (!NIL_P(parent)) StringValue(parent);
+
+    if (!NIL_P(opts)) {
+        Check_Type(opts, T_HASH);
+        columnar = RTEST(rb_hash_aref(opts, ID2SYM(rb_intern("columnar"))));
+        map = rb_hash_aref(opts, ID2SYM(rb_intern("map")));
+        text = rb_hash_aref(opts, ID2SYM(rb_intern("text")));
+        tags = rb_hash_aref(opts, ID2SYM(rb_intern("tags")));
+        if (!NIL_P(text)) Check_Type(text, T_ARRAY);
+        if (!NIL_P(tags)) StringValue(tags);
+    }
+
+    /* Validate the data layout up front so no Tcl objects leak on raise */
+    ncols = 0;
+    if (columnar) {
+        ncols = RARRAY_LEN(data);
+        nrows = NIL_P(text) ? 0 : RARRAY_LEN(text);
+        for (i = 0; i < ncols; i++) {
+            VALUE column = rb_ary_entry(data, i);
+            Check_Type(column, T_ARRAY);
+            if (i == 0) {
+                nrows = RARRAY_LEN(column);
+            } else if (RARRAY_LEN(column) != nrows) {
+                rb_raise(rb_eArgError,
+                         "columnar data length mismatch: column %ld has %ld rows, expected %ld",
+                         i, RARRAY_LEN(column), nrows);
+            }
+        }
+    } else {
+        nrows = RARRAY_LEN(data);
+        for (i = 0; i < nrows; i++) {
+            Check_Type(rb_ary_entry(data, i), T_ARRAY);
+        }
+    }
+
+    if (!NIL_P(text) && RARRAY_LEN(text) != nrows) {
+        rb_raise(rb_eArgError, "text size mismatch: expected %ld entries, got %ld",
+                 nrows, RARRAY_LEN(text));
+    }
+
+    if (!NIL_P(map)) {
+        Check_Type(map, T_ARRAY);
+        nmap = RARRAY_LEN(map);
+        map_idx = ALLOCA_N(long, nmap);
+        for (i = 0; i < nmap; i++) {
+            map_idx[i] = NUM2LONG(rb_ary_entry(map, i));
+        }
+    }
+
+    if (FIXNUM_P(index)) {
+        index_is_int = 1;
+        next_index = FIX2LONG(index);
+    } else {
+        StringValue(index);
+    }
+
+    ids = rb_ary_new2(nrows);
+    if (nrows == 0) {
+        return ids;
+    }
+
+    /* Convert every cell to a String now: #to_s may raise, and nothing
+     * may raise once Tcl objects exist or rows have been inserted */
+    rows = rb_ary_new2(nrows);
+    for (row = 0; row < nrows; row++) {
+        long width = map_idx ? nmap
+                   : columnar ? ncols : RARRAY_LEN(rb_ary_entry(data, row));
+        VALUE cells = rb_ary_new2(width);
+
+        for (col = 0; col < width; col++) {
+            VALUE cell;
+            if (map_idx) {
+                cell = (map_idx[col] < 0) ? Qnil
+                       : fetch_cell(data, columnar, row, map_idx[col]);
+            } else {
+                cell = fetch_cell(data, columnar, row, col);
+            }
+            rb_ary_push(cells, cell_to_str(cell));
+        }
+        rb_ary_push(rows, cells);
+    }
+    if (!NIL_P(text)) {
+        texts = rb_ary_new2(nrows);
+        for (row = 0; row < nrows; row++) {
+            rb_ary_push(texts, cell_to_str(rb_ary_entry(text, row)));
+        }
+    }
+
+    /* Leading words shared by every insert: path insert parent index */
+    prefix[0] = Tcl_NewStringObj(RSTRING_PTR(tree_path), RSTRING_LEN(tree_path));
+    prefix[1] = Tcl_NewStringObj("insert", -1);
+    prefix[2] = NIL_P(parent) ? Tcl_NewObj()
+                              : Tcl_NewStringObj(RSTRING_PTR(parent), RSTRING_LEN(parent));
+    prefix[3] = index_is_int ? Tcl_NewObj()
+                             : Tcl_NewStringObj(RSTRING_PTR(index), RSTRING_LEN(index));
+    for (i = 0; i < 4; i++) {
+        Tcl_IncrRefCount(prefix[i]);
+    }
+
+    values_opt = Tcl_NewStringObj("-values", -1);
+    text_opt = Tcl_NewStringObj("-text", -1);
+    tags_opt = Tcl_NewStringObj("-tags", -1);
+    Tcl_IncrRefCount(values_opt);
+    Tcl_IncrRefCount(text_opt);
+    Tcl_IncrRefCount(tags_opt);
+    if (!NIL_P(tags)) {
+        tags_obj = Tcl_NewStringObj(RSTRING_PTR(tags), RSTRING_LEN(tags));
+        Tcl_IncrRefCount(tags_obj);
+    }
+
+    for (row = 0; row < nrows; row++) {
+        Tcl_Obj *objv[10];
+        Tcl_Obj *values, *index_obj, *text_obj = NULL;
+        Tcl_Size len;
+        const char *id;
+        int objc, result;
+
+        VALUE cells = RARRAY_AREF(rows, row);
+
+        values = Tcl_NewListObj(0, NULL);
+        Tcl_IncrRefCount(values);
+        for (col = 0; col < RARRAY_LEN(cells); col++) {
+            Tcl_ListObjAppendElement(NULL, values, cell_to_obj(RARRAY_AREF(cells, col)));
+        }
+
+        if (index_is_int) {
+            index_obj = Tcl_NewWideIntObj((Tcl_WideInt)next_index++);
+        } else {
+            index_obj = prefix[3];
+        }
+        Tcl_IncrRefCount(index_obj);
+
+        objv[0] = prefix[0];
+        objv[1] = prefix[1];
+        objv[2] = prefix[2];
+        objv[3] = index_obj;
+        objv[4] = values_opt;
+        objv[5] = values;
+        objc = 6;
+        if (!NIL_P(text)) {
+            text_obj = cell_to_obj(RARRAY_AREF(texts, row));
+            Tcl_IncrRefCount(text_obj);
+            objv[objc++] = text_opt;
+            objv[objc++] = text_obj;
+        }
+        if (tags_obj) {
+            objv[objc++] = tags_opt;
+            objv[objc++] = tags_obj;
+        }
+
+        result = Tcl_EvalObjv(tip->interp, objc, objv, 0);
+
+        Tcl_DecrRefCount(values);
+        Tcl_DecrRefCount(index_obj);
+        if (text_obj) Tcl_DecrRefCount(text_obj);
+
+        if (result != TCL_OK) {
+            break;
+        }
+
+        id = Tcl_GetStringFromObj(Tcl_GetObjResult(tip->interp), &len);
+        rb_ary_push(ids, rb_utf8_str_new(id, len));
+    }
+
+    for (i = 0; i < 4; i++) {
+        Tcl_DecrRefCount(prefix[i]);
+    }
+    Tcl_DecrRefCount(values_opt);
+    Tcl_DecrRefCount(text_opt);
+    Tcl_DecrRefCount(tags_opt);
+    if (tags_obj) Tcl_DecrRefCount(tags_obj);
+    RB_GC_GUARD(rows);
+    RB_GC_GUARD(texts);
+
+    if (row < nrows) {
+        rb_raise(eTclError, "treeview insert failed at row %ld: %s",
+                 row, Tcl_GetStringResult(tip->interp));
+    }
+
+    return ids;
+}
+
+/* ---------------------------------------------------------
+ * Column value fetch shared by sort and filter
+ * --------------------------------------------------------- */
+
+enum sort_type { SORT_STRING, SORT_NUMERIC, SORT_NATURAL, SORT_DATE };
+
+struct sort_entry {
+    Tcl_Obj *id;
+    Tcl_Obj *value;
+    const char *str;
+    double num;
+    long pos;
+    int missing;
+};
+
+struct sort_ctx {
+    enum sort_type type;
+    int descending;
+};
+
+static Tcl_Obj *
+rstring_to_obj(VALUE str)
+{
+    return Tcl_NewStringObj(RSTRING_PTR(str), RSTRING_LEN(str));
+}
+
+/* Validate an optional Ruby Array of item ids before any Tcl work */
+static void
+check_items(VALUE items)
+{
+    long i;
+
+    if (NIL_P(items)) return;
+    Check_Type(items, T_ARRAY);
+    for (i = 0; i < RARRAY_LEN(items); i++) {
+        VALUE id = rb_ary_entry(items, i);
+        StringValue(id);
+    }
+}
+
+/* Item list to operate on: the given ids, or `path children parent`.
+ * Returns a list object with a held reference, or NULL on Tcl error. */
+static Tcl_Obj *
+collect_items(Tcl_Interp *interp, Tcl_Obj *path, Tcl_Obj *parent, VALUE items)
+{
+    Tcl_Obj *list;
+    long i;
+
+    if (NIL_P(items)) {
+        Tcl_Obj *objv[3];
+        objv[0] = path;
+        objv[1] = Tcl_NewStringObj("children", -1);
+        objv[2] = parent;
+        Tcl_IncrRefCount(objv[1]);
+        if (Tcl_EvalObjv(interp, 3, objv, 0) != TCL_OK) {
+            Tcl_DecrRefCount(objv[1]);
+            return NULL;
+        }
+        Tcl_DecrRefCount(objv[1]);
+        list = Tcl_GetObjResult(interp);
+    } else {
+        list = Tcl_NewListObj(0, NULL);
+        for (i = 0; i < RARRAY_LEN(items); i++) {
+            Tcl_ListObjAppendElement(NULL, list, rstring_to_obj(rb_ary_entry(items, i)));
+        }
+    }
+    Tcl_IncrRefCount(list);
+    return list;
+}
+
+/* Fetch column (or "#0" tree text) for every item in list.
+ * Fills entries[0..n) with held id/value references. */
+static int
+fetch_column(Tcl_Interp *interp, Tcl_Obj *path, const char *column, Tcl_Size column_len,
+             Tcl_Obj *list, struct sort_entry *entries, Tcl_Size n)
+{
+    Tcl_Obj **ids;
+    Tcl_Obj *objv[4];
+    Tcl_Size count, i;
+    int tree_text = (column_len == 2 && strncmp(column, "#0", 2) == 0);
+    int result = TCL_OK;
+
+    Tcl_ListObjGetElements(NULL, list, &count, &ids);
+
+    objv[0] = path;
+    if (tree_text) {
+        objv[1] = Tcl_NewStringObj("item", -1);
+        objv[3] = Tcl_NewStringObj("-text", -1);
+    } else {
+        objv[1] = Tcl_NewStringObj("set", -1);
+        objv[3] = Tcl_NewStringObj(column, column_len);
+    }
+    Tcl_IncrRefCount(objv[1]);
+    Tcl_IncrRefCount(objv[3]);
+
+    for (i = 0; i < n; i++) {
+        entries[i].id = ids[i];
+        Tcl_IncrRefCount(ids[i]);
+        entries[i].pos = (long)i;
+        entries[i].missing = 0;
+        entries[i].num = 0.0;
+
+        objv[2] = ids[i];
+        if (Tcl_EvalObjv(interp, 4, objv, 0) != TCL_OK) {
+            Tcl_DecrRefCount(ids[i]);
+            result = TCL_ERROR;
+            break;
+        }
+        entries[i].value = Tcl_GetObjResult(interp);
+        Tcl_IncrRefCount(entries[i].value);
+        entries[i].str = Tcl_GetString(entries[i].value);
+    }
+
+    /* On error, release what was fetched so far */
+    if (result != TCL_OK) {
+        while (i-- > 0) {
+            Tcl_DecrRefCount(entries[i].id);
+            Tcl_DecrRefCount(entries[i].value);
+        }
+    }
+
+    Tcl_DecrRefCount(objv[1]);
+    Tcl_DecrRefCount(objv[3]);
+    return result;
+}
+
+static void
+release_entries(struct sort_entry *entries, Tcl_Size n)
+{
+    Tcl_Size i;
+
+    for (i = 0; i < n; i++) {
+        Tcl_DecrRefCount(entries[i].id);
+        Tcl_DecrRefCount(entries[i].value);
+    }
+    ckfree((char *)entries);
+}
+
+/* Days since 1970-01-01 for a proleptic Gregorian date */
+static long
+days_from_civil(long y, long m, long d)
+{
+    long era, yoe, doy, doe;
+
+    y -= m <= 2;
+    era = (y >= 0 ? y : y - 399) / 400;
+    yoe = y - era * 400;
+    doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+/* Fast path for YYYY-MM-DD[( |T)HH:MM[:SS]] (also with '/'), as UTC seconds */
+static int
+parse_iso_date(const char *s, double *out)
+{
+    int y, mo, d, h = 0, mi = 0, sec = 0, n = 0, m = 0;
+    char sep1, sep2;
+
+    if (sscanf(s, "%4d%c%2d%c%2d%n", &y, &sep1, &mo, &sep2, &d, &n) != 5) return 0;
+    if (sep1 != sep2 || (sep1 != '-' && sep1 != '/')) return 0;
+    if (mo < 1 || mo > 12 || d < 1 || d > 31) return 0;
+    s += n;
+    if (*s == ' ' || *s == 'T') {
+        if (sscanf(s + 1, "%2d:%2d%n", &h, &mi, &m) != 2) return 0;
+        s += 1 + m;
+        if (*s == ':') {
+            if (sscanf(s + 1, "%2d%n", &sec, &m) != 1) return 0;
+            s += 1 + m;
+        }
+    }
+    if (*s != '\0') return 0;
+    *out = (double)days_from_civil(y, mo, d) * 86400.0 + h * 3600 + mi * 60 + sec;
+    return 1;
+}
+
+/* Anything else goes through `clock scan -gmt 1` */
+static int
+scan_date(Tcl_Interp *interp, Tcl_Obj *value, double *out)
+{
+    Tcl_Obj *objv[5];
+    Tcl_WideInt secs;
+    int ok, i;
+
+    objv[0] = Tcl_NewStringObj("clock", -1);
+    objv[1] = Tcl_NewStringObj("scan", -1);
+    objv[2] = value;
+    objv[3] = Tcl_NewStringObj("-gmt", -1);
+    objv[4] = Tcl_NewBooleanObj(1);
+    for (i = 0; i < 5; i++) Tcl_IncrRefCount(objv[i]);
+
+    ok = Tcl_EvalObjv(interp, 5, objv, 0) == TCL_OK &&
+         Tcl_GetWideIntFromObj(NULL, Tcl_GetObjResult(interp), &secs) == TCL_OK;
+    if (ok) *out = (double)secs;
+
+    for (i = 0; i < 5; i++) Tcl_DecrRefCount(objv[i]);
+    Tcl_ResetResult(interp);
+    return ok;
+}
+
+/* Compare strings with embedded digit runs by numeric value, case-insensitively */
+static int
+natural_cmp(const char *a, const char *b)
+{
+    while (*a && *b) {
+        if (isdigit((unsigned char)*a) && isdigit((unsigned char)*b)) {
+            const char *sa, *sb;
+            size_t la, lb;
+            int c;
+
+            while (*a == '0') a++;
+            while (*b == '0') b++;
+            sa = a;
+            sb = b;
+            while (isdigit((unsigned char)*a)) a++;
+            while (isdigit((unsigned char)*b)) b++;
+            la = (size_t)(a - sa);
+            lb = (size_t)(b - sb);
+            if (la != lb) return la < lb ? -1 : 1;
+            c = memcmp(sa, sb, la);
+            if (c) return c;
+        } else {
+            int ca = tolower((unsigned char)*a);
+            int cb = tolower((unsigned char)*b);
+            if (ca != cb) return ca < cb ? -1 : 1;
+            a++;
+            b++;
+        }
+    }
+    return (*a != '\0') - (*b != '\0');
+}
+
+/* Typed comparison; unparsable values sort last, ties keep original order */
+static int
+sort_entry_cmp(const void *pa, const void *pb, void *data)
+{
+    const struct sort_entry *a = pa;
+    const struct sort_entry *b = pb;
+    const struct sort_ctx *ctx = data;
+    int c = 0;
+
+    if (a->missing || b->missing) {
+        if (a->missing != b->missing) return a->missing ? 1 : -1;
+    } else {
+        switch (ctx->type) {
+        case SORT_NUMERIC:
+        case SORT_DATE:
+            c = (a->num > b->num) - (a->num < b->num);
+            break;
+        case SORT_NATURAL:
+            c = natural_cmp(a->str, b->str);
+            break;
+        default:
+            c = strcmp(a->str, b->str);
+            break;
+        }
+        if (ctx->descending) c = -c;
+    }
+    if (c == 0) c = (a->pos > b->pos) - (a->pos < b->pos);
+    return c;
+}
+
+static enum sort_type
+sort_type_from(VALUE type)
+{
+    const char *name;
+
+    if (NIL_P(type)) return SORT_STRING;
+    name = SYMBOL_P(type) ? rb_id2name(SYM2ID(type)) : StringValueCStr(type);
+    if (strcmp(name, "string") == 0) return SORT_STRING;
+    if (strcmp(name, "numeric") == 0) return SORT_NUMERIC;
+    if (strcmp(name, "natural") == 0) return SORT_NATURAL;
+    if (strcmp(name, "date") == 0) return SORT_DATE;
+    rb_raise(rb_eArgError, "unknown sort type: %s (expected string, numeric, natural or date)", name);
+    return SORT_STRING; /* not reached */
+}
+
+/* ---------------------------------------------------------
+ * Interp#treeview_sort_column(tree_path, parent, column, opts=nil)
+ *
+ * Sort a treeview item's children by one column, in C.
+ * Values are fetched with one `set` (or `item -text`) call per row,
+ * converted to typed keys once, and sorted stably. The new order is
+ * applied with a single `children` call, so open/closed state and
+ * grandchildren are untouched.
+ *
+ * Arguments:
+ *   tree_path - Tk path of the treeview
+ *   parent    - Item whose children are sorted ("" for top level)
+ *   column    - Column id, or "#0" for the tree column text
+ *   opts      - Optional hash:
+ *               :type       - :string (default), :numeric, :natural, :date
+ *               :descending - reverse order (default false)
+ *               :items      - Array of ids to sort instead of parent's
+ *                             current children
+ *               :apply      - false to only return the order (default true)
+ *
+ * Values that do not parse as the requested type sort last.
+ *
+ * Returns Array of item ids in sorted order.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_treeview_sort_column(int argc, VALUE *argv, VALUE self)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    VALUE tree_path, parent, column, opts;
+    VALUE items = Qnil, ids = Qnil;
+    struct sort_ctx ctx;
+    struct sort_entry *entries = NULL;
+    Tcl_Obj *path, *parent_obj, *list, *sorted;
+    Tcl_Size n = 0, i;
+    int apply = 1;
+    int result = TCL_OK;
+
+    rb_scan_args(argc, argv, "31", &tree_path, &parent, &column, &opts);
+
+    StringValue(tree_path);
+    StringValue(parent);
+    StringValue(column);
+
+    ctx.type = SORT_STRING;
+    ctx.descending = 0;
+    if (!NIL_P(opts)) {
+        VALUE v;
+        Check_Type(opts, T_HASH);
+        ctx.type = sort_type_from(rb_hash_aref(opts, ID2SYM(rb_intern("type"))));
+        ctx.descending = RTEST(rb_hash_aref(opts, ID2SYM(rb_intern("descending"))));
+        items = rb_hash_aref(opts, ID2SYM(rb_intern("items")));
+        v = rb_hash_lookup2(opts, ID2SYM(rb_intern("apply")), Qtrue);
+        apply = RTEST(v);
+    }
+    check_items(items);
+
+    path = rstring_to_obj(tree_path);
+    parent_obj = rstring_to_obj(parent);
+    Tcl_IncrRefCount(path);
+    Tcl_IncrRefCount(parent_obj);
+
+    list = collect_items(tip->interp, path, parent_obj, items);
+    if (list) {
+        Tcl_ListObjLength(NULL, list, &n);
+        entries = RbTk_ALLOC_N(struct sort_entry, n > 0 ? n : 1);
+        result = fetch_column(tip->interp, path, RSTRING_PTR(column), RSTRING_LEN(column),
+                              list, entries, n);
+        Tcl_DecrRefCount(list);
+        if (result != TCL_OK) {
+            ckfree((char *)entries);
+            entries = NULL;
+        }
+    } else {
+        result = TCL_ERROR;
+    }
+
+    if (result == TCL_OK) {
+        if (ctx.type == SORT_NUMERIC) {
+            for (i = 0; i < n; i++) {
+                entries[i].missing = Tcl_GetDoubleFromObj(NULL, entries[i].value,
+                                                          &entries[i].num) != TCL_OK;
+            }
+        } else if (ctx.type == SORT_DATE) {
+            for (i = 0; i < n; i++) {
+                entries[i].missing = !parse_iso_date(entries[i].str, &entries[i].num) &&
+                                     !scan_date(tip->interp, entries[i].value, &entries[i].num);
+            }
+        }
+
+        ruby_qsort(entries, (size_t)n, sizeof(struct sort_entry), sort_entry_cmp, &ctx);
+
+        sorted = Tcl_NewListObj(0, NULL);
+        Tcl_IncrRefCount(sorted);
+        for (i = 0; i < n; i++) {
+            Tcl_ListObjAppendElement(NULL, sorted, entries[i].id);
+        }
+
+        if (apply) {
+            Tcl_Obj *objv[4];
+            objv[0] = path;
+            objv[1] = Tcl_NewStringObj("children", -1);
+            objv[2] = parent_obj;
+            objv[3] = sorted;
+            Tcl_IncrRefCount(objv[1]);
+            result = Tcl_EvalObjv(tip->interp, 4, objv, 0);
+            Tcl_DecrRefCount(objv[1]);
+        }
+
+        ids = rb_ary_new2(n);
+        if (result == TCL_OK) {
+            for (i = 0; i < n; i++) {
+                Tcl_Size len;
+                const char *id = Tcl_GetStringFromObj(entries[i].id, &len);
+                rb_ary_push(ids, rb_utf8_str_new(id, len));
+            }
+        }
+
+        Tcl_DecrRefCount(sorted);
+        release_entries(entries, n);
+    }
+
+    Tcl_DecrRefCount(path);
+    Tcl_DecrRefCount(parent_obj);
+
+    if (result != TCL_OK) {
+        rb_raise(eTclError, "treeview sort failed: %s", Tcl_GetStringResult(tip->interp));
+    }
+
+    return ids;
+}
+
+/* ---------------------------------------------------------
+ * Interp#treeview_column_values(tree_path, parent, column, items=nil)
+ *
+ * Fetch one column for many items in a single C call.
+ *
+ * Arguments:
+ *   tree_path - Tk path of the treeview
+ *   parent    - Item whose children are read ("" for top level)
+ *   column    - Column id, or "#0" for the tree column text
+ *   items     - Optional Array of ids to read instead of parent's children
+ *
+ * Returns [ids, values] - two Arrays of Strings.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_treeview_column_values(int argc, VALUE *argv, VALUE self)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    VALUE tree_path, parent, column, items;
+    VALUE ids, values;
+    struct sort_entry *entries;
+    Tcl_Obj *path, *parent_obj, *list;
+    Tcl_Size n = 0, i;
+    int result = TCL_ERROR;
+
+    rb_scan_args(argc, argv, "31", &tree_path, &parent, &column, &items);
+
+    StringValue(tree_path);
+    StringValue(parent);
+    StringValue(column);
+    check_items(items);
+
+    path = rstring_to_obj(tree_path);
+    parent_obj = rstring_to_obj(parent);
+    Tcl_IncrRefCount(path);
+    Tcl_IncrRefCount(parent_obj);
+
+    ids = rb_ary_new();
+    values = rb_ary_new();
+
+    list = collect_items(tip->interp, path, parent_obj, items);
+    if (list) {
+        Tcl_ListObjLength(NULL, list, &n);
+        entries = RbTk_ALLOC_N(struct sort_entry, n > 0 ? n : 1);
+        result = fetch_column(tip->interp, path, RSTRING_PTR(column), RSTRING_LEN(column),
+                              list, entries, n);
+        Tcl_DecrRefCount(list);
+        if (result == TCL_OK) {
+            for (i = 0; i < n; i++) {
+                Tcl_Size len;
+                const char *str = Tcl_GetStringFromObj(entries[i].id, &len);
+                rb_ary_push(ids, rb_utf8_str_new(str, len));
+                str = Tcl_GetStringFromObj(entries[i].value, &len);
+                rb_ary_push(values, rb_utf8_str_new(str, len));
+            }
+            release_entries(entries, n);
+        } else {
+            ckfree((char *)entries);
+        }
+    }
+
+    Tcl_DecrRefCount(path);
+    Tcl_DecrRefCount(parent_obj);
+
+    if (result != TCL_OK) {
+        rb_raise(eTclError, "treeview column fetch failed: %s", Tcl_GetStringResult(tip->interp));
+    }
+
+    return rb_assoc_new(ids, values);
+}
+
+/* ---------------------------------------------------------
+ * Init_tktreeview - Register treeview methods on TclTkIp class
+ *
+ * Called from Init_tcltklib in tcltkbridge.c
+ * --------------------------------------------------------- */
+
+void
+Init_tktreeview(VALUE cTclTkIp)
+{
+    rb_define_method(cTclTkIp, "treeview_insert_rows", interp_treeview_insert_rows, -1);
+    rb_define_method(cTclTkIp, "treeview_sort_column", interp_treeview_sort_column, -1);
+    rb_define_method(cTclTkIp, "treeview_column_values", interp_treeview_column_values, -1);
+}
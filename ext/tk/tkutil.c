@@ -4,6 +4,7 @@
  */
 
 #include "tcltkbridge.h"
+#include <string.h>
 
 /* ---------------------------------------------------------
  * Interp#tcl_split_list(str) - Parse Tcl list into Ruby array
@@ -178,6 +179,143 @@ interp_coords_to_window(VALUE self, VALUE root_x, VALUE root_y)
     return rb_utf8_str_new_cstr(pathName);
 }
 
+/* Properties readable by winfo_query, in the order of winfo_props[] */
+enum winfo_prop {
+    WP_WIDTH, WP_HEIGHT, WP_REQWIDTH, WP_REQHEIGHT, WP_X, WP_Y,
+    WP_ROOTX, WP_ROOTY, WP_ISMAPPED, WP_VIEWABLE, WP_EXISTS,
+    WP_DEPTH, WP_CLASS, WP_NAME, WP_COUNT
+};
+
+static const char *const winfo_props[WP_COUNT] = {
+    "width", "height", "reqwidth", "reqheight", "x", "y",
+    "rootx", "rooty", "ismapped", "viewable", "exists",
+    "depth", "class", "name"
+};
+
+static int
+winfo_viewable(Tk_Window tkwin)
+{
+    for (; tkwin != NULL; tkwin = Tk_Parent(tkwin)) {
+        if (!Tk_IsMapped(tkwin)) return 0;
+        if (Tk_IsTopLevel(tkwin)) return 1;
+    }
+    return 0;
+}
+
+static VALUE
+winfo_value(Tk_Window tkwin, int prop)
+{
+    int x, y;
+
+    switch (prop) {
+    case WP_WIDTH:     return INT2NUM(Tk_Width(tkwin));
+    case WP_HEIGHT:    return INT2NUM(Tk_Height(tkwin));
+    case WP_REQWIDTH:  return INT2NUM(Tk_ReqWidth(tkwin));
+    case WP_REQHEIGHT: return INT2NUM(Tk_ReqHeight(tkwin));
+    case WP_X:         return INT2NUM(Tk_X(tkwin));
+    case WP_Y:         return INT2NUM(Tk_Y(tkwin));
+    case WP_ROOTX:
+    case WP_ROOTY:
+        Tk_GetRootCoords(tkwin, &x, &y);
+        return INT2NUM(prop == WP_ROOTX ? x : y);
+    case WP_ISMAPPED:  return Tk_IsMapped(tkwin) ? Qtrue : Qfalse;
+    case WP_VIEWABLE:  return winfo_viewable(tkwin) ? Qtrue : Qfalse;
+    case WP_EXISTS:    return Qtrue;
+    case WP_DEPTH:     return INT2NUM(Tk_Depth(tkwin));
+    case WP_CLASS:
+        return Tk_Class(tkwin) ? rb_utf8_str_new_cstr(Tk_Class(tkwin)) : Qnil;
+    case WP_NAME:
+        return Tk_Name(tkwin) ? rb_utf8_str_new_cstr(Tk_Name(tkwin)) : Qnil;
+    }
+    return Qnil;
+}
+
+/* ---------------------------------------------------------
+ * Interp#winfo_query(paths, props)
+ *
+ * Read many winfo properties for many windows in one C call.
+ * Each window is resolved once; values come straight from Tk's
+ * accessors (Tk_Width, Tk_ReqWidth, Tk_IsMapped, ...) with no Tcl
+ * command dispatch.
+ *
+ * Arguments:
+ *   paths - Array of Tk window paths
+ *   props - Array of property names (Symbols or Strings): width,
+ *           height, reqwidth, reqheight, x, y, rootx, rooty, ismapped,
+ *           viewable, exists, depth, class, name
+ *
+ * Returns columnar Hash {prop_symbol => Array} with one entry per path.
+ * Windows that do not exist give nil (false for :exists).
+ * Raises ArgumentError for an unknown property.
+ *
+ * See: https://www.tcl-lang.org/man/tcl8.6/TkLib/WindowId.htm
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_winfo_query(VALUE self, VALUE paths, VALUE props)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    Tk_Window mainWin;
+    int prop_ids[WP_COUNT];
+    VALUE columns[WP_COUNT];
+    VALUE result;
+    long npaths, nprops, i, j;
+
+    Check_Type(paths, T_ARRAY);
+    Check_Type(props, T_ARRAY);
+    nprops = RARRAY_LEN(props);
+    if (nprops > WP_COUNT) {
+        rb_raise(rb_eArgError, "too many properties (%ld)", nprops);
+    }
+
+    mainWin = Tk_MainWindow(tip->interp);
+    if (!mainWin) {
+        rb_raise(eTclError, "Tk not initialized (no main window)");
+    }
+
+    npaths = RARRAY_LEN(paths);
+    result = rb_hash_new();
+    for (j = 0; j < nprops; j++) {
+        VALUE name = rb_ary_entry(props, j);
+        const char *cname;
+        int k;
+
+        if (SYMBOL_P(name)) name = rb_sym2str(name);
+        cname = StringValueCStr(name);
+        for (k = 0; k < WP_COUNT; k++) {
+            if (strcmp(cname, winfo_props[k]) == 0) break;
+        }
+        if (k == WP_COUNT) {
+            rb_raise(rb_eArgError, "unknown winfo property: %s", cname);
+        }
+        prop_ids[j] = k;
+        columns[j] = rb_ary_new_capa(npaths);
+        rb_hash_aset(result, ID2SYM(rb_intern(winfo_props[k])), columns[j]);
+    }
+
+    for (i = 0; i < npaths; i++) {
+        VALUE path = rb_ary_entry(paths, i);
+        Tk_Window tkwin;
+
+        if (!RB_TYPE_P(path, T_STRING)) path = rb_obj_as_string(path);
+        tkwin = Tk_NameToWindow(tip->interp, StringValueCStr(path), mainWin);
+        if (!tkwin) Tcl_ResetResult(tip->interp);
+
+        for (j = 0; j < nprops; j++) {
+            VALUE val;
+            if (tkwin) {
+                val = winfo_value(tkwin, prop_ids[j]);
+            } else {
+                val = prop_ids[j] == WP_EXISTS ? Qfalse : Qnil;
+            }
+            rb_ary_push(columns[j], val);
+        }
+    }
+
+    RB_GC_GUARD(result);
+    return result;
+}
+
 /* ---------------------------------------------------------
  * Init_tkutil - Register utility methods on TclTkIp class
  *
@@ -191,4 +329,5 @@ Init_tkutil(VALUE cTclTkIp)
     rb_define_method(cTclTkIp, "user_inactive_time", interp_user_inactive_time, 0);
     rb_define_method(cTclTkIp, "get_root_coords", interp_get_root_coords, 1);
     rb_define_method(cTclTkIp, "coords_to_window", interp_coords_to_window, 2);
+    rb_define_method(cTclTkIp, "winfo_query", interp_winfo_query, 2);
 }
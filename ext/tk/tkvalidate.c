@@ -0,0 +1,534 @@
+/* tkvalidate.c - Compiled entry/spinbox validators for tk-ng
+ *
+ * Common -validatecommand checks (integer/decimal ranges, regexp,
+ * maximum length, allowed characters) implemented as Tcl commands with
+ * a pre-parsed spec, so validating a keystroke never enters Ruby.
+ * The last result per widget is recorded for batched state queries.
+ */
+
+#include "tcltkbridge.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define VALIDATE_ASSOC_KEY "rbtk_validate"
+
+enum vtype { VT_ANY, VT_INTEGER, VT_DECIMAL };
+
+/* Pre-parsed validator spec, owned by its Tcl command */
+struct validator {
+    enum vtype type;
+    int has_min, has_max;
+    double min, max;
+    int precision;          /* max digits after '.', -1 = unlimited */
+    int allow_empty;
+    long max_length;        /* in characters, -1 = unlimited */
+    Tcl_Obj *pattern;       /* anchored regexp, or NULL */
+    Tcl_Obj *prefix;        /* same, compiled with TCL_REG_CANMATCH */
+    char *charset;          /* allowed characters (UTF-8), or NULL */
+    struct validate_state *state;
+};
+
+/* Per-interp last-result table: widget path -> result. An entry lives
+ * as long as its window: a <Destroy> handler removes it. */
+struct validate_state {
+    Tcl_HashTable results;
+    int next_id;
+};
+
+struct validate_result {
+    Tk_Window tkwin;
+    Tcl_HashEntry *entry;
+    int ok;
+};
+
+static void
+validate_window_event(ClientData clientData, XEvent *eventPtr)
+{
+    struct validate_result *res = (struct validate_result *)clientData;
+
+    if (eventPtr->type != DestroyNotify) return;
+    /* Tk removes the handler itself */
+    Tcl_DeleteHashEntry(res->entry);
+    ckfree((char *)res);
+}
+
+static void
+validate_state_free(ClientData clientData, Tcl_Interp *interp)
+{
+    struct validate_state *vs = (struct validate_state *)clientData;
+    Tcl_HashSearch search;
+    Tcl_HashEntry *entry;
+
+    for (entry = Tcl_FirstHashEntry(&vs->results, &search); entry;
+         entry = Tcl_NextHashEntry(&search)) {
+        struct validate_result *res = (struct validate_result *)Tcl_GetHashValue(entry);
+        Tk_DeleteEventHandler(res->tkwin, StructureNotifyMask,
+                              validate_window_event, (ClientData)res);
+        ckfree((char *)res);
+    }
+    Tcl_DeleteHashTable(&vs->results);
+    ckfree((char *)vs);
+}
+
+static struct validate_state *
+validate_state_get(Tcl_Interp *interp)
+{
+    struct validate_state *vs;
+
+    vs = (struct validate_state *)Tcl_GetAssocData(interp, VALIDATE_ASSOC_KEY, NULL);
+    if (vs == NULL) {
+        vs = (struct validate_state *)ckalloc(sizeof(struct validate_state));
+        Tcl_InitHashTable(&vs->results, TCL_STRING_KEYS);
+        vs->next_id = 0;
+        Tcl_SetAssocData(interp, VALIDATE_ASSOC_KEY, validate_state_free, (ClientData)vs);
+    }
+    return vs;
+}
+
+static void
+validate_record(Tcl_Interp *interp, struct validate_state *vs,
+                const char *path, int ok)
+{
+    struct validate_result *res;
+    Tcl_HashEntry *entry;
+    Tk_Window mainWin, tkwin;
+    int isNew;
+
+    entry = Tcl_FindHashEntry(&vs->results, path);
+    if (entry) {
+        res = (struct validate_result *)Tcl_GetHashValue(entry);
+        res->ok = ok;
+        return;
+    }
+
+    /* Only windows can be recorded: the entry goes with the window */
+    mainWin = Tk_MainWindow(interp);
+    tkwin = mainWin ? Tk_NameToWindow(interp, path, mainWin) : NULL;
+    if (tkwin == NULL) {
+        Tcl_ResetResult(interp);  /* Tk_NameToWindow leaves an error message */
+        return;
+    }
+    entry = Tcl_CreateHashEntry(&vs->results, path, &isNew);
+    res = (struct validate_result *)ckalloc(sizeof(struct validate_result));
+    res->tkwin = tkwin;
+    res->entry = entry;
+    res->ok = ok;
+    Tcl_SetHashValue(entry, res);
+    Tk_CreateEventHandler(tkwin, StructureNotifyMask, validate_window_event, (ClientData)res);
+}
+
+/*
+ * Numeric syntax check. In partial mode (keystroke validation) prefixes
+ * of valid numbers ("", "-", "1.") are accepted too.
+ */
+static int
+check_number(const struct validator *v, const char *s, int partial)
+{
+    const char *p = s;
+    int digits = 0, frac = 0, dot = 0;
+
+    if (*p == '-' || *p == '+') p++;
+    for (; *p; p++) {
+        if (*p >= '0' && *p <= '9') {
+            digits++;
+            if (dot) frac++;
+        } else if (*p == '.' && v->type == VT_DECIMAL && !dot) {
+            dot = 1;
+        } else {
+            return 0;
+        }
+    }
+    if (v->precision >= 0 && frac > v->precision) return 0;
+    if (digits == 0) return partial;
+    return 1;
+}
+
+/*
+ * Range check. While typing only reject values no further keystroke
+ * can bring back into range: appending digits moves a non-negative
+ * value up and a negative value down.
+ */
+static int
+check_range(const struct validator *v, const char *s, int partial)
+{
+    double d;
+    char *end;
+
+    errno = 0;
+    d = strtod(s, &end);
+    if (end == s) return partial;  /* "-" or "." while typing */
+    if (partial) {
+        if (v->has_max && d >= 0 && d > v->max) return 0;
+        if (v->has_min && d < 0 && d < v->min) return 0;
+        return 1;
+    }
+    if (errno == ERANGE) return 0;
+    if (v->has_min && d < v->min) return 0;
+    if (v->has_max && d > v->max) return 0;
+    return 1;
+}
+
+static int
+check_charset(const struct validator *v, const char *s)
+{
+    const char *p = s, *next, *c, *cnext;
+    size_t len;
+
+    while (*p) {
+        next = Tcl_UtfNext(p);
+        len = (size_t)(next - p);
+        for (c = v->charset; *c; c = cnext) {
+            cnext = Tcl_UtfNext(c);
+            if ((size_t)(cnext - c) == len && memcmp(c, p, len) == 0) break;
+        }
+        if (!*c) return 0;
+        p = next;
+    }
+    return 1;
+}
+
+/*
+ * Pattern check. While typing accept any prefix of a possible match:
+ * with TCL_REG_CANMATCH a failed match reports where a match could
+ * still start if characters were appended, and for the anchored
+ * pattern that must be 0. Each mode keeps its own Tcl_Obj so both
+ * compiled forms stay cached.
+ */
+static int
+check_pattern(Tcl_Interp *interp, const struct validator *v,
+              Tcl_Obj *valueObj, int partial)
+{
+    Tcl_RegExp re;
+    Tcl_RegExpInfo info;
+    int rc;
+
+    if (partial) {
+        re = Tcl_GetRegExpFromObj(interp, v->prefix, TCL_REG_ADVANCED | TCL_REG_CANMATCH);
+    } else {
+        re = Tcl_GetRegExpFromObj(interp, v->pattern, TCL_REG_ADVANCED);
+    }
+    rc = re ? Tcl_RegExpExecObj(interp, re, valueObj, 0, 0, 0) : -1;
+    if (rc < 0) Tcl_ResetResult(interp);
+    if (rc != 0 || !partial) return rc == 1;
+
+    Tcl_RegExpGetInfo(re, &info);
+    return info.extendStart == 0;
+}
+
+/*
+ * Wrap a pattern as ^(?:pattern)$ so it must match the whole value.
+ * A "***:" director and leading embedded options "(?opts)" have to stay
+ * in front, so they are kept ahead of the anchors; a literal pattern
+ * ("***=" or option q) becomes an ARE with every other character
+ * escaped. Returns 0 for BRE/ERE patterns (options b, e), which have
+ * no (?:...) group to wrap them in.
+ */
+static int
+anchor_pattern(Tcl_DString *out, const char *p, const char *end)
+{
+    int literal = 0, expanded = 0;
+
+    Tcl_DStringInit(out);
+    if (end - p >= 4 && strncmp(p, "***=", 4) == 0) {
+        literal = 1;
+        p += 4;
+    } else {
+        if (end - p >= 4 && strncmp(p, "***:", 4) == 0) {
+            Tcl_DStringAppend(out, p, 4);
+            p += 4;
+        }
+        if (end - p >= 2 && p[0] == '(' && p[1] == '?') {
+            const char *o = p + 2;
+
+            while (o < end && *o && strchr("bceimnpqstwx", *o)) o++;
+            if (o < end && *o == ')' && o > p + 2) {
+                const char *c;
+
+                Tcl_DStringAppend(out, "(?", 2);
+                for (c = p + 2; c < o; c++) {
+                    if (*c == 'b' || *c == 'e') {
+                        Tcl_DStringFree(out);
+                        return 0;
+                    }
+                    if (*c == 'q') {
+                        literal = 1;
+                        continue;
+                    }
+                    if (*c == 'x') expanded = 1;
+                    Tcl_DStringAppend(out, c, 1);
+                }
+                Tcl_DStringAppend(out, ")", 1);
+                p = o + 1;
+            }
+        }
+    }
+
+    Tcl_DStringAppend(out, "^(?:", 4);
+    if (literal) {
+        for (; p < end; p++) {
+            unsigned char ch = (unsigned char)*p;
+            if (!(ch >= 0x80 || (ch >= '0' && ch <= '9') ||
+                  (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z'))) {
+                Tcl_DStringAppend(out, "\\", 1);
+            }
+            Tcl_DStringAppend(out, p, 1);
+        }
+    } else {
+        Tcl_DStringAppend(out, p, (RBTK_STRLEN_TYPE)(end - p));
+    }
+    /* In expanded syntax a trailing comment would swallow ")$" */
+    if (expanded) Tcl_DStringAppend(out, "\n", 1);
+    Tcl_DStringAppend(out, ")$", 2);
+    return 1;
+}
+
+static int
+validator_check(Tcl_Interp *interp, const struct validator *v,
+                Tcl_Obj *valueObj, int partial)
+{
+    RBTK_STRLEN_TYPE len;
+    const char *s = Tcl_GetStringFromObj(valueObj, &len);
+
+    if (len == 0) return partial || v->allow_empty;
+    if (v->max_length >= 0 && Tcl_NumUtfChars(s, len) > v->max_length) return 0;
+    if (v->charset && !check_charset(v, s)) return 0;
+    if (v->type != VT_ANY) {
+        if (!check_number(v, s, partial)) return 0;
+        if ((v->has_min || v->has_max) && !check_range(v, s, partial)) return 0;
+    }
+    if (v->pattern && !check_pattern(interp, v, valueObj, partial)) return 0;
+    return 1;
+}
+
+/*
+ * Tcl command: <validator> value ?trigger? ?widget?
+ *
+ * Used as: -validatecommand {<validator> %P %V %W}
+ * Returns 1/0. With trigger "key" the value may be incomplete.
+ */
+static int
+validator_proc(ClientData clientData, Tcl_Interp *interp,
+               RBTK_OBJC_TYPE objc, Tcl_Obj *const objv[])
+{
+    struct validator *v = (struct validator *)clientData;
+    int partial, ok;
+
+    if (objc < 2 || objc > 4) {
+        Tcl_WrongNumArgs(interp, 1, objv, "value ?trigger? ?widget?");
+        return TCL_ERROR;
+    }
+    partial = objc >= 3 && strcmp(Tcl_GetString(objv[2]), "key") == 0;
+    ok = validator_check(interp, v, objv[1], partial);
+    if (objc == 4) {
+        validate_record(interp, v->state, Tcl_GetString(objv[3]), ok);
+    }
+    Tcl_SetObjResult(interp, Tcl_NewBooleanObj(ok));
+    return TCL_OK;
+}
+
+static void
+validator_delete(ClientData clientData)
+{
+    struct validator *v = (struct validator *)clientData;
+    if (v->pattern) Tcl_DecrRefCount(v->pattern);
+    if (v->prefix) Tcl_DecrRefCount(v->prefix);
+    if (v->charset) ckfree(v->charset);
+    ckfree((char *)v);
+}
+
+static VALUE
+opt_get(VALUE opts, const char *name)
+{
+    return rb_hash_aref(opts, ID2SYM(rb_intern(name)));
+}
+
+/* ---------------------------------------------------------
+ * Interp#validator_create(opts) - Create a compiled validator command
+ *
+ * Arguments:
+ *   opts - Hash with any of:
+ *          :type        - "integer" or "decimal" (nil: no numeric check)
+ *          :min, :max   - inclusive numeric range
+ *          :precision   - max digits after the decimal point
+ *          :pattern     - Tcl regexp (ARE) the whole value must match;
+ *                         "***=", "***:" and leading embedded options
+ *                         are honored
+ *          :max_length  - max length in characters
+ *          :charset     - String of allowed characters
+ *          :allow_empty - accept "" on focusout/forced (default true)
+ *
+ * Returns the Tcl command name. Use it as
+ *   -validatecommand {<name> %P %V %W}
+ * Partial input is accepted while typing (trigger "key"): numeric
+ * prefixes, and for :pattern any prefix of a possible match. Ranges
+ * and completeness are enforced on focusout and forced validation.
+ * Raises TclError for an invalid pattern.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_validator_create(VALUE self, VALUE opts)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    struct validate_state *vs;
+    struct validator *v;
+    VALUE val;
+    char name[64];
+
+    Check_Type(opts, T_HASH);
+    vs = validate_state_get(tip->interp);
+
+    v = (struct validator *)ckalloc(sizeof(struct validator));
+    memset(v, 0, sizeof(struct validator));
+    v->type = VT_ANY;
+    v->precision = -1;
+    v->max_length = -1;
+    v->allow_empty = 1;
+    v->state = vs;
+
+    val = opt_get(opts, "type");
+    if (!NIL_P(val)) {
+        const char *t;
+        val = rb_obj_as_string(val);
+        t = StringValueCStr(val);
+        if (strcmp(t, "integer") == 0) v->type = VT_INTEGER;
+        else if (strcmp(t, "decimal") == 0) v->type = VT_DECIMAL;
+        else {
+            ckfree((char *)v);
+            rb_raise(rb_eArgError, "unknown validator type: %s (integer or decimal)", t);
+        }
+    }
+    if (!NIL_P(val = opt_get(opts, "min"))) { v->has_min = 1; v->min = NUM2DBL(val); }
+    if (!NIL_P(val = opt_get(opts, "max"))) { v->has_max = 1; v->max = NUM2DBL(val); }
+    if (!NIL_P(val = opt_get(opts, "precision"))) v->precision = NUM2INT(val);
+    if (!NIL_P(val = opt_get(opts, "max_length"))) v->max_length = NUM2LONG(val);
+    val = opt_get(opts, "allow_empty");
+    if (val == Qfalse) v->allow_empty = 0;
+
+    val = opt_get(opts, "charset");
+    if (!NIL_P(val)) {
+        StringValue(val);
+        v->charset = ckalloc((unsigned)RSTRING_LEN(val) + 1);
+        memcpy(v->charset, RSTRING_PTR(val), (size_t)RSTRING_LEN(val));
+        v->charset[RSTRING_LEN(val)] = '\0';
+    }
+
+    val = opt_get(opts, "pattern");
+    if (!NIL_P(val)) {
+        Tcl_Obj *raw;
+        Tcl_DString anchored;
+        int ok;
+
+        StringValue(val);
+        /* Compile now: bad patterns fail here, not on the first keystroke */
+        raw = Tcl_NewStringObj(RSTRING_PTR(val), (RBTK_STRLEN_TYPE)RSTRING_LEN(val));
+        Tcl_IncrRefCount(raw);
+        ok = Tcl_GetRegExpFromObj(tip->interp, raw, TCL_REG_ADVANCED) != NULL;
+        Tcl_DecrRefCount(raw);
+        if (!ok) {
+            VALUE msg = rb_utf8_str_new_cstr(Tcl_GetStringResult(tip->interp));
+            Tcl_ResetResult(tip->interp);
+            validator_delete((ClientData)v);
+            rb_raise(eTclError, "%"PRIsVALUE, msg);
+        }
+        if (!anchor_pattern(&anchored, RSTRING_PTR(val), RSTRING_END(val))) {
+            validator_delete((ClientData)v);
+            rb_raise(rb_eArgError, "pattern must be an ARE (embedded options b and e are not supported)");
+        }
+        v->pattern = Tcl_NewStringObj(Tcl_DStringValue(&anchored), Tcl_DStringLength(&anchored));
+        Tcl_DStringFree(&anchored);
+        v->prefix = Tcl_DuplicateObj(v->pattern);
+        Tcl_IncrRefCount(v->pattern);
+        Tcl_IncrRefCount(v->prefix);
+    }
+
+    snprintf(name, sizeof(name), "::tk::rbValidate%d", ++vs->next_id);
+    Tcl_CreateObjCommand(tip->interp, name, validator_proc, (ClientData)v,
+                         validator_delete);
+
+    return rb_utf8_str_new_cstr(name);
+}
+
+/* ---------------------------------------------------------
+ * Interp#validation_states(paths, revalidate=false)
+ *
+ * Batched validity query for many entry/spinbox widgets in one call.
+ *
+ * Arguments:
+ *   paths      - Array of widget paths
+ *   revalidate - true: run "$path validate" on each widget and report
+ *                its result (forced validation; no Ruby calls for
+ *                compiled validators); false: report the last result
+ *                recorded by a compiled validator
+ *
+ * Returns Array of true/false; without revalidate, nil for widgets a
+ * compiled validator has not checked yet.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_validation_states(int argc, VALUE *argv, VALUE self)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    struct validate_state *vs;
+    VALUE paths, revalidate, result;
+    long i, n;
+
+    rb_scan_args(argc, argv, "11", &paths, &revalidate);
+    Check_Type(paths, T_ARRAY);
+    vs = validate_state_get(tip->interp);
+    n = RARRAY_LEN(paths);
+    result = rb_ary_new_capa(n);
+
+    for (i = 0; i < n; i++) {
+        VALUE path = rb_ary_entry(paths, i);
+        const char *cpath;
+        Tcl_HashEntry *entry;
+        struct validate_result *res;
+
+        if (!RB_TYPE_P(path, T_STRING)) path = rb_obj_as_string(path);
+        cpath = StringValueCStr(path);
+
+        if (RTEST(revalidate)) {
+            Tcl_Obj *cmd[2];
+            int rc, ok;
+
+            cmd[0] = Tcl_NewStringObj(cpath, -1);
+            cmd[1] = Tcl_NewStringObj("validate", -1);
+            Tcl_IncrRefCount(cmd[0]);
+            Tcl_IncrRefCount(cmd[1]);
+            rc = Tcl_EvalObjv(tip->interp, 2, cmd, 0);
+            Tcl_DecrRefCount(cmd[0]);
+            Tcl_DecrRefCount(cmd[1]);
+            if (rc != TCL_OK ||
+                Tcl_GetBooleanFromObj(tip->interp, Tcl_GetObjResult(tip->interp), &ok) != TCL_OK) {
+                rb_raise(eTclError, "%s", Tcl_GetStringResult(tip->interp));
+            }
+            rb_ary_push(result, ok ? Qtrue : Qfalse);
+            continue;
+        }
+
+        entry = Tcl_FindHashEntry(&vs->results, cpath);
+        if (entry == NULL) {
+            rb_ary_push(result, Qnil);
+            continue;
+        }
+        res = (struct validate_result *)Tcl_GetHashValue(entry);
+        rb_ary_push(result, res->ok ? Qtrue : Qfalse);
+    }
+
+    return result;
+}
+
+/* ---------------------------------------------------------
+ * Init_tkvalidate - Register validator methods on TclTkIp class
+ *
+ * Called from Init_tcltklib in tcltkbridge.c
+ * --------------------------------------------------------- */
+
+void
+Init_tkvalidate(VALUE cTclTkIp)
+{
+    rb_define_method(cTclTkIp, "validator_create", interp_validator_create, 1);
+    rb_define_method(cTclTkIp, "validation_states", interp_validation_states, -1);
+}
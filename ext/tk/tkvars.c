@@ -0,0 +1,434 @@
+/* tkvars.c - Bulk Tcl variable and array access for tk-ng
+ *
+ * Reads and writes many variables in one bridge call using
+ * Tcl_ObjGetVar2/Tcl_ObjSetVar2 on length-counted objects, so values
+ * may contain any bytes. Names are resolved from the global namespace;
+ * qualified names ("::ns::v") and element names ("arr(key)") work.
+ *
+ * Bulk writes can run "quiet": Tcl-level traces (trace add variable)
+ * on the written variables are lifted for the load and each write
+ * trace is then called once with an empty element name. Tk's own C
+ * traces (-textvariable and friends) are not affected and keep widgets
+ * in sync.
+ */
+
+#include "tcltkbridge.h"
+#include <string.h>
+
+#define VAR_FLAGS (TCL_GLOBAL_ONLY | TCL_LEAVE_ERR_MSG)
+
+static VALUE
+var_string(VALUE val)
+{
+    if (NIL_P(val)) return rb_str_new_cstr("");
+    if (RB_TYPE_P(val, T_STRING)) return val;
+    return rb_obj_as_string(val);
+}
+
+static Tcl_Obj *
+rstring_to_obj(VALUE str)
+{
+    return Tcl_NewStringObj(RSTRING_PTR(str), (RBTK_STRLEN_TYPE)RSTRING_LEN(str));
+}
+
+static VALUE
+obj_to_rstring(Tcl_Obj *obj)
+{
+    Tcl_Size len;
+    const char *s = Tcl_GetStringFromObj(obj, &len);
+    return rb_utf8_str_new(s, (long)len);
+}
+
+static int
+quiet_option(VALUE opts)
+{
+    if (NIL_P(opts)) return 0;
+    Check_Type(opts, T_HASH);
+    return RTEST(rb_hash_aref(opts, ID2SYM(rb_intern("quiet"))));
+}
+
+/* Evaluate words as one command, without reparsing */
+static int
+eval_words(Tcl_Interp *interp, int n, Tcl_Obj *words[])
+{
+    Tcl_Obj *cmd = Tcl_NewListObj(n, words);
+    int rc;
+
+    Tcl_IncrRefCount(cmd);
+    rc = Tcl_EvalObjEx(interp, cmd, TCL_EVAL_GLOBAL | TCL_EVAL_DIRECT);
+    Tcl_DecrRefCount(cmd);
+    return rc;
+}
+
+/* ---------------------------------------------------------
+ * Quiet loads: lift Tcl-level traces, restore, notify once
+ * --------------------------------------------------------- */
+
+struct lifted_traces {
+    Tcl_Obj *name;      /* variable name (array name for elements) */
+    Tcl_Obj *info;      /* `trace info variable name`: {{ops cmd} ...} */
+};
+
+/* Variable part of an element name: "arr(key)" -> "arr" */
+static Tcl_Obj *
+base_name(VALUE name)
+{
+    const char *s = RSTRING_PTR(name);
+    long len = RSTRING_LEN(name);
+    const char *paren = len > 0 && s[len - 1] == ')' ? memchr(s, '(', (size_t)len) : NULL;
+
+    return Tcl_NewStringObj(s, (RBTK_STRLEN_TYPE)(paren ? paren - s : len));
+}
+
+/* trace <sub> variable name ?ops cmd? - name, ops and cmd are held by the caller */
+static int
+trace_eval(Tcl_Interp *interp, const char *sub, Tcl_Obj *name, Tcl_Obj *ops, Tcl_Obj *cmd)
+{
+    Tcl_Obj *words[6];
+
+    words[0] = Tcl_NewStringObj("trace", -1);
+    words[1] = Tcl_NewStringObj(sub, -1);
+    words[2] = Tcl_NewStringObj("variable", -1);
+    words[3] = name;
+    words[4] = ops;
+    words[5] = cmd;
+    return eval_words(interp, ops ? 6 : 4, words);
+}
+
+static void
+traces_lift(Tcl_Interp *interp, struct lifted_traces *lt)
+{
+    Tcl_Obj **pairs, **pair;
+    Tcl_Size npairs, n, i;
+
+    lt->info = NULL;
+    if (trace_eval(interp, "info", lt->name, NULL, NULL) != TCL_OK) return;
+
+    lt->info = Tcl_GetObjResult(interp);
+    Tcl_IncrRefCount(lt->info);
+    if (Tcl_ListObjGetElements(NULL, lt->info, &npairs, &pairs) != TCL_OK) {
+        npairs = 0;
+    }
+    for (i = 0; i < npairs; i++) {
+        if (Tcl_ListObjGetElements(NULL, pairs[i], &n, &pair) != TCL_OK || n != 2) continue;
+        trace_eval(interp, "remove", lt->name, pair[0], pair[1]);
+    }
+    Tcl_ResetResult(interp);
+}
+
+/* Re-add in reverse (trace info lists newest first) and call write traces */
+static int
+traces_restore(Tcl_Interp *interp, struct lifted_traces *lt, int notify)
+{
+    Tcl_Obj **pairs, **pair, **ops;
+    Tcl_Size npairs, n, nops, i, j;
+    int rc = TCL_OK;
+
+    if (lt->info == NULL) return TCL_OK;
+    if (Tcl_ListObjGetElements(NULL, lt->info, &npairs, &pairs) != TCL_OK) {
+        npairs = 0;
+    }
+
+    for (i = npairs - 1; i >= 0; i--) {
+        if (Tcl_ListObjGetElements(NULL, pairs[i], &n, &pair) != TCL_OK || n != 2) continue;
+        trace_eval(interp, "add", lt->name, pair[0], pair[1]);
+    }
+    Tcl_ResetResult(interp);
+
+    /* One "write" per trace, as Tcl calls it: cmd name1 name2 op */
+    for (i = npairs - 1; notify && rc == TCL_OK && i >= 0; i--) {
+        Tcl_Obj *call;
+
+        if (Tcl_ListObjGetElements(NULL, pairs[i], &n, &pair) != TCL_OK || n != 2) continue;
+        if (Tcl_ListObjGetElements(NULL, pair[0], &nops, &ops) != TCL_OK) continue;
+        for (j = 0; j < nops; j++) {
+            if (strcmp(Tcl_GetString(ops[j]), "write") == 0) break;
+        }
+        if (j == nops) continue;
+
+        call = Tcl_DuplicateObj(pair[1]);
+        Tcl_IncrRefCount(call);
+        Tcl_ListObjAppendElement(NULL, call, lt->name);
+        Tcl_ListObjAppendElement(NULL, call, Tcl_NewObj());
+        Tcl_ListObjAppendElement(NULL, call, Tcl_NewStringObj("write", -1));
+        rc = Tcl_EvalObjEx(interp, call, TCL_EVAL_GLOBAL);
+        Tcl_DecrRefCount(call);
+    }
+
+    Tcl_DecrRefCount(lt->info);
+    lt->info = NULL;
+    return rc;
+}
+
+/*
+ * Write nvals name/value pairs (held Tcl_Obj references, released here).
+ * part1 is the array name for tcl_array_set, NULL for tcl_set_vars.
+ * Lifted traces are always restored before returning. Returns a Ruby
+ * error message String, or Qnil on success.
+ */
+static VALUE
+write_vars(Tcl_Interp *interp, Tcl_Obj *part1, Tcl_Obj **names, Tcl_Obj **vals,
+           long nvals, struct lifted_traces *lifted, long nlifted)
+{
+    VALUE err = Qnil;
+    long i;
+
+    for (i = 0; i < nlifted; i++) traces_lift(interp, &lifted[i]);
+
+    for (i = 0; i < nvals; i++) {
+        Tcl_Obj *res = part1
+            ? Tcl_ObjSetVar2(interp, part1, names[i], vals[i], VAR_FLAGS)
+            : Tcl_ObjSetVar2(interp, names[i], NULL, vals[i], VAR_FLAGS);
+        if (res == NULL) {
+            err = rb_utf8_str_new_cstr(Tcl_GetStringResult(interp));
+            break;
+        }
+    }
+
+    for (i = 0; i < nlifted; i++) {
+        if (traces_restore(interp, &lifted[i], NIL_P(err)) != TCL_OK && NIL_P(err)) {
+            err = rb_utf8_str_new_cstr(Tcl_GetStringResult(interp));
+        }
+        Tcl_DecrRefCount(lifted[i].name);
+    }
+    for (i = 0; i < nvals; i++) {
+        Tcl_DecrRefCount(names[i]);
+        Tcl_DecrRefCount(vals[i]);
+    }
+    return err;
+}
+
+static int
+collect_pair(VALUE key, VALUE val, VALUE pairs)
+{
+    rb_ary_push(pairs, var_string(key));
+    rb_ary_push(pairs, var_string(val));
+    return ST_CONTINUE;
+}
+
+/* Flat [name, value, ...] Array of Strings; converts before any Tcl work */
+static VALUE
+hash_pairs(VALUE hash)
+{
+    VALUE pairs;
+
+    Check_Type(hash, T_HASH);
+    pairs = rb_ary_new_capa(RHASH_SIZE(hash) * 2);
+    rb_hash_foreach(hash, collect_pair, pairs);
+    return pairs;
+}
+
+/* ---------------------------------------------------------
+ * Interp#tcl_get_vars(names) - Read many variables at once
+ *
+ * Arguments:
+ *   names - Array of variable names (scalars, "arr(key)", "::ns::v")
+ *
+ * Returns Hash {name => value}; value is nil for unset variables.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_tcl_get_vars(VALUE self, VALUE names)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    VALUE result = rb_hash_new();
+    long i;
+
+    Check_Type(names, T_ARRAY);
+    for (i = 0; i < RARRAY_LEN(names); i++) {
+        VALUE name = rb_ary_entry(names, i);
+        Tcl_Obj *name_obj = rstring_to_obj(var_string(name));
+        Tcl_Obj *val;
+
+        Tcl_IncrRefCount(name_obj);
+        val = Tcl_ObjGetVar2(tip->interp, name_obj, NULL, TCL_GLOBAL_ONLY);
+        rb_hash_aset(result, name, val ? obj_to_rstring(val) : Qnil);
+        Tcl_DecrRefCount(name_obj);
+    }
+    return result;
+}
+
+/* ---------------------------------------------------------
+ * Interp#tcl_set_vars(hash, opts = {}) - Write many variables at once
+ *
+ * Arguments:
+ *   hash - {name => value}; nil values are written as ""
+ *   opts - quiet: true lifts Tcl-level traces on the written variables
+ *          during the load, then calls each write trace once
+ *
+ * Stops at the first failing write and raises TclError.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_tcl_set_vars(int argc, VALUE *argv, VALUE self)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    VALUE hash, opts, pairs, err, buf, lbuf = 0;
+    Tcl_Obj **names, **vals;
+    struct lifted_traces *lifted = NULL;
+    long n, nlifted = 0, i;
+
+    rb_scan_args(argc, argv, "11", &hash, &opts);
+    pairs = hash_pairs(hash);
+    n = RARRAY_LEN(pairs) / 2;
+
+    /* Large loads go to the heap, not the C stack */
+    names = ALLOCV_N(Tcl_Obj *, buf, (n > 0 ? n : 1) * 2);
+    vals = names + (n > 0 ? n : 1);
+
+    if (quiet_option(opts)) {
+        Tcl_HashTable seen;
+        int isNew;
+
+        lifted = ALLOCV_N(struct lifted_traces, lbuf, n > 0 ? n : 1);
+        Tcl_InitHashTable(&seen, TCL_STRING_KEYS);
+        for (i = 0; i < n; i++) {
+            Tcl_Obj *base = base_name(RARRAY_AREF(pairs, i * 2));
+            Tcl_IncrRefCount(base);
+            Tcl_CreateHashEntry(&seen, Tcl_GetString(base), &isNew);
+            if (isNew) {
+                lifted[nlifted++].name = base;
+            } else {
+                Tcl_DecrRefCount(base);
+            }
+        }
+        Tcl_DeleteHashTable(&seen);
+    }
+
+    for (i = 0; i < n; i++) {
+        names[i] = rstring_to_obj(RARRAY_AREF(pairs, i * 2));
+        vals[i] = rstring_to_obj(RARRAY_AREF(pairs, i * 2 + 1));
+        Tcl_IncrRefCount(names[i]);
+        Tcl_IncrRefCount(vals[i]);
+    }
+
+    err = write_vars(tip->interp, NULL, names, vals, n, lifted, nlifted);
+    ALLOCV_END(buf);
+    if (lbuf) ALLOCV_END(lbuf);
+    RB_GC_GUARD(pairs);
+    if (!NIL_P(err)) {
+        rb_raise(eTclError, "%s", StringValueCStr(err));
+    }
+    return hash;
+}
+
+/* ---------------------------------------------------------
+ * Interp#tcl_array_get(name) - Read a whole Tcl array
+ *
+ * Returns Hash {key => value}; empty if name is not an array.
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_tcl_array_get(VALUE self, VALUE name)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    Tcl_Obj *words[3];
+    Tcl_Obj **elems;
+    Tcl_Obj *list;
+    Tcl_Size n, i;
+    VALUE result = rb_hash_new();
+
+    words[0] = Tcl_NewStringObj("array", -1);
+    words[1] = Tcl_NewStringObj("get", -1);
+    words[2] = rstring_to_obj(var_string(name));
+    if (eval_words(tip->interp, 3, words) != TCL_OK) {
+        rb_raise(eTclError, "%s", Tcl_GetStringResult(tip->interp));
+    }
+
+    list = Tcl_GetObjResult(tip->interp);
+    Tcl_IncrRefCount(list);
+    if (Tcl_ListObjGetElements(tip->interp, list, &n, &elems) != TCL_OK) {
+        Tcl_DecrRefCount(list);
+        rb_raise(eTclError, "%s", Tcl_GetStringResult(tip->interp));
+    }
+    for (i = 0; i + 1 < n; i += 2) {
+        rb_hash_aset(result, obj_to_rstring(elems[i]), obj_to_rstring(elems[i + 1]));
+    }
+    Tcl_DecrRefCount(list);
+    return result;
+}
+
+/* ---------------------------------------------------------
+ * Interp#tcl_array_set(name, hash, opts = {}) - Write many array elements
+ *
+ * Arguments:
+ *   name - Tcl array name (created if needed)
+ *   hash - {key => value}; nil values are written as ""
+ *   opts - quiet: true lifts Tcl-level traces on the array during the
+ *          load, then calls each write trace once with an empty key.
+ *          Traces set on single elements still fire per element.
+ *
+ * Existing elements not in hash are kept, like "array set".
+ * --------------------------------------------------------- */
+
+static VALUE
+interp_tcl_array_set(int argc, VALUE *argv, VALUE self)
+{
+    struct tcltk_interp *tip = get_interp(self);
+    VALUE name, hash, opts, pairs, err, buf;
+    Tcl_Obj **keys, **vals;
+    Tcl_Obj *part1;
+    struct lifted_traces lifted;
+    long n, i;
+    int quiet;
+
+    rb_scan_args(argc, argv, "21", &name, &hash, &opts);
+    name = var_string(name);
+    pairs = hash_pairs(hash);
+    quiet = quiet_option(opts);
+    n = RARRAY_LEN(pairs) / 2;
+
+    /* An empty hash still creates the array, like "array set a {}" */
+    if (n == 0) {
+        Tcl_Obj *words[4];
+        words[0] = Tcl_NewStringObj("array", -1);
+        words[1] = Tcl_NewStringObj("set", -1);
+        words[2] = rstring_to_obj(name);
+        words[3] = Tcl_NewObj();
+        if (eval_words(tip->interp, 4, words) != TCL_OK) {
+            rb_raise(eTclError, "%s", Tcl_GetStringResult(tip->interp));
+        }
+        return hash;
+    }
+
+    keys = ALLOCV_N(Tcl_Obj *, buf, n * 2);
+    vals = keys + n;
+
+    part1 = rstring_to_obj(name);
+    Tcl_IncrRefCount(part1);
+    if (quiet) {
+        lifted.name = part1;
+        Tcl_IncrRefCount(part1);    /* released by write_vars */
+    }
+
+    for (i = 0; i < n; i++) {
+        keys[i] = rstring_to_obj(RARRAY_AREF(pairs, i * 2));
+        vals[i] = rstring_to_obj(RARRAY_AREF(pairs, i * 2 + 1));
+        Tcl_IncrRefCount(keys[i]);
+        Tcl_IncrRefCount(vals[i]);
+    }
+
+    err = write_vars(tip->interp, part1, keys, vals, n, &lifted, quiet ? 1 : 0);
+    Tcl_DecrRefCount(part1);
+    ALLOCV_END(buf);
+    RB_GC_GUARD(pairs);
+    if (!NIL_P(err)) {
+        rb_raise(eTclError, "%s", StringValueCStr(err));
+    }
+    return hash;
+}
+
+/* ---------------------------------------------------------
+ * Init_tkvars - Register bulk variable methods on TclTkIp class
+ *
+ * Called from Init_tcltklib in tcltkbridge.c
+ * --------------------------------------------------------- */
+
+void
+Init_tkvars(VALUE cTclTkIp)
+{
+    rb_define_method(cTclTkIp, "tcl_get_vars", interp_tcl_get_vars, 1);
+    rb_define_method(cTclTkIp, "tcl_set_vars", interp_tcl_set_vars, -1);
+    rb_define_method(cTclTkIp, "tcl_array_get", interp_tcl_array_get, 1);
+    rb_define_method(cTclTkIp, "tcl_array_set", interp_tcl_array_set, -1);
+}
@@ -42,7 +42,27 @@ class TclTkIp
   #   tcl_invoke(*args)          - Call Tcl command with args (no substitution)
   #   tcl_get_var(name)          - Get variable value
   #   tcl_set_var(name, value)   - Set variable value
+  #   tcl_get_vars(names)        - Get many variables (tkvars.c)
+  #   tcl_set_vars(hash)         - Set many variables (tkvars.c)
+  #   tcl_array_get(name)        - Whole array as a Hash (tkvars.c)
+  #   tcl_array_set(name, hash)  - Set many array elements (tkvars.c)
   #   tcl_split_list(str)        - Parse Tcl list into Ruby array
+  #   snapshot                   - Record state for reset (tkreset.c)
+  #   reset                      - Return to the snapshot (tkreset.c)
+  #   stats                      - Per-interpreter callback/queue counters
+  #   in_callback?               - Inside a callback of this interpreter
+  #   create_sandbox(name, opts) - Resource-limited safe child (tksandbox.c)
+  #   sandbox_eval(script)       - Eval within the sandbox budgets
+  #   sandbox_expose(name, tgt)  - Add a host alias to a sandbox
+  #   sandbox_stats              - Sandbox eval/limit counters
+  #   ns_invoke(ns, *args)       - Invoke a command in a namespace (tknamespace.c)
+  #   event_generate_many(evs)   - Generate many events at once (tkevents.c)
+  #   scroll_link(w, bar, axis)  - Link widget and scrollbar in Tcl (tkscroll.c)
+  #   scroll_group(paths, axis)  - Scroll widgets in lockstep (tkscroll.c)
+  #   recolor_tree(path, colors) - Recolor a window tree natively (tkrecolor.c)
+  #   ttk_restyle(styles)        - Apply many ttk style settings at once
+  #   menu_add_entries(m, ents)  - Add many menu entries at once (tkmenu.c)
+  #   ttk_style_options(style)   - Resolve all of a ttk style's options (tkstyle.c)
   #
   # The underscore-prefixed methods below are LEGACY compatibility
   # for tk.rb internals. New code should use the methods above.
@@ -362,6 +382,38 @@ module TkcTagCompat
   end
 end
 
+# ---------------------------------------------------------
+# Treeview Item/Tag compat modules for deprecation warnings
+# ItemID_TBL and TagID_TBL were global mutex-guarded tables keyed by
+# treeview path. Wrappers now live on the treeview itself.
+# Usage: extend in tkextlib/tile/treeview.rb after classes are defined
+# ---------------------------------------------------------
+module TkTreeviewItemCompat
+  def const_missing(name)
+    if name == :ItemID_TBL
+      Tk::Warnings.warn_once(:treeview_item_id_tbl_removed,
+        "Tk::Tile::Treeview::Item::ItemID_TBL has been removed (grew with item churn). " \
+        "Use Tk::Tile::Treeview::Item.id2obj(tree, id) or tree.itemid2obj(id) instead.")
+      nil
+    else
+      super
+    end
+  end
+end
+
+module TkTreeviewTagCompat
+  def const_missing(name)
+    if name == :TagID_TBL
+      Tk::Warnings.warn_once(:treeview_tag_id_tbl_removed,
+        "Tk::Tile::Treeview::Tag::TagID_TBL has been removed (grew with tag churn). " \
+        "Use Tk::Tile::Treeview::Tag.id2obj(tree, id) or tree.tagid2obj(id) instead.")
+      nil
+    else
+      super
+    end
+  end
+end
+
 # ---------------------------------------------------------
 # TkOptionDB proc class methods - REMOVED
 #
@@ -480,6 +480,20 @@ module Tk
     TkPlace.forget(*args)
   end
 
+  # Run a block when windows change size, with the <Configure> storm of
+  # an interactive resize coalesced below the bind layer.
+  #
+  #   Tk.on_resize(canvas) { |w, h| relayout(w, h) }             # once per frame
+  #   Tk.on_resize(panel, debounce: 150) { |w, h| reflow(w) }   # after 150ms quiet
+  #   Tk.on_resize(cells, batch: true) { |sizes| grid_layout(sizes) }
+  #
+  # With several windows and no +batch+, the block gets (window, w, h);
+  # with +batch+, one Hash {window => [w, h]} of everything that changed.
+  # Returns a Tk::ResizeWatch; call #cancel to stop.
+  def Tk.on_resize(wins, debounce: :frame, batch: false, &block)
+    Tk::ResizeWatch.new(wins, debounce: debounce, batch: batch, &block)
+  end
+
   # Process all pending events (user input, timers, redraws, idle tasks).
   # Blocks until the event queue is empty. Pass true for idle-only.
   # See: https://www.tcl-lang.org/man/tcl8.6/TclCmd/update.htm
@@ -85,6 +85,10 @@ module Tk
 
   autoload :OptionObj,        'tk/optionobj'
 
+  autoload :ResizeWatch,      'tk/resize_watch'
+
+  autoload :ScrollGroup,      'tk/scroll_group'
+
   autoload :X_Scrollable,     'tk/scrollable'
   autoload :Y_Scrollable,     'tk/scrollable'
   autoload :Scrollable,       'tk/scrollable'
@@ -3,6 +3,8 @@ require 'tk/canvastag'
 require 'tk/scrollable'
 require 'tk/option_dsl'
 require 'tk/item_option_dsl'
+require 'tk/item_registry'
+require 'tk/canvas_tag_index'
 
 # @!visibility private
 module TkCanvasItemConfig
@@ -52,6 +54,7 @@ end
 class Tk::Canvas<TkWindow
   include TkCanvasItemConfig
   include Tk::Scrollable
+  include Tk::CanvasTagIndex
   include Tk::Generated::Canvas
   include Tk::Generated::CanvasItems
   # @generated:options:start
@@ -136,6 +139,12 @@ class Tk::Canvas<TkWindow
     @canvas_tags[id] || id
   end
 
+  # Sizes of this canvas's item and tag registries.
+  # @return [Hash{Symbol=>Hash}] e.g. {items: {count: 40, bytes: 7680}, tags: {...}}
+  def registry_report
+    Tk::ItemRegistry.report(items: @items, tags: @canvas_tags)
+  end
+
   #def create_self(keys)
   #  if keys and keys != None
   #    tk_call_without_enc('canvas', @path, *hash_kv(keys, true))
@@ -193,6 +202,7 @@ class Tk::Canvas<TkWindow
       args[0] = tagid(args[0])
     end
     tk_send_without_enc('addtag', tagid(tag), mode, *args)
+    _tag_index_addtag(tag, mode, args[0])
     self
   end
 
@@ -422,12 +432,18 @@ class Tk::Canvas<TkWindow
   #   canvas.delete('temporary', 'markers')
   #   canvas.delete('all')  # delete everything
   def delete(*args)
-    args.each{|tag|
-      find('withtag', tag).each{|item|
-        @items.delete(item.id) if item.respond_to?(:id)
-      }
+    indexed = args.map{|tag| _tag_index_ids(tag) } if _tag_index_sync
+    args.each_with_index{|tag, i|
+      if indexed && indexed[i]
+        indexed[i].each{|id| @items.delete(id) }
+      else
+        find('withtag', tag).each{|item|
+          @items.delete(item.id) if item.respond_to?(:id)
+        }
+      end
     }
     tk_send_without_enc('delete', *args.collect{|t| tagid(t)})
+    _tag_index_deleted(indexed) if indexed
     self
   end
   alias remove delete
@@ -445,6 +461,7 @@ class Tk::Canvas<TkWindow
   #   canvas.dtag('temporary')  # remove 'temporary' tag from items that have it
   def dtag(tag, tag_to_del=None)
     tk_send_without_enc('dtag', tagid(tag), tagid(tag_to_del))
+    _tag_index_dtag(tag, tag_to_del)
     self
   end
   alias deltag dtag
@@ -971,6 +988,9 @@ class TkcItem<TkObject
     args = _parse_create_args(args)
     idnum = tk_call_without_enc(canvas.path, 'create',
                                 self::CItemTypeName, *args)
+    if canvas.respond_to?(:_tag_index_created)
+      canvas._tag_index_created(idnum.to_i, args)
+    end
     idnum.to_i  # 'canvas item id' is an integer number
   end
   ########################################
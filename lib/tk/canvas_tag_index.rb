@@ -0,0 +1,237 @@
+# frozen_string_literal: true
+
+module Tk
+  # Optional Ruby-side index of canvas tags, mixed into {Tk::Canvas}.
+  #
+  # When enabled, the canvas wrapper keeps tag => items and item => tags
+  # maps up to date as items are created, tagged, untagged and deleted
+  # through Ruby, so membership queries never touch Tcl:
+  #
+  #   canvas.enable_tag_index
+  #   canvas.items_with_tag('node')      # O(k), no Tcl call
+  #   canvas.tag?(item, 'selected')      # O(1)
+  #   canvas.item_tags(item)             # no gettags round trip
+  #
+  # Tag changes made behind the wrapper's back (raw Tcl, bindings that
+  # call the widget command directly, geometric addtag modes, tag
+  # expressions) are detected through a Tcl execution trace that bumps a
+  # per-canvas generation counter; the next query then rebuilds the
+  # index with one Tcl call.
+  #
+  # Indexed queries return items in creation order, not stacking order,
+  # and never report the dynamic "current" tag. Queries the index cannot
+  # answer ("current", tag expressions) fall back to Tcl.
+  module CanvasTagIndex
+    # Counts tag-changing canvas subcommands per widget path
+    TRACE_PROC = <<~'TCL'
+      proc ::tk::rbCanvasTagTrace {cmd op} {
+          switch -glob -- [lindex $cmd 1] {
+              ad* - dt* - de* - cr* {}
+              itemco* {
+                  if {[lsearch -glob [lrange $cmd 3 end] -tag*] < 0} return
+              }
+              default return
+          }
+          incr ::tk::rbCanvasGen([lindex $cmd 0])
+      }
+    TCL
+
+    # Item ids with their tags, in creation order
+    DUMP_LAMBDA = '{c} {set r {}; foreach i [$c find all] {lappend r $i [$c gettags $i]}; return $r}'
+
+    # Turn on the tag index.
+    # @param check [Boolean] verify every indexed answer against Tcl and
+    #   raise on mismatch (for tests)
+    # @return [self]
+    def enable_tag_index(check: false)
+      @tag_index_check = check
+      return self if @tag_index
+
+      unless TkCore::INTERP.tcl_get_var('::tk::rbCanvasTagTraceLoaded')
+        tk_call_without_enc('namespace', 'eval', '::tk', TRACE_PROC)
+        TkCore::INTERP.tcl_set_var('::tk::rbCanvasTagTraceLoaded', '1')
+      end
+      tk_call_without_enc('set', _tag_index_var, 0)
+      tk_call_without_enc('trace', 'add', 'execution', @path, 'enter',
+                          '::tk::rbCanvasTagTrace')
+      @tag_index = {}
+      @item_tags = {}
+      @tag_index_gen = -1  # force a rebuild on first query
+      self
+    end
+
+    # Turn off the tag index and drop its maps.
+    # @return [self]
+    def disable_tag_index
+      return self unless @tag_index
+      tk_call_without_enc('trace', 'remove', 'execution', @path, 'enter',
+                          '::tk::rbCanvasTagTrace')
+      tk_call_without_enc('unset', '-nocomplain', _tag_index_var)
+      @tag_index = @item_tags = @tag_index_gen = nil
+      self
+    end
+
+    def tag_index?
+      !@tag_index.nil?
+    end
+
+    # @!visibility private
+    def __destroy_hook__
+      if @tag_index
+        TkCore::INTERP.tcl_unset_var(_tag_index_var) rescue nil
+      end
+      @tag_index = @item_tags = @tag_index_gen = nil
+    end
+
+    # Items carrying +tag+, in creation order.
+    # @param tag [String, TkcTag] tag name ('all' allowed)
+    # @return [Array<TkcItem, Integer>]
+    def items_with_tag(tag)
+      ids = _tag_index_sync && _tag_index_ids(tag)
+      return find_withtag(tag) unless ids
+
+      _tag_index_verify(tag, ids.sort){
+        list(tk_send_without_enc('find', 'withtag', tagid(tag))).sort
+      }
+      ids.map{|id| itemid2obj(id) }
+    end
+
+    # Tags on +item+, excluding the dynamic "current" tag.
+    # @param item [TkcItem, Integer]
+    # @return [Array<TkcTag, String>]
+    def item_tags(item)
+      id = tagid(item)
+      return gettags(item).reject{|t| t == 'current' } unless id.kind_of?(Integer) && _tag_index_sync
+
+      tags = @item_tags[id] || []
+      _tag_index_verify(id, tags){
+        simplelist(tk_send_without_enc('gettags', id)) - ['current']
+      }
+      tags.map{|t| canvastagid2obj(t) }
+    end
+
+    # True if +item+ carries +tag+.
+    def tag?(item, tag)
+      id = tagid(item)
+      tag = tagid(tag).to_s
+      return item_tags(item).any?{|t| tagid(t).to_s == tag } unless id.kind_of?(Integer) && _tag_index_sync
+
+      (tags = @item_tags[id]) ? tags.include?(tag) : false
+    end
+
+    # @!visibility private
+    # Called by TkcItem.create after the Tcl 'create'.
+    def _tag_index_created(id, args)
+      return unless @tag_index
+      tags = []
+      args.each_with_index{|arg, i|
+        next unless arg == '-tags' || arg == '-tag'
+        val = args[i + 1]
+        tags = val.kind_of?(Array) ? val.flatten.map{|t| tagid(t).to_s } : simplelist(val.to_s)
+      }
+      @item_tags[id] = []
+      tags.each{|t| _tag_index_add(id, t) }
+      @tag_index_gen += 1
+    end
+
+    private
+
+    def _tag_index_var
+      "::tk::rbCanvasGen(#{@path})"
+    end
+
+    # Rebuild if anything changed tags behind the wrapper. Returns false
+    # when the index is off.
+    def _tag_index_sync
+      return false unless @tag_index
+      gen = TkCore::INTERP.tcl_get_var(_tag_index_var).to_i
+      return true if gen == @tag_index_gen
+
+      @tag_index = {}
+      @item_tags = {}
+      simplelist(tk_call_without_enc('apply', DUMP_LAMBDA, @path)).each_slice(2){|id, tags|
+        id = id.to_i
+        @item_tags[id] = []
+        simplelist(tags).each{|t| _tag_index_add(id, t) unless t == 'current' }
+      }
+      @tag_index_gen = gen
+      true
+    end
+
+    def _tag_index_verify(what, indexed)
+      return unless @tag_index_check
+      actual = yield
+      return if indexed == actual
+      fail RuntimeError, "canvas tag index out of sync for #{what.inspect}: " \
+                         "index #{indexed.inspect}, Tcl #{actual.inspect}"
+    end
+
+    # Item ids for a tag or id, or nil when only Tcl can answer
+    def _tag_index_ids(spec)
+      spec = tagid(spec)
+      spec = spec.to_i if spec.kind_of?(String) && spec.match?(/\A\d+\z/)
+      return (@item_tags.key?(spec) ? [spec] : []) if spec.kind_of?(Integer)
+
+      spec = spec.to_s
+      return @item_tags.keys if spec == 'all'
+      return nil if spec == 'current' || spec.match?(/&&|\|\||[\^!()]/)
+      (ids = @tag_index[spec]) ? ids.keys : []
+    end
+
+    def _tag_index_add(id, tag)
+      tags = (@item_tags[id] ||= [])
+      return if tags.include?(tag)
+      tags << tag
+      (@tag_index[tag] ||= {})[id] = true
+    end
+
+    def _tag_index_remove(id, tag)
+      tags = @item_tags[id]
+      return unless tags && tags.delete(tag)
+      if (ids = @tag_index[tag])
+        ids.delete(id)
+        @tag_index.delete(tag) if ids.empty?
+      end
+    end
+
+    def _tag_index_forget(id)
+      (@item_tags.delete(id) || []).each{|t|
+        if (ids = @tag_index[t])
+          ids.delete(id)
+          @tag_index.delete(t) if ids.empty?
+        end
+      }
+    end
+
+    # Hooks run after the matching Tcl call. Each one that keeps the index
+    # exact advances the expected generation; otherwise the mismatch
+    # forces a rebuild on the next query.
+
+    def _tag_index_addtag(tag, mode, target)
+      return unless @tag_index
+      ids = case mode
+            when 'all' then @item_tags.keys
+            when 'withtag', 'with' then _tag_index_ids(target)
+            end
+      return unless ids
+      tag = tagid(tag).to_s
+      ids.each{|id| _tag_index_add(id, tag) }
+      @tag_index_gen += 1
+    end
+
+    def _tag_index_dtag(spec, tag_to_del)
+      return unless @tag_index
+      return unless (ids = _tag_index_ids(spec))
+      tag = tagid(tag_to_del == None ? spec : tag_to_del).to_s
+      ids.each{|id| _tag_index_remove(id, tag) }
+      @tag_index_gen += 1
+    end
+
+    def _tag_index_deleted(ids_per_spec)
+      return unless @tag_index
+      return if ids_per_spec.any?(&:nil?)
+      ids_per_spec.each{|ids| ids.each{|id| _tag_index_forget(id) } }
+      @tag_index_gen += 1
+    end
+  end
+end
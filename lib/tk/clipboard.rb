@@ -57,6 +57,45 @@ module TkClipboard
     tk_call(*args)
   end
 
+  # Put +data+ on the clipboard without copying it into Tcl.
+  #
+  # On X11 the CLIPBOARD selection is served lazily by
+  # TkSelection.provide: +data+ may be a String or a
+  # <tt>call(offset, max_bytes)</tt> provider (or a block), and requesting
+  # applications pull it in chunks. Other windowing systems have no lazy
+  # clipboard, so the data is materialized once and handed to #set.
+  #
+  # +win+ owns the clipboard and must outlive the copy.
+  def self.provide(win, data=nil, type: 'STRING', &block)
+    data ||= block
+    fail ArgumentError, 'no data or provider block given' unless data
+    if Tk.windowingsystem == 'x11'
+      TkSelection.provide(win, data, selection: 'CLIPBOARD', type: type)
+    else
+      set_on_display(win, data.kind_of?(String) ? data : _provider_string(data),
+                     type: type)
+    end
+    nil
+  end
+
+  # Read the clipboard in pieces as they arrive. Returns the total number
+  # of bytes yielded.
+  #
+  #   TkClipboard.each_chunk { |chunk| io.write(chunk) }
+  def self.each_chunk(type: 'STRING', displayof: '.', &block)
+    TkSelection.each_chunk(selection: 'CLIPBOARD', type: type,
+                           displayof: displayof, &block)
+  end
+
+  def self._provider_string(provider)
+    buf = String.new(encoding: Encoding::BINARY)
+    while (chunk = provider.call(buf.bytesize, 65536)) && !chunk.empty?
+      buf << chunk
+    end
+    buf.force_encoding(Encoding::UTF_8)
+  end
+  private_class_method :_provider_string
+
   def clear
     TkClipboard.clear_on_display(self)
     self
@@ -72,4 +111,11 @@ module TkClipboard
     TkClipboard.append_on_display(self, data, keys)
     self
   end
+  def provide(data=nil, **keys, &block)
+    TkClipboard.provide(self, data, **keys, &block)
+    self
+  end
+  def each_chunk(**keys, &block)
+    TkClipboard.each_chunk(displayof: self, **keys, &block)
+  end
 end
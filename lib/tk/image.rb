@@ -601,6 +601,25 @@ class TkPhotoImage<TkImage
     Tk::INTERP.photo_get_image(@path, opts.empty? ? nil : opts)
   end
 
+  # Capture a mapped window's current pixels into a new photo image.
+  #
+  # Reads the window straight from the X server (XGetImage), including
+  # its child windows; no screen-grab tool or intermediate file is used.
+  # Only available with X11 builds of Tk.
+  #
+  # @param win [TkWindow, String] Window or window path
+  # @return [TkPhotoImage]
+  # @raise [NotImplementedError] on non-X11 builds
+  #
+  # @example Save a screenshot of a dialog
+  #   TkPhotoImage.capture(dialog).write('dialog.png', format: 'png')
+  #
+  def self.capture(win)
+    shot = Tk::INTERP.capture_window(win.respond_to?(:path) ? win.path : win.to_s)
+    new(width: shot[:width], height: shot[:height])
+      .put_block(shot[:data], shot[:width], shot[:height])
+  end
+
   # Get dimensions of the photo image using Tk_PhotoGetSize.
   # Faster than querying width/height separately via Tcl.
   #
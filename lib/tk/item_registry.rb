@@ -0,0 +1,33 @@
+# frozen_string_literal: true
+
+module Tk
+  # Per-widget id => Ruby object tables for widget items and tags.
+  #
+  # Canvas, text and treeview widgets keep the wrappers for their items
+  # and tags in plain Hashes on the widget object (+@items+, +@tags+, ...)
+  # rather than in global path-keyed tables:
+  #
+  # - entries die with the widget, so nothing leaks across widget churn
+  # - entries are dropped when the item or tag is deleted
+  # - tables are only touched from the Tk thread, so lookups need no mutex
+  #
+  # This module only provides the shared memory report.
+  module ItemRegistry
+    # Entry counts and approximate retained bytes for each table.
+    #
+    # @param tables [Hash{Symbol=>Hash, nil}] table name => registry Hash
+    # @return [Hash{Symbol=>Hash}] name => { count:, bytes: }
+    # @example
+    #   Tk::ItemRegistry.report(items: @items, tags: @tags)
+    #   # => {items: {count: 120, bytes: 23040}, tags: {count: 2, bytes: 296}}
+    def self.report(tables)
+      require 'objspace'
+      tables.each_with_object({}) do |(name, table), report|
+        table ||= {}
+        bytes = ObjectSpace.memsize_of(table)
+        table.each_value { |obj| bytes += ObjectSpace.memsize_of(obj) }
+        report[name] = { count: table.size, bytes: bytes }
+      end
+    end
+  end
+end
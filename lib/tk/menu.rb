@@ -134,6 +134,72 @@ class Tk::Menu<TkWindow
     add('separator', keys)
   end
 
+  # Add many entries in one call. Each entry is a Hash with an optional
+  # :type (default :command), a [type, keys] pair, or a bare type such
+  # as :separator:
+  #
+  #   menu.add_entries(files.map{|f| {label: f, command: -> { open(f) }} })
+  #
+  # Entry commands share one callback per menu instead of registering
+  # one each. With replace: true the existing entries are deleted
+  # first and their commands released, so a menu can be rebuilt on
+  # every post without accumulating callbacks.
+  def add_entries(entries, replace: false)
+    @entry_commands = [] if replace || !@entry_commands
+    words = entries.map{|entry| _entry_words(entry) }
+    TkCore::INTERP.menu_add_entries(@path, words, replace: replace)
+    self
+  end
+
+  # Add a cascade whose submenu is filled when it is posted: the block
+  # returns its entries (anything add_entries takes) and runs from the
+  # submenu's postcommand, each time it is posted, or only the first
+  # time with once: true. Returns the submenu.
+  #
+  #   menu.add_lazy_cascade(label: 'Open Recent') { recent_files.map{...} }
+  def add_lazy_cascade(keys=nil, &generator)
+    fail ArgumentError, "no entry generator given" unless generator
+    keys = _symbolkey2str(keys || {})
+    once = keys.delete('once')
+    submenu = TkMenu.new(self, :tearoff=>keys.delete('tearoff') || false)
+    filled = false
+    submenu.postcommand{
+      unless once && filled
+        submenu.add_entries(generator.call(submenu), replace: true)
+        filled = true
+      end
+    }
+    add('cascade', keys.merge('menu'=>submenu))
+    submenu
+  end
+
+  def _entry_words(entry)
+    case entry
+    when Hash
+      keys = _symbolkey2str(entry)
+      type = keys.delete('type') || 'command'
+    when Array
+      type, keys = entry
+      keys = _symbolkey2str(keys || {})
+    else
+      type, keys = entry, {}
+    end
+
+    cmd = keys.delete('command') if keys['command'].respond_to?(:call)
+    words = hash_kv(keys, true, [type.to_s])
+    words.push('-command', _entry_command(cmd)) if cmd
+    words
+  end
+  private :_entry_words
+
+  # Entry commands are slots of one per-menu dispatcher callback
+  def _entry_command(cmd)
+    @entry_dispatch ||= install_cmd(proc{|slot| @entry_commands[slot.to_i].call })
+    @entry_commands << cmd
+    "#{@entry_dispatch} #{@entry_commands.size - 1}"
+  end
+  private :_entry_command
+
   def clone_menu(*args)
     if args[0].kind_of?(TkWindow)
       parent = args.shift
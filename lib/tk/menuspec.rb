@@ -159,6 +159,7 @@ module TkMenuSpec
       menu = TkMenu.new(parent, :tearoff=>tearoff)
     end
 
+    entries = []
     for item_info in menu_info
       if item_info.kind_of?(Hash)
         options = orig_opts.dup
@@ -190,7 +191,7 @@ module TkMenuSpec
             options['underline'] = -1
           end
         end
-        menu.add(item_type, options)
+        entries << [item_type, options]
 
       elsif item_info.kind_of?(Array)
         options = orig_opts.dup
@@ -263,15 +264,16 @@ module TkMenuSpec
           end
         end
 
-        menu.add(item_type, options)
+        entries << [item_type, options]
 
       elsif /^-+$/ =~ item_info
-        menu.add('separator')
+        entries << 'separator'
 
       else
-        menu.add('command', 'label' => item_info)
+        entries << ['command', {'label' => item_info}]
       end
     end
+    menu.add_entries(entries)
 
     menu
   end
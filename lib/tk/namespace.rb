@@ -200,26 +200,14 @@ class TkNamespace < TkObject
   class ScopeArgs < Array
     include Tk
 
-    # alias __tk_call             tk_call
-    # alias __tk_call_without_enc tk_call_without_enc
-    # alias __tk_call_with_enc    tk_call_with_enc
     def tk_call(*args)
-      #super('namespace', 'eval', @namespace, *args)
-      args = args.collect{|arg| (s = _get_eval_string(arg, true))? s: ''}
-      super('namespace', 'eval', @namespace,
-            TkCore::INTERP._merge_tklist(*args))
+      TkNamespace._ns_invoke(@namespace, args)
     end
     def tk_call_without_enc(*args)
-      #super('namespace', 'eval', @namespace, *args)
-      args = args.collect{|arg| (s = _get_eval_string(arg, true))? s: ''}
-      super('namespace', 'eval', @namespace,
-            TkCore::INTERP._merge_tklist(*args))
+      TkNamespace._ns_invoke(@namespace, args)
     end
     def tk_call_with_enc(*args)
-      #super('namespace', 'eval', @namespace, *args)
-      args = args.collect{|arg| (s = _get_eval_string(arg, true))? s: ''}
-      super('namespace', 'eval', @namespace,
-            TkCore::INTERP._merge_tklist(*args))
+      TkNamespace._ns_invoke(@namespace, args)
     end
 
     def initialize(namespace, *args)
@@ -273,26 +261,26 @@ class TkNamespace < TkObject
   # @!visibility private
   alias __tk_call_with_enc    tk_call_with_enc
 
+  # @!visibility private
+  # Run args as one command inside namespace ns. Interp#ns_invoke
+  # (tknamespace.c) passes them to namespace eval as a list object, so
+  # no script is built or compiled per call.
+  def self._ns_invoke(ns, args)
+    args = args.collect{|arg| (s = TkUtil._get_eval_string(arg, true))? s: ''}
+    TkCore.current_interp.ns_invoke(ns, *args)
+  end
+
   # @!visibility private
   def tk_call(*args)
-    #super('namespace', 'eval', @fullname, *args)
-    args = args.collect{|arg| (s = _get_eval_string(arg, true))? s: ''}
-    super('namespace', 'eval', @fullname,
-          TkCore::INTERP._merge_tklist(*args))
+    TkNamespace._ns_invoke(@fullname, args)
   end
   # @!visibility private
   def tk_call_without_enc(*args)
-    #super('namespace', 'eval', @fullname, *args)
-    args = args.collect{|arg| (s = _get_eval_string(arg, true))? s: ''}
-    super('namespace', 'eval', @fullname,
-          TkCore::INTERP._merge_tklist(*args))
+    TkNamespace._ns_invoke(@fullname, args)
   end
   # @!visibility private
   def tk_call_with_enc(*args)
-    #super('namespace', 'eval', @fullname, *args)
-    args = args.collect{|arg| (s = _get_eval_string(arg, true))? s: ''}
-    super('namespace', 'eval', @fullname,
-          TkCore::INTERP._merge_tklist(*args))
+    TkNamespace._ns_invoke(@fullname, args)
   end
   # @!visibility private
   alias ns_tk_call             tk_call
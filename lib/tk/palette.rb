@@ -30,23 +30,87 @@ module TkPalette
     tk_call('::tk::Darken', color, percent)
   end
 
+  # Recolor the window tree under root in one native pass: one configure
+  # per window, redrawn once afterwards. colors maps option database
+  # names to colors ({'background' => '#333', 'foreground' => 'white'}).
+  #
+  # from:    colors being replaced; an option changes only if it shows
+  #          the old color. Without it, options the application set
+  #          itself are kept (tk_setPalette's rule).
+  # options: also record the colors in the option database, so windows
+  #          created later match.
+  #
+  # Returns {windows:, configured:, options:, skipped:}.
+  def TkPalette.recolor(colors, root: '.', from: nil, options: false)
+    fail ArgumentError, "colors must be a Hash" unless colors.kind_of?(Hash)
+    root = root.path if root.respond_to?(:path)
+    opts = {options: options}
+    opts[:from] = from if from
+    TkCore::INTERP.recolor_tree(root, colors, opts)
+  end
+
+  # Complete a palette the way tk_setPalette does: given a background
+  # (and optionally other colors), derive the remaining ones.
+  def TkPalette.derive(*args)
+    args = args[0].to_a.flatten if args[0].kind_of? Hash
+    new = (args.size == 1) ? {'background' => args[0]} : Hash[*args]
+    new = new.transform_keys(&:to_s)
+    bg = new['background'] or fail ArgumentError, "must specify a background color"
+
+    r, g, b = rgb(bg)
+    new['foreground'] ||= (r + 1.5 * g + 0.5 * b > 100000) ? 'black' : 'white'
+    fr, fg, fb = rgb(new['foreground'])
+    darker = format('#%02x%02x%02x', 9 * r / 2560, 9 * g / 2560, 9 * b / 2560)
+
+    %w(activeForeground insertBackground selectForeground highlightColor).each{|k|
+      new[k] ||= new['foreground']
+    }
+    new['disabledForeground'] ||= format('#%02x%02x%02x', (3 * r + fr) / 1024,
+                                         (3 * g + fg) / 1024, (3 * b + fb) / 1024)
+    new['highlightBackground'] ||= bg
+    new['activeBackground'] ||= format('#%02x%02x%02x', *[r, g, b].map{|c|
+      light = c / 256
+      [light + [light * 15 / 100, (255 - light) / 3].max, 255].min
+    })
+    new['selectBackground'] ||= darker
+    new['troughColor'] ||= darker
+    new
+  end
+
+  # tk_setPalette without the Tcl tree walk: derives the palette, then
+  # recolors natively (see TkPalette.recolor) and updates the option
+  # database and ::tk::Palette like tk_setPalette.
+  def TkPalette.apply(*args)
+    palette = derive(*args)
+    return palette if TkWinfo.depth(Tk.root) == 1
+
+    TkPalette.recolor(palette, options: true)
+    tk_call('array', 'set', '::tk::Palette', palette.to_a.flatten)
+    palette
+  end
+
+  def TkPalette.rgb(color)
+    tk_call('winfo', 'rgb', '.', color).split.map(&:to_i)
+  end
+  private_class_method :rgb
+
+  # Change options of win and its descendants that still show the
+  # current palette's color (::tk::Palette) to the given colors.
   def TkPalette.recolorTree(win, colors)
     if not colors.kind_of?(Hash)
       fail "2nd arg need to be Hash"
     end
 
-    tk_call('global', "tkPalette")
-    colors.each{|key, value|
+    from = {}
+    colors.each_key{|key|
       begin
-        if win.cget(key) == tk_call('set', "tkPalette(#{key})")
-          win[key] = colors[key]
-        end
+        from[key] = tk_call('set', "::tk::Palette(#{key})")
       rescue
-        # ignore
+        # no palette color for this option
       end
     }
-
-    TkWinfo.children(win).each{|w| TkPalette.recolorTree(w, colors)}
+    return if from.empty?
+    TkPalette.recolor(colors.select{|key, _| from.key?(key)}, root: win, from: from)
   end
 
   def recolorTree(colors)
@@ -0,0 +1,60 @@
+# frozen_string_literal: true
+
+module Tk
+  # Coalesced size-change notification for one or more windows.
+  #
+  # Created by {Tk.on_resize}. The bridge watches the windows with C-level
+  # event handlers, so the storm of <Configure> events a window resize
+  # produces never reaches Ruby: only the latest size of each window is
+  # kept, and the block runs once per changed window per idle pass
+  # (debounce: :frame) or once the window has been quiet for the given
+  # number of milliseconds. The watch ends by itself when the last of its
+  # windows is destroyed.
+  class ResizeWatch
+    include TkComm
+
+    attr_reader :windows
+
+    # @param wins [TkWindow, Array<TkWindow>]
+    # @param debounce [:frame, Integer] :frame or a quiet period in ms
+    # @param batch [Boolean] deliver all changes in one call
+    def initialize(wins, debounce: :frame, batch: false, &block)
+      fail ArgumentError, 'no block given' unless block
+      single = !wins.kind_of?(Array)
+      @windows = Array(wins)
+      delay = case debounce
+              when :frame, nil then 0
+              when Integer then debounce
+              else fail ArgumentError, "debounce must be :frame or milliseconds, got #{debounce.inspect}"
+              end
+
+      callback = if batch
+                   proc{|changes|
+                     block.call(changes.each_with_object({}){|(path, w, h), hash|
+                       hash[window(path)] = [w, h]
+                     })
+                   }
+                 elsif single
+                   proc{|_path, w, h| block.call(w, h) }
+                 else
+                   proc{|path, w, h| block.call(window(path), w, h) }
+                 end
+      paths = @windows.map{|win| win.respond_to?(:path) ? win.path : win.to_s }
+      @id = TkCore::INTERP.resize_watch(paths, callback, delay, batch)
+    end
+
+    # Stop watching; pending deliveries are dropped.
+    # @return [Boolean] false if already cancelled
+    def cancel
+      return false unless @id
+      TkCore::INTERP.resize_unwatch(@id)
+      @id = nil
+      true
+    end
+
+    # False once cancelled or once every watched window is destroyed
+    def active?
+      !@id.nil? && TkCore::INTERP.resize_watches.include?(@id)
+    end
+  end
+end
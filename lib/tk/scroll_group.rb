@@ -0,0 +1,97 @@
+# frozen_string_literal: true
+
+module Tk
+  # Keeps several widgets scrolled in lockstep along one axis, optionally
+  # with one shared scrollbar.
+  #
+  # The group is a Tcl command created by Interp#scroll_group: it is each
+  # member's scrollcommand and the scrollbar's command, so scrolling any
+  # member or dragging the scrollbar moves the others without calling
+  # Ruby. Followers' own scroll reports are absorbed, so members whose
+  # views snap to whole lines do not feed back into each other.
+  #
+  # @example Line numbers, text and a shared scrollbar
+  #   group = Tk::ScrollGroup.new([numbers, text], axis: :y, scrollbar: bar)
+  #   group.add(annotations)
+  class ScrollGroup
+    include TkComm
+
+    attr_reader :axis, :command, :scrollbar
+
+    # @param widgets [Array<TkWindow>] members
+    # @param axis [:x, :y]
+    # @param scrollbar [TkScrollbar, nil] shared scrollbar
+    # @yield [first, last] group fractions, at most once per idle pass
+    def initialize(widgets, axis: :y, scrollbar: nil, &observer)
+      @axis = axis
+      @ip = TkCore.current_interp
+      if observer
+        id = @ip.register_callback(proc{|first, last| observer.call(first.to_f, last.to_f) })
+        @observer_id = id
+        notify = "ruby_callback #{id}"
+      end
+      bar_path = scrollbar && _path(scrollbar)
+      @command = @ip.scroll_group(widgets.map{|w| _path(w) }, axis, bar_path, notify)
+      scrollbar.orient(axis == :x ? 'horizontal' : 'vertical') if scrollbar.respond_to?(:orient)
+      @scrollbar = scrollbar
+    rescue
+      @ip.unregister_callback(@observer_id) if @observer_id
+      raise
+    end
+
+    # @param win [TkWindow] widget to add; it moves to the group position
+    def add(win)
+      @ip.tcl_invoke(@command, 'add', _path(win))
+      self
+    end
+
+    # @param win [TkWindow] widget to remove; its scrollcommand is cleared
+    def remove(win)
+      @ip.tcl_invoke(@command, 'remove', _path(win))
+      self
+    end
+
+    # @return [Array<TkWindow>] current members (destroyed ones drop out)
+    def members
+      simplelist(@ip.tcl_invoke(@command, 'members')).map{|path| window(path) }
+    end
+
+    # @param bar [TkScrollbar, nil] new shared scrollbar, nil to detach
+    def scrollbar=(bar)
+      @ip.tcl_invoke(@command, 'scrollbar', bar ? _path(bar) : '')
+      @scrollbar = bar
+    end
+
+    # Scroll every member to fraction.
+    def moveto(fraction)
+      @ip.tcl_invoke(@command, 'view', 'moveto', fraction.to_s)
+      self
+    end
+
+    # Scroll by number units or pages, led by the first member.
+    def scroll(number, what = 'units')
+      @ip.tcl_invoke(@command, 'view', 'scroll', number.to_s, what.to_s)
+      self
+    end
+
+    # @return [Array(Float, Float)] first and last group fractions
+    def fractions
+      simplelist(@ip.tcl_invoke(@command, 'fractions')).map(&:to_f)
+    end
+
+    # Unlink all members and delete the group command. The group also
+    # lives on (empty) after its members are destroyed, until this call.
+    def destroy
+      return unless @command
+      @ip.tcl_invoke(@command, 'delete')
+      @ip.unregister_callback(@observer_id) if @observer_id
+      @command = nil
+    end
+
+    private
+
+    def _path(win)
+      win.respond_to?(:path) ? win.path : win.to_s
+    end
+  end
+end
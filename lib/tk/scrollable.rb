@@ -25,13 +25,25 @@ module Tk
       xview('scroll', *index)
     end
 
-    def xscrollbar(bar=nil)
+    # Attach a scrollbar.
+    #
+    # With native: true the two are linked by Tcl command prefixes
+    # (Interp#scroll_link), so scrolling never calls into Ruby. A block
+    # is then an observer, called with the first and last visible
+    # fractions at most once per idle pass.
+    # @param bar [TkScrollbar, Tk::Tile::TScrollbar]
+    # @param native [Boolean]
+    def xscrollbar(bar=nil, native: false, &observer)
       if bar
         @xscrollbar = bar
         @xscrollbar.orient 'horizontal'
-        self.xscrollcommand {|*arg| @xscrollbar.set(*arg)}
-        @xscrollbar.command {|*arg| self.xview(*arg)}
-        Tk.update  # avoid scrollbar trouble
+        if native
+          Tk::Scrollable._scroll_link(self, bar, :x, observer)
+        else
+          self.xscrollcommand {|*arg| @xscrollbar.set(*arg)}
+          @xscrollbar.command {|*arg| self.xview(*arg)}
+          Tk.update  # avoid scrollbar trouble
+        end
       end
       @xscrollbar
     end
@@ -60,13 +72,25 @@ module Tk
       yview('scroll', *index)
     end
 
-    def yscrollbar(bar=nil)
+    # Attach a scrollbar.
+    #
+    # With native: true the two are linked by Tcl command prefixes
+    # (Interp#scroll_link), so scrolling never calls into Ruby. A block
+    # is then an observer, called with the first and last visible
+    # fractions at most once per idle pass.
+    # @param bar [TkScrollbar, Tk::Tile::TScrollbar]
+    # @param native [Boolean]
+    def yscrollbar(bar=nil, native: false, &observer)
       if bar
         @yscrollbar = bar
         @yscrollbar.orient 'vertical'
-        self.yscrollcommand {|*arg| @yscrollbar.set(*arg)}
-        @yscrollbar.command {|*arg| self.yview(*arg)}
-        Tk.update  # avoid scrollbar trouble
+        if native
+          Tk::Scrollable._scroll_link(self, bar, :y, observer)
+        else
+          self.yscrollcommand {|*arg| @yscrollbar.set(*arg)}
+          @yscrollbar.command {|*arg| self.yview(*arg)}
+          Tk.update  # avoid scrollbar trouble
+        end
       end
       @yscrollbar
     end
@@ -78,5 +102,15 @@ module Tk
   module Scrollable
     include XScrollable
     include YScrollable
+
+    # @!visibility private
+    # Link win and bar along axis in Tcl; the observer, if any, is
+    # installed in win's callback table so it is released with win.
+    def self._scroll_link(win, bar, axis, observer)
+      if observer
+        cmd = win.install_cmd(proc{|first, last| observer.call(first.to_f, last.to_f) })
+      end
+      TkCore.current_interp.scroll_link(win.path, bar && bar.path, axis, cmd)
+    end
   end
 end
@@ -81,4 +81,50 @@ module TkSelection
     TkSelection.set_owner(self, keys)
     self
   end
+
+  # Serve a selection lazily from Ruby without building a Tcl string.
+  #
+  # +data+ is either a String (served by byte range straight from its
+  # buffer, no Ruby calls per chunk) or an object whose
+  # <tt>call(offset, max_bytes)</tt> returns the bytes starting at +offset+
+  # (nil or "" at the end). A block may be given instead of +data+.
+  #
+  #   TkSelection.provide(table, huge_tsv)
+  #   TkSelection.provide(table) { |off, max| dump.byteslice(off, max) }
+  #
+  # The handler is removed when +win+ is destroyed or by #unprovide.
+  # With +own+ (default) +win+ also claims the selection.
+  def self.provide(win, data=nil, selection: 'PRIMARY', type: 'STRING',
+                   format: 'STRING', own: true, &block)
+    data ||= block
+    fail ArgumentError, 'no data or provider block given' unless data
+    path = _epath(win).to_s
+    TkCore::INTERP.selection_provide(path, data, selection.to_s, type.to_s, format.to_s)
+    tk_call_without_enc('selection', 'own', '-selection', selection, path) if own
+    nil
+  end
+  def provide(data=nil, **keys, &block)
+    TkSelection.provide(self, data, **keys, &block)
+    self
+  end
+
+  # Remove a handler installed by #provide. Returns true if one existed.
+  def self.unprovide(win, selection: 'PRIMARY', type: 'STRING')
+    TkCore::INTERP.selection_unprovide(_epath(win).to_s, selection.to_s, type.to_s)
+  end
+  def unprovide(**keys)
+    TkSelection.unprovide(self, **keys)
+  end
+
+  # Read a selection in pieces as Tk receives them, instead of as one
+  # String. Returns the total number of bytes yielded.
+  #
+  #   File.open('sel.txt', 'w') { |f| TkSelection.each_chunk { |c| f << c } }
+  def self.each_chunk(selection: 'PRIMARY', type: 'STRING', displayof: '.', &block)
+    fail ArgumentError, 'no block given' unless block
+    TkCore::INTERP.selection_each(_epath(displayof).to_s, selection.to_s, type.to_s, &block)
+  end
+  def each_chunk(**keys, &block)
+    TkSelection.each_chunk(displayof: self, **keys, &block)
+  end
 end
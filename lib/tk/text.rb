@@ -9,6 +9,7 @@ require 'tk/scrollable'
 require 'tk/txtwin_abst'
 require 'tk/option_dsl'
 require 'tk/item_option_dsl'
+require 'tk/item_registry'
 
 module TkTextTagConfig
   include Tk::ItemOptionDSL::InstanceMethods
@@ -452,6 +453,17 @@ class Tk::Text<TkTextWin
     @tags[tagid] || tagid
   end
 
+  # @!visibility private
+  def _deltag(name)
+    @tags.delete(name) if @tags
+  end
+
+  # Sizes of this text widget's tag registry.
+  # @return [Hash{Symbol=>Hash}] e.g. {tags: {count: 5, bytes: 960}}
+  def registry_report
+    Tk::ItemRegistry.report(tags: @tags)
+  end
+
   def tag_names(index=None)
     #tk_split_simplelist(_fromUTF8(tk_send_without_enc('tag', 'names', _get_eval_enc_str(index)))).collect{|elt|
     tk_split_simplelist(tk_send_without_enc('tag', 'names', _get_eval_enc_str(index)), false, true).collect{|elt|
@@ -754,8 +766,9 @@ class Tk::Text<TkTextWin
   alias add_tag tag_add
 
   def tag_delete(*tags)
-    tk_send_without_enc('tag', 'delete',
-                        *(tags.collect{|tag| _get_eval_enc_str(tag)}))
+    names = tags.collect{|tag| _get_eval_enc_str(tag)}
+    tk_send_without_enc('tag', 'delete', *names)
+    names.each{|name| _deltag(name) }
     self
   end
   alias deltag tag_delete
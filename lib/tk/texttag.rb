@@ -254,6 +254,7 @@ class TkTextTag<TkObject
 
   def destroy
     tk_call_without_enc(@t.path, 'tag', 'delete', @id)
+    @t._deltag(@id)
     self
   end
 end
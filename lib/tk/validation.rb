@@ -488,6 +488,116 @@ module TkValidation
     end
   end
 
+  # Validator implemented natively in the bridge as a Tcl command.
+  #
+  # Checking a keystroke runs entirely in C: no Ruby callback, no
+  # %-substitution decoding. Use it anywhere a validatecommand goes:
+  #
+  #   age = TkEntry.new(root, validate: :all,
+  #                     vcmd: TkValidation.integer(min: 0, max: 150))
+  #   price = TkEntry.new(root, validate: :key,
+  #                       vcmd: TkValidation.decimal(precision: 2, min: 0))
+  #   code = TkEntry.new(root, validate: :key,
+  #                      vcmd: TkValidation::Compiled.new(max_length: 8,
+  #                                                      charset: ('A'..'Z')))
+  #
+  # While typing (trigger "key") incomplete values such as "" or "-" are
+  # accepted and a range only rejects values no further typing can fix;
+  # full range and emptiness checks run on focusout and forced validation.
+  # Instances are cached per interpreter and spec, so identical
+  # validators share one command. The command is created in the
+  # interpreter Tk calls go to (see TkCore.with_interp).
+  class Compiled
+    # [interp, spec] => validator
+    CACHE = {}
+
+    attr_reader :command
+
+    # @param type [:integer, :decimal, nil] numeric syntax check
+    # @param min [Numeric, nil] inclusive lower bound
+    # @param max [Numeric, nil] inclusive upper bound
+    # @param precision [Integer, nil] max digits after the decimal point
+    # @param pattern [String, Regexp, nil] Tcl regexp the whole value
+    #   must match (a Regexp's source is used as is)
+    # @param max_length [Integer, nil] max characters
+    # @param charset [String, Range, Array, nil] allowed characters
+    # @param allow_empty [Boolean] accept "" when not typing
+    def self.new(type: nil, min: nil, max: nil, precision: nil, pattern: nil,
+                 max_length: nil, charset: nil, allow_empty: true)
+      pattern = pattern.source if pattern.kind_of?(Regexp)
+      charset = charset.to_a.join if charset.kind_of?(Range)
+      charset = charset.join if charset.kind_of?(Array)
+      spec = {type: type && type.to_s, min: min, max: max, precision: precision,
+              pattern: pattern, max_length: max_length, charset: charset,
+              allow_empty: allow_empty}.compact
+      ip = TkCore.current_interp
+      CACHE.fetch([ip, spec]){
+        CACHE.delete_if{|(owner, _), _| owner.deleted? }
+        CACHE[[ip, spec]] = super(ip, spec)
+      }
+    end
+
+    # Validators created after an Interp snapshot lose their commands
+    # on reset; later requests for the same spec must build new ones.
+    TkCore::INTERP.reset_hook{|ip|
+      CACHE.delete_if{|(owner, _), v|
+        owner.equal?(ip) && ip._invoke('info', 'commands', v.command).empty?
+      }
+    }
+
+    def initialize(ip, spec)
+      @command = ip.validator_create(spec)
+      @spec = spec.freeze
+    end
+
+    def to_eval
+      "#{@command} %P %V %W"
+    end
+
+    def inspect
+      "#<#{self.class} #{@spec.inspect}>"
+    end
+  end
+
+  # @return [Compiled] integer validator
+  def self.integer(min: nil, max: nil, **opts)
+    Compiled.new(type: :integer, min: min, max: max, **opts)
+  end
+
+  # @return [Compiled] decimal validator
+  def self.decimal(precision: nil, min: nil, max: nil, **opts)
+    Compiled.new(type: :decimal, precision: precision, min: min, max: max, **opts)
+  end
+
+  # @return [Compiled] whole-value regexp validator (Tcl ARE syntax)
+  def self.regexp(pattern, **opts)
+    Compiled.new(pattern: pattern, **opts)
+  end
+
+  # @return [Compiled] maximum length validator
+  def self.max_length(len, **opts)
+    Compiled.new(max_length: len, **opts)
+  end
+
+  # @return [Compiled] allowed-characters validator
+  def self.charset(chars, **opts)
+    Compiled.new(charset: chars, **opts)
+  end
+
+  # Validity of many fields in one bridge call.
+  #
+  # @param widgets [Array<TkWindow, String>]
+  # @param revalidate [Boolean] force validation of each widget first
+  #   (runs their validatecommand; compiled ones stay in C)
+  # @return [Array<Boolean, nil>] nil if a compiled validator has not
+  #   seen the widget yet (only without revalidate)
+  # @example
+  #   ok = TkValidation.states(form_fields, revalidate: true).all?
+  def self.states(widgets, revalidate: false)
+    TkCore.current_interp.validation_states(widgets.map{|w| w.respond_to?(:path) ? w.path : w.to_s },
+                                            revalidate)
+  end
+
   #####################################
 
   def __validation_class_list
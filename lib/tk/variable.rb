@@ -537,21 +537,38 @@ class TkVariable
     self
   end
 
-  def update(hash)
+  # Sets several elements in one interpreter call.
+  #
+  # With quiet: true, Tcl-level traces on the array (including Ruby
+  # traces added with #trace) are held back during the load and each
+  # write trace runs once afterwards with an empty element name.
+  def update(hash, quiet: false)
     if (is_scalar?)
       fail RuntimeError, 'cannot update a scalar variable'
     end
-    hash.each{|k,v| self[k] = v}
+    INTERP.tcl_array_set(@id, _array_pairs(hash), quiet: quiet)
     self
   end
 
+  # Keys and values converted as #[]= does: an Array key is a
+  # multi-dimensional index ("a,b"), a TkVariable value stores its value.
+  def _array_pairs(hash)
+    hash.each_with_object({}){|(k, v), h|
+      idxs = k.kind_of?(Array) ? k : [k]
+      type = default_element_value_type(idxs)
+      v = v._value if !type && type != :variable && v.kind_of?(TkVariable)
+      h[idxs.collect{|idx| _get_eval_string(idx, true)}.join(',')] = _get_eval_string(v, true)
+    }
+  end
+  private :_array_pairs
+
   def _value
     #if INTERP._eval("global #{@id}; array exist #{@id}") == '1'
     INTERP._invoke_without_enc('global', @id)
     # if INTERP._invoke('array', 'exist', @id) == '1'
     if TkComm.bool(INTERP._invoke('array', 'exist', @id))
       #Hash[*tk_split_simplelist(INTERP._eval("global #{@id}; array get #{@id}"))]
-      Hash[*tk_split_simplelist(INTERP._invoke('array', 'get', @id))]
+      INTERP.tcl_array_get(@id)
     else
       INTERP._get_global_var(@id)
     end
@@ -561,12 +578,7 @@ class TkVariable
     val = val._value if !@type && @type != :variable && val.kind_of?(TkVariable)
     if val.kind_of?(Hash)
       self.clear
-      val.each{|k, v|
-        #INTERP._set_global_var2(@id, _toUTF8(_get_eval_string(k)),
-        #                       _toUTF8(_get_eval_string(v)))
-        INTERP._set_global_var2(@id, _get_eval_string(k, true),
-                                _get_eval_string(v, true))
-      }
+      INTERP.tcl_array_set(@id, _array_pairs(val))
       self.value
 #    elsif val.kind_of?(Array)
 =begin
@@ -853,4 +853,32 @@ module TkWinfo
   end
 
   # @!endgroup
+
+  # @!group Bulk Query
+
+  # Properties supported by {TkWinfo.query}.
+  QUERY_PROPS = [
+    :width, :height, :reqwidth, :reqheight, :x, :y, :rootx, :rooty,
+    :ismapped, :viewable, :exists, :depth, :class, :name
+  ].freeze
+
+  # Reads several properties of many windows in a single call.
+  #
+  # Each window is resolved once and its fields are read directly from
+  # Tk, instead of one +winfo+ command per property per window. Use it
+  # when layout code needs sizes and visibility for many widgets at once.
+  #
+  # @param wins [Array<TkWindow, String>] windows or window paths
+  # @param props [Array<Symbol>] any of {QUERY_PROPS}
+  # @return [Hash{Symbol=>Array}] property => one value per window
+  #   (nil for windows that do not exist, false for +:exists+)
+  # @example
+  #   info = TkWinfo.query(widgets, [:width, :height, :viewable])
+  #   info[:width].zip(info[:height])   # => [[120, 24], [80, 24], ...]
+  def TkWinfo.query(wins, props)
+    paths = wins.map{|w| w.respond_to?(:path) ? w.path : w.to_s }
+    TkCore::INTERP.winfo_query(paths, props)
+  end
+
+  # @!endgroup
 end
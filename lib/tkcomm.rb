@@ -461,6 +461,15 @@ module TkComm
     #Tk_CMDTBL.delete(id)
     TkCore::INTERP.tk_cmd_tbl.delete(id)
   end
+  # Bulk uninstall_cmd for ids whose owners have already dropped them
+  # (destroyed widgets): one pass over the module table, not one per id.
+  def TkComm._release_cmd_ids(ids)
+    return if ids.empty?
+    drop = ids.to_h{|id| [id, true]}
+    @cmdtbl.delete_if{|id| drop[id]}
+    tbl = TkCore::INTERP.tk_cmd_tbl
+    ids.each{|id| tbl.delete(id) }
+  end
   # private :install_cmd, :uninstall_cmd
   # module_function :install_cmd, :uninstall_cmd
   def install_cmd(cmd)
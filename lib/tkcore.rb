@@ -208,13 +208,40 @@ module TkCore
       @init_ip_env.each{|script| script.call(ip)}
       @add_tk_procs.each{|name,args,body| ip._invoke('proc',name,args,body)}
     end
+
+    # snapshot / reset (C, tkreset.c) plus the Ruby-side tables:
+    # callbacks registered since the snapshot are dropped, then the
+    # init_ip_env hooks and add_tk_procs procs run again, then the
+    # reset hooks: libraries that keep Ruby-side state tied to Tcl
+    # commands, bindings or callbacks register one to drop whatever
+    # the reset deleted.
+    def INTERP.reset_hook(hook = nil, &block)
+      (@reset_hooks ||= []) << (hook || block)
+      nil
+    end
+    def INTERP.snapshot
+      super
+      @snapshot_cmd_ids = @tk_cmd_tbl.keys
+      nil
+    end
+    def INTERP.reset
+      raise TclTkLib::TclError, "no snapshot to reset to (call snapshot first)" unless @snapshot_cmd_ids
+      counts = super
+      TkCore._release_destroyed_cmds
+      keep = @snapshot_cmd_ids.to_h{|id| [id, true]}
+      TkComm._release_cmd_ids(@tk_cmd_tbl.keys.reject{|id| keep[id]})
+      init_ip_internal
+      @reset_hooks.each{|hook| hook.call(self)} if @reset_hooks
+      counts
+    end
   end
 
   # ---------------------------------------------------------
   # TkCore.interp - Get the interpreter with runtime safety checks
   #
+  # - Returns the current interpreter if one is set (see with_interp)
   # - Lazily creates an interpreter if none exists
-  # - Raises if multiple interpreters exist (ambiguous)
+  # - Raises if multiple interpreters exist and none is current
   # - Raises if called from background work block
   # - Preferred over the deprecated INTERP constant
   # ---------------------------------------------------------
@@ -225,6 +252,10 @@ module TkCore
         "Use task.yield() to send results to the main thread."
     end
 
+    if (current = Fiber[:tk_interp])
+      return current
+    end
+
     count = TclTkIp.instance_count
 
     if count == 0
@@ -235,13 +266,56 @@ module TkCore
     else
       raise RuntimeError,
         "Multiple Tcl interpreters exist (#{count}). " \
-        "Use interp.after(...) on a specific interpreter instance " \
-        "instead of Tk.after(...)"
+        "Use TkCore.with_interp(ip) { ... } or interp.after(...) on a " \
+        "specific interpreter instance instead of Tk.after(...)"
     end
 
     @default_interp
   end
 
+  # ---------------------------------------------------------
+  # TkCore.with_interp(ip) { ... } - Route Tk calls to another interpreter
+  #
+  # Inside the block, tk_call, ip_eval, ip_invoke (and everything built on
+  # them: widget creation, configure, Tk.after, ...) go to ip instead of
+  # INTERP, and TkCore.interp returns ip. The setting is fiber storage, so
+  # it is per fiber and inherited by fibers and threads started inside.
+  #
+  # ip may be a separate TclTkIp or a child from create_slave. Ruby
+  # callbacks installed while routed (command:, bind, after) work there
+  # too; they share INTERP's callback table.
+  #
+  #   apps = 4.times.map { TclTkIp.new }
+  #   apps.each do |ip|
+  #     TkCore.with_interp(ip) { TkButton.new(text: "Run") { ... }.pack }
+  #   end
+  #
+  # Widget destroy cleanup (destroy_watch) is only installed on INTERP.
+  # ---------------------------------------------------------
+  def self.with_interp(ip)
+    saved = Fiber[:tk_interp]
+    begin
+      _prepare_interp(ip)
+      Fiber[:tk_interp] = ip.equal?(INTERP) ? nil : ip
+      yield ip
+    ensure
+      Fiber[:tk_interp] = saved
+    end
+  end
+
+  # Interpreter Tk calls go to: the with_interp one, else INTERP
+  def self.current_interp
+    Fiber[:tk_interp] || INTERP
+  end
+
+  # Give another interpreter the rb_out dispatch INTERP gets at load time
+  def self._prepare_interp(ip)
+    return if ip.equal?(INTERP) || ip.instance_variable_get(:@tkcore_callback_id)
+    id = ip.register_callback(proc { |*args| TkCore.callback(*args) })
+    ip._invoke('proc', 'rb_out', 'ns args', _rb_out_body(id))
+    ip.instance_variable_set(:@tkcore_callback_id, id)
+  end
+
   # ---------------------------------------------------------
   # TkCore.on_main_thread { block } - Execute block on main Tcl thread
   #
@@ -438,35 +512,67 @@ module TkCore
   #     files.each { |f| t.yield(process(f)) }  # Checks pause each time
   #   end
 
+  # Virtual event fired on every widget destroy (kept for user bindings;
+  # the library itself uses the batched notification below)
   WIDGET_DESTROY_HOOK = '<WIDGET_DESTROY_HOOK>'
   INTERP._invoke_without_enc('event', 'add',
                              "<#{WIDGET_DESTROY_HOOK}>", '<Destroy>')
-  INTERP._invoke_without_enc('bind', 'all', "<#{WIDGET_DESTROY_HOOK}>",
-                             install_cmd(proc{|path|
-                                unless TkCore::INTERP.deleted?
-                                  begin
-                                    if (widget=TkCore::INTERP.tk_windows[path])
-                                      if widget.respond_to?(:__destroy_hook__)
-                                        widget.__destroy_hook__
-                                      end
-                                    end
-                                  rescue StandardError => e
-                                      p e if $DEBUG
-                                  end
-                                end
-                             }) << ' %W')
+
+  # Ruby-side cleanup for destroyed widgets, one call per batch.
+  #
+  # The bridge collects destroyed paths in C and delivers them when the
+  # Tcl "destroy" command returns, so tearing down a subtree costs one
+  # Ruby call instead of one binding per widget. Table entries are
+  # dropped immediately; the widgets' callbacks are released at idle
+  # time, since one of them may be the command currently running.
+  def TkCore._widgets_destroyed(paths)
+    return if INTERP.deleted?
+    windows = INTERP.tk_windows
+    released = @_destroyed_cmd_ids ||= []
+    schedule = released.empty?
+    paths.each{|path|
+      next unless (widget = windows.delete(path))
+      widget.instance_eval{
+        @destroyed = true
+        released.concat(@cmdtbl) if defined?(@cmdtbl) && @cmdtbl
+        @cmdtbl = []
+      }
+      begin
+        widget.__destroy_hook__ if widget.respond_to?(:__destroy_hook__)
+      rescue StandardError => e
+        p e if $DEBUG
+      end
+    }
+    if schedule && !released.empty?
+      INTERP._invoke_without_enc('after', 'idle', "ruby_callback #{TKCORE_RELEASE_ID}")
+    end
+  end
+
+  # Idle-time half of _widgets_destroyed: drop the callbacks in one pass.
+  def TkCore._release_destroyed_cmds
+    ids = @_destroyed_cmd_ids
+    @_destroyed_cmd_ids = []
+    TkComm._release_cmd_ids(ids) if ids
+  end
+
+  TKCORE_RELEASE_ID = INTERP.register_callback(proc { TkCore._release_destroyed_cmds })
+  INTERP.destroy_watch(proc{|paths| TkCore._widgets_destroyed(paths) })
 
   INTERP.add_tk_procs(TclTkLib::FINALIZE_PROC_NAME, '',
-                      "catch { bind all <#{WIDGET_DESTROY_HOOK}> {} }")
+                      "catch { trace remove execution destroy leave ::tk::rbDestroyFlush }")
 
   # Register callback for TkCore.callback, used by rb_out Tcl proc
   TKCORE_CALLBACK_ID = INTERP.register_callback(proc { |*args| TkCore.callback(*args) })
 
-  INTERP.add_tk_procs('rb_out', 'ns args', <<-EOL)
+  # Body of the rb_out proc, dispatching to ruby_callback <callback_id>.
+  # The commands are built as pure lists, which catch and namespace eval
+  # run directly instead of compiling a concatenated script per event.
+  def TkCore._rb_out_body(callback_id)
+    <<-EOL
     if [regexp {^::} $ns] {
-      set cmd {namespace eval $ns {ruby_callback #{TKCORE_CALLBACK_ID}} $args}
+      set cmd [list namespace eval $ns [list ruby_callback #{callback_id} {*}$args]]
     } else {
-      set cmd {eval {ruby_callback #{TKCORE_CALLBACK_ID}} $ns $args}
+      set cmd [list ruby_callback #{callback_id} $ns {*}$args]
     }
     if {[set st [catch $cmd ret]] != 0} {
        #return -code $st $ret
@@ -482,7 +588,10 @@ module TkCore
     } else {
         return $ret
     }
-  EOL
+    EOL
+  end
+
+  INTERP.add_tk_procs('rb_out', 'ns args', _rb_out_body(TKCORE_CALLBACK_ID))
 
   at_exit{ INTERP.remove_tk_procs(TclTkLib::FINALIZE_PROC_NAME) }
 
@@ -829,6 +938,24 @@ module TkCore
     nil
   end
 
+  # Generate many synthetic events in one call, for replaying recorded
+  # input or driving UI tests.
+  #
+  # @param events [Array] [window, type] or [window, type, fields]
+  #   tuples; type is an event pattern such as "Button-1" or
+  #   "<<Paste>>", fields a Hash of event generate options
+  # @param sync [Boolean] dispatch each event before generating the
+  #   next, instead of queueing them all with -when tail
+  # @return [Hash] {count:, time:} events generated and seconds spent
+  #
+  # @example Replay a click
+  #   Tk.event_generate_many([[btn, 'ButtonPress-1', {x: 5, y: 5}],
+  #                           [btn, 'ButtonRelease-1', {x: 5, y: 5}]],
+  #                          sync: true)
+  def event_generate_many(events, sync: false)
+    TkCore.current_interp.event_generate_many(events, sync: sync)
+  end
+
   # Display a message box dialog.
   #
   # @param keys [Hash] dialog options
@@ -972,15 +1099,16 @@ module TkCore
   # ---------------------------------------------------------
 
   def _ip_eval_core(enc_mode, cmd_string)
+    ip = TkCore.current_interp
     case enc_mode
     when nil
-      res = INTERP._eval(cmd_string)
+      res = ip._eval(cmd_string)
     when false
-      res = INTERP._eval_without_enc(cmd_string)
+      res = ip._eval_without_enc(cmd_string)
     when true
-      res = INTERP._eval_with_enc(cmd_string)
+      res = ip._eval_with_enc(cmd_string)
     end
-    if  INTERP._return_value() != 0
+    if  ip._return_value() != 0
       fail RuntimeError, res, error_at
     end
     return res
@@ -1000,15 +1128,16 @@ module TkCore
   end
 
   def _ip_invoke_core(enc_mode, *args)
+    ip = TkCore.current_interp
     case enc_mode
     when false
-      res = INTERP._invoke_without_enc(*args)
+      res = ip._invoke_without_enc(*args)
     when nil
-      res = INTERP._invoke(*args)
+      res = ip._invoke(*args)
     when true
-      res = INTERP._invoke_with_enc(*args)
+      res = ip._invoke_with_enc(*args)
     end
-    if  INTERP._return_value() != 0
+    if  ip._return_value() != 0
       fail RuntimeError, res, error_at
     end
     return res
@@ -1051,7 +1180,7 @@ module TkCore
         fail err
       end
     end
-    if  INTERP._return_value() != 0
+    if  TkCore.current_interp._return_value() != 0
       fail RuntimeError, res, error_at
     end
     ### print "==> ", res.inspect, "\n" if $DEBUG
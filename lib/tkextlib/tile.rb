@@ -58,6 +58,7 @@ module Tk
   # | {Tk::Tile::Sizegrip} | Window resize grip |
   # | {Tk::Tile::Spinbox} | Numeric entry with arrows |
   # | {Tk::Tile::Treeview} | Hierarchical list/tree |
+  # | {Tk::Tile::VirtualTreeview} | Treeview over a lazily-loaded Ruby model |
   #
   # ## Theming
   #
@@ -230,6 +231,8 @@ module Tk
       rescue
         Tk::Tile::Style.theme_use(theme)
       end
+      # Cached style lookups must not wait for <<ThemeChanged>> at idle
+      Tk::Tile::Style.clear_lookup_cache unless Tk::Tile.autoload?(:Style)
     end
 
     # @!visibility private
@@ -491,6 +494,7 @@ module Tk
     autoload :Sizegrip,      'tkextlib/tile/sizegrip'
 
     autoload :Treeview,      'tkextlib/tile/treeview'
+    autoload :VirtualTreeview, 'tkextlib/tile/virtual_treeview'
 
     autoload :Style,         'tkextlib/tile/style'
   end
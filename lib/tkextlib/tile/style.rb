@@ -99,6 +99,7 @@ class << Tk::Tile::Style
     style = '.' unless style
 
     if keys && keys != None
+      _style_changed
       tk_call(TkCommandNames[0], 'configure', style, *hash_kv(keys))
     else
       tk_call(TkCommandNames[0], 'configure', style)
@@ -115,6 +116,7 @@ class << Tk::Tile::Style
 
     if keys && keys != None
       if keys.kind_of?(Hash)
+        _style_changed
         tk_call(TkCommandNames[0], 'map', style, *hash_kv(keys))
       else
         simplelist(tk_call(TkCommandNames[0], 'map', style, '-' << keys.to_s))
@@ -129,6 +131,20 @@ class << Tk::Tile::Style
   end
   alias map_configure map
 
+  # Apply settings for many styles in one call, e.g. a theme switch:
+  #
+  #   Tk::Tile::Style.restyle(
+  #     '.'        => {configure: {background: '#333', foreground: 'white'}},
+  #     'TButton'  => {map: {background: [['active', '#555']]}})
+  #
+  # Settings that already match are skipped; the rest go out as one
+  # configure and one map per style, and widgets redraw once.
+  # Returns {changed:, skipped:}.
+  def restyle(styles)
+    _style_changed
+    TkCore.current_interp.ttk_restyle(styles)
+  end
+
   def map_configinfo(style=nil, key=None)
     style = '.' unless style
     map(style, key)
@@ -138,10 +154,108 @@ class << Tk::Tile::Style
     map('.', key)
   end
 
+  # Lookups are cached per interpreter and theme, keyed by style,
+  # option and state.
+  # A theme's entries are dropped when styles change through this
+  # module (configure, map, restyle, layout, theme_settings) and on
+  # <<ThemeChanged>>, which ttk sends after any style change. Changes
+  # made directly in Tcl are therefore seen from the next idle pass,
+  # or at once after clear_lookup_cache.
   def lookup(style, opt, state=None, fallback_value=None)
-    tk_call(TkCommandNames[0], 'lookup', style,
-            '-' << opt.to_s, state, fallback_value)
+    style = style.to_s
+    state = state.equal?(None) ? '' : _get_eval_string(state)
+    key = [style, opt.to_s.delete_prefix('-'), state]
+    table = _lookup_cache
+    value = table.fetch(key){
+      table[key] = tk_call(TkCommandNames[0], 'lookup', style, "-#{key[1]}", state)
+    }
+    if value.empty? && !fallback_value.equal?(None)
+      _get_eval_string(fallback_value)
+    else
+      value
+    end
+  end
+
+  # Resolve every option of style's elements (and those configured on it
+  # or its parent styles) in one call and cache them for lookup.
+  # Returns {option => value}.
+  def prefetch(style, state=None)
+    style = style.to_s
+    state = state.equal?(None) ? '' : _get_eval_string(state)
+    values = TkCore.current_interp.ttk_style_options(style, state)
+    table = _lookup_cache
+    values.each{|opt, val| table[[style, opt, state]] = val }
+    values
+  end
+
+  # Forget cached lookups: for theme, or for every theme.
+  def clear_lookup_cache(theme=nil)
+    return unless @lookup_cache
+    ip = TkCore.current_interp
+    if theme
+      @lookup_cache[ip]&.delete(theme.to_s)
+    else
+      @lookup_cache.delete(ip)
+      @lookup_theme.delete(ip)
+    end
+  end
+
+  def _lookup_cache
+    ip = TkCore.current_interp
+    @lookup_cache ||= {}
+    @lookup_theme ||= {}
+    unless (themes = @lookup_cache[ip])
+      [@lookup_cache, @lookup_theme, @theme_watch_id].each{|tbl|
+        tbl.delete_if{|owner, _| owner.deleted? } if tbl
+      }
+      _watch_theme_changes(ip)
+      themes = @lookup_cache[ip] = {}
+    end
+    theme = (@settings_theme && @settings_theme[ip]) ||
+            (@lookup_theme[ip] ||= tk_call(TkCommandNames[0], 'theme', 'use'))
+    themes[theme] ||= {}
   end
+  private :_lookup_cache
+
+  # Style settings (and lookups) apply to the current theme, or inside
+  # a theme_settings block to the theme being set up
+  def _style_changed(theme=nil)
+    ip = TkCore.current_interp
+    return unless @lookup_cache && (themes = @lookup_cache[ip])
+    theme ||= (@settings_theme && @settings_theme[ip]) || @lookup_theme[ip]
+    themes.delete(theme) if theme
+  end
+  private :_style_changed
+
+  # Interp#reset may drop the watcher's callback (when registered after
+  # the snapshot) and any style settings made since: start over with a
+  # fresh callback.
+  def _after_reset(ip)
+    @lookup_cache&.delete(ip)
+    @lookup_theme&.delete(ip)
+    return unless @theme_watch_id && (id = @theme_watch_id.delete(ip))
+    ip.unregister_callback(id)
+    TkCore.with_interp(ip){ _watch_theme_changes(ip) }
+  end
+  private :_after_reset
+
+  # <<ThemeChanged>> goes to every window. The watcher is bound to a
+  # private bindtag that only "." carries, so it runs once per change and
+  # bindings on "." or "all" (user code, test resets) cannot remove it.
+  # The event does not say which theme's settings changed, so all of
+  # ip's are dropped. Re-checked whenever the cache is rebuilt; ip must
+  # be the current interpreter, which the bind calls go to.
+  def _watch_theme_changes(ip)
+    @theme_watch_id ||= {}
+    id = @theme_watch_id[ip] ||= ip.register_callback(proc{
+      @lookup_cache[ip]&.clear if @lookup_cache
+      @lookup_theme&.delete(ip)
+    })
+    tk_call('bind', 'RbStyleWatch', '<<ThemeChanged>>', "ruby_callback #{id}")
+    tags = simplelist(tk_call('bindtags', '.'))
+    tk_call('bindtags', '.', ['RbStyleWatch', *tags]) unless tags.include?('RbStyleWatch')
+  end
+  private :_watch_theme_changes
 
   include Tk::Tile::ParseStyleLayout
 
@@ -153,6 +267,7 @@ class << Tk::Tile::Style
     style = '.' unless style
 
     if spec
+      _style_changed
       tk_call(TkCommandNames[0], 'layout', style, spec)
     else
       _style_layout(list(tk_call(TkCommandNames[0], 'layout', style)))
@@ -236,7 +351,17 @@ class << Tk::Tile::Style
   def theme_settings(name, cmd=nil, &b)
     name = name.to_s
     cmd = b if !cmd && b
-    tk_call(TkCommandNames[0], 'theme', 'settings', name, cmd)
+    _style_changed(name)
+    # cmd runs inside this call; its configure, map and lookup calls use name
+    ip = TkCore.current_interp
+    @settings_theme ||= {}
+    saved = @settings_theme[ip]
+    @settings_theme[ip] = name
+    begin
+      tk_call(TkCommandNames[0], 'theme', 'settings', name, cmd)
+    ensure
+      saved ? @settings_theme[ip] = saved : @settings_theme.delete(ip)
+    end
     name
   end
 
@@ -247,6 +372,9 @@ class << Tk::Tile::Style
   def theme_use(name)
     name = name.to_s
     tk_call(TkCommandNames[0], 'theme', 'use', name)
+    (@lookup_theme ||= {})[TkCore.current_interp] = name
     name
   end
 end
+
+TkCore::INTERP.reset_hook{|ip| Tk::Tile::Style.__send__(:_after_reset, ip) }
@@ -8,6 +8,7 @@
 require 'tk'
 require 'tk/option_dsl'
 require 'tk/item_option_dsl'
+require 'tk/item_registry'
 require 'tkextlib/tile.rb'
 
 module Tk
@@ -137,45 +138,23 @@ end
 
 ########################
 
+# Item wrappers are registered on the treeview itself (see Treeview#itemid2obj).
 class Tk::Tile::Treeview::Item < TkObject
-  ItemID_TBL = TkCore::INTERP.create_table
-
-  TkCore::INTERP.init_ip_env{
-    Tk::Tile::Treeview::Item::ItemID_TBL.mutex.synchronize{
-      Tk::Tile::Treeview::Item::ItemID_TBL.clear
-    }
-  }
-
   def self.id2obj(tree, id)
-    tpath = tree.path
-    Tk::Tile::Treeview::Item::ItemID_TBL.mutex.synchronize{
-      if Tk::Tile::Treeview::Item::ItemID_TBL[tpath]
-        (Tk::Tile::Treeview::Item::ItemID_TBL[tpath][id])? \
-             Tk::Tile::Treeview::Item::ItemID_TBL[tpath][id]: id
-      else
-        id
-      end
-    }
+    tree.itemid2obj(id)
   end
 
   def self.assign(tree, id)
-    tpath = tree.path
-    obj = nil
-    Tk::Tile::Treeview::Item::ItemID_TBL.mutex.synchronize{
-      if Tk::Tile::Treeview::Item::ItemID_TBL[tpath] &&
-          Tk::Tile::Treeview::Item::ItemID_TBL[tpath][id]
-        return Tk::Tile::Treeview::Item::ItemID_TBL[tpath][id]
-      end
-
-      obj = self.allocate
-      obj.instance_eval{
-        @parent = @t = tree
-        @tpath = tpath
-        @path = @id = id
-      }
-      Tk::Tile::Treeview::Item::ItemID_TBL[tpath] ||= {}
-      Tk::Tile::Treeview::Item::ItemID_TBL[tpath][id] = obj
+    obj = tree.itemid2obj(id)
+    return obj if obj.kind_of?(Tk::Tile::Treeview::Item)
+
+    obj = self.allocate
+    obj.instance_eval{
+      @parent = @t = tree
+      @tpath = tree.path
+      @path = @id = id
     }
+    tree._additem(id, obj)
     obj
   end
 
@@ -204,10 +183,7 @@ class Tk::Tile::Treeview::Item < TkObject
     @parent = @t = tree
     @tpath = tree.path
     @path = @id = _insert_item(@t, parent_item, idx, keys)
-    Tk::Tile::Treeview::Item::ItemID_TBL.mutex.synchronize{
-      ItemID_TBL[@tpath] = {} unless ItemID_TBL[@tpath]
-      ItemID_TBL[@tpath][@id] = self
-    }
+    @t._additem(@id, self)
   end
   def id
     @id
@@ -351,7 +327,7 @@ end
 
 # Root represents the treeview's root node (id='').
 # Cached via Treeview#root memoization - no need for complex self.new override.
-# Note: Root is NOT registered in ItemID_TBL because all id2obj calls guard
+# Note: Root is NOT registered with the treeview because all id2obj calls guard
 # against empty id (returning nil instead). The root is accessed via tree.root.
 class Tk::Tile::Treeview::Root < Tk::Tile::Treeview::Item
   def initialize(tree, keys = {})
@@ -367,30 +343,14 @@ end
 class Tk::Tile::Treeview::Tag < TkObject
   include TkTreatTagFont
 
-  TagID_TBL = TkCore::INTERP.create_table
-
   (Tag_ID = ['tile_treeview_tag'.freeze, '00000']).instance_eval{
     @mutex = Mutex.new
     def mutex; @mutex; end
     freeze
   }
 
-  TkCore::INTERP.init_ip_env{
-    Tk::Tile::Treeview::Tag::TagID_TBL.mutex.synchronize{
-      Tk::Tile::Treeview::Tag::TagID_TBL.clear
-    }
-  }
-
   def self.id2obj(tree, id)
-    tpath = tree.path
-    Tk::Tile::Treeview::Tag::TagID_TBL.mutex.synchronize{
-      if Tk::Tile::Treeview::Tag::TagID_TBL[tpath]
-        (Tk::Tile::Treeview::Tag::TagID_TBL[tpath][id])? \
-               Tk::Tile::Treeview::Tag::TagID_TBL[tpath][id]: id
-      else
-        id
-      end
-    }
+    tree.tagid2obj(id)
   end
 
   def initialize(tree, keys=nil)
@@ -400,10 +360,7 @@ class Tk::Tile::Treeview::Tag < TkObject
       @path = @id = Tag_ID.join(TkCore::INTERP._ip_id_)
       Tag_ID[1].succ!
     }
-    TagID_TBL.mutex.synchronize{
-      TagID_TBL[@tpath] = {} unless TagID_TBL[@tpath]
-      TagID_TBL[@tpath][@id] = self
-    }
+    @t._addtag(@id, self)
     if keys && keys != None
       tk_call_without_enc(@tpath, 'tag', 'configure', @id, *hash_kv(keys,true))
     end
@@ -542,12 +499,40 @@ class Tk::Tile::Treeview < TkWindow
   item_option :image,         type: :string    # icon image
 
   def __destroy_hook__
-    Tk::Tile::Treeview::Item::ItemID_TBL.mutex.synchronize{
-      Tk::Tile::Treeview::Item::ItemID_TBL.delete(@path)
-    }
-    Tk::Tile::Treeview::Tag::ItemID_TBL.mutex.synchronize{
-      Tk::Tile::Treeview::Tag::ItemID_TBL.delete(@path)
-    }
+    @items = nil
+    @tags = nil
+  end
+
+  # @!visibility private
+  def _additem(id, obj)
+    (@items ||= {})[id] = obj
+  end
+
+  # @!visibility private
+  def _addtag(id, obj)
+    (@tags ||= {})[id] = obj
+  end
+
+  # Looks up the Item wrapper registered for an item id.
+  # @param id [String] item id
+  # @return [Item, String] the wrapper, or the id if none was created
+  def itemid2obj(id)
+    return id unless @items
+    @items[id] || id
+  end
+
+  # Looks up the Tag object registered for a tag name.
+  # @param id [String] tag name
+  # @return [Tag, String] the Tag, or the name if none was created
+  def tagid2obj(id)
+    return id unless @tags
+    @tags[id] || id
+  end
+
+  # Sizes of this treeview's item and tag registries.
+  # @return [Hash{Symbol=>Hash}] e.g. {items: {count: 3, bytes: 512}, tags: {...}}
+  def registry_report
+    Tk::ItemRegistry.report(items: @items, tags: @tags)
   end
 
   def self.style(*args)
@@ -586,10 +571,35 @@ class Tk::Tile::Treeview < TkWindow
   end
 
   def delete(*items)
-    tk_send_without_enc('delete', array2tk_list(items.flatten, true))
+    items = items.flatten
+    if items.size == 1 && @items && !@items.empty?
+      # A leaf takes nothing else with it: drop just its wrapper
+      item = _get_eval_enc_str(items[0])
+      leaf = simplelist(tk_send_without_enc('children', item)).empty?
+      tk_send_without_enc('delete', item)
+      leaf ? @items.delete(tagid(items[0])) : _prune_items
+    else
+      tk_send_without_enc('delete', array2tk_list(items, true))
+      _prune_items
+    end
     self
   end
 
+  # Drop wrappers for items that no longer exist. Deleting an item also
+  # deletes its descendants, so after deleting several items or one with
+  # children all registered ids are checked, in one Tcl call. The loop
+  # runs in its own frame so it leaves the application's globals alone.
+  def _prune_items
+    return if @items.nil? || @items.empty?
+    ids = @items.keys
+    alive = tk_call_without_enc('apply', '{w ids} {lmap id $ids {$w exists $id}}',
+                                @path, array2tk_list(ids, true))
+    simplelist(alive).each_with_index{|flag, i|
+      @items.delete(ids[i]) if flag == '0'
+    }
+  end
+  private :_prune_items
+
   def detach(*items)
     tk_send_without_enc('detach', array2tk_list(items.flatten, true))
     self
@@ -664,6 +674,136 @@ class Tk::Tile::Treeview < TkWindow
     Tk::Tile::Treeview::Item.new(self, parent, idx, keys)
   end
 
+  # Insert many rows in a single bridge call.
+  #
+  # Unlike #insert, no Item wrapper is created or registered per row.
+  # The -values lists are built directly in C. Wrap ids on demand with
+  # Item.id2obj / Item.assign.
+  #
+  # @param parent [String, Item] parent item ('' for top level)
+  # @param rows [Array<Array>, Hash{String=>Array}] row-major value arrays,
+  #   or a columnar Hash of column name => column values
+  # @param columns [Array<String>, nil] columns the row values are given in
+  #   (default: the treeview's -columns order, or the Hash keys)
+  # @param index [Integer, String] position of the first row (default 'end')
+  # @param text [Array<String>, nil] per-row label for the tree column
+  # @param tags [Array<String>, nil] tags applied to every inserted row
+  # @return [Array<String>] inserted item ids, in row order
+  #
+  # @example Load a grid
+  #   ids = tree.insert_rows('', [["a.txt", 12], ["b.txt", 40]],
+  #                          columns: ["name", "size"])
+  #   Tk::Tile::Treeview::Item.assign(tree, ids.first).see
+  #
+  def insert_rows(parent, rows, columns: nil, index: 'end', text: nil, tags: nil)
+    opts = {}
+    if rows.kind_of?(Hash)
+      columns = (columns || rows.keys).map(&:to_s)
+      by_name = rows.transform_keys(&:to_s)
+      data = columns.map{|col| by_name.fetch(col).to_a }
+      opts[:columnar] = true
+    else
+      data = rows.to_a
+    end
+
+    if columns
+      columns = columns.map(&:to_s)
+      tree_columns = simplelist(tk_send_without_enc('cget', '-columns'))
+      opts[:map] = tree_columns.map{|col| columns.index(col) || -1 }
+    end
+    opts[:text] = text.to_a if text
+    opts[:tags] = array2tk_list(tags.flatten, true) if tags
+
+    parent = (parent.nil? || parent == None)? '' : tagid(parent)
+    index = _get_eval_string(index) unless index.kind_of?(Integer)
+
+    TkCore::INTERP.treeview_insert_rows(@path, parent, index, data, opts)
+  end
+
+  # Sort the children of +parent+ by one column.
+  #
+  # Values are fetched and sorted in C (stable, typed keys) and the new
+  # order is applied with a single `children` call, so open state and
+  # grandchildren are preserved. Values that do not parse as +type+ sort
+  # last. While #filter is active, hidden rows are sorted too.
+  #
+  # @param col [String] column id, or '#0' for the tree column text
+  # @param type [Symbol] :string, :numeric, :natural ("file9" < "file10")
+  #   or :date (ISO 8601, or anything `clock scan` accepts)
+  # @param descending [Boolean] reverse the order
+  # @param parent [String, Item] item whose children are sorted
+  # @return [Array<String>] item ids in the new order
+  #
+  # @example Sort on heading click
+  #   tree.heading_configure('size', command: proc {
+  #     tree.sort_by_column('size', type: :numeric)
+  #   })
+  #
+  def sort_by_column(col, type: :string, descending: false, parent: '')
+    parent = (parent.nil? || parent == None)? '' : tagid(parent).to_s
+    col = _get_eval_string(col)
+    opts = { type: type, descending: descending }
+
+    all = @filtered_items && @filtered_items[parent]
+    return TkCore::INTERP.treeview_sort_column(@path, parent, col, opts) unless all
+
+    sorted = TkCore::INTERP.treeview_sort_column(@path, parent, col,
+                                                 opts.merge(items: all, apply: false))
+    @filtered_items[parent] = sorted
+    shown = {}
+    simplelist(tk_send_without_enc('children', parent)).each{|id| shown[id] = true }
+    visible = sorted.select{|id| shown[id] }
+    set_children(parent, visible)
+    visible
+  end
+
+  # Show only the children of +parent+ whose +col+ value matches the block.
+  #
+  # Column values are fetched in one bulk call; rows failing the predicate
+  # are detached (not deleted) and come back, in order, when the filter is
+  # changed or cleared. Call without a block to clear the filter.
+  # Filters are not cumulative: each call tests every row again.
+  #
+  # Delete or insert rows only while no filter is active on +parent+.
+  #
+  # @param col [String] column id, or '#0' for the tree column text
+  # @param parent [String, Item] item whose children are filtered
+  # @yieldparam value [String] the row's value in +col+
+  # @yieldparam id [String] the row's item id
+  # @return [Array<String>] ids of the visible rows
+  #
+  # @example
+  #   tree.filter('size') {|v| v.to_i > 1024 }
+  #   tree.filter('size')   # show everything again
+  #
+  def filter(col, parent: '', &block)
+    parent = (parent.nil? || parent == None)? '' : tagid(parent).to_s
+    @filtered_items ||= {}
+    all = @filtered_items[parent]
+
+    unless block
+      return simplelist(tk_send_without_enc('children', parent)) unless all
+      @filtered_items.delete(parent)
+      set_children(parent, all)
+      return all
+    end
+
+    all ||= simplelist(tk_send_without_enc('children', parent))
+    ids, values = TkCore::INTERP.treeview_column_values(@path, parent,
+                                                        _get_eval_string(col), all)
+    visible = []
+    ids.each_with_index{|id, i| visible << id if block.call(values[i], id) }
+    @filtered_items[parent] = all
+    set_children(parent, visible)
+    visible
+  end
+
+  # True while #filter hides rows under +parent+.
+  def filtered?(parent = '')
+    parent = (parent.nil? || parent == None)? '' : tagid(parent).to_s
+    !!(@filtered_items && @filtered_items[parent])
+  end
+
   def move(item, parent, idx)
     tk_send('move', item, parent, idx)
     self
@@ -798,6 +938,10 @@ class Tk::Tile::Treeview < TkWindow
 
 end
 
+# Add deprecation warnings for removed ItemID_TBL/TagID_TBL constants
+Tk::Tile::Treeview::Item.extend(TkTreeviewItemCompat)
+Tk::Tile::Treeview::Tag.extend(TkTreeviewTagCompat)
+
 #Tk.__set_toplevel_aliases__(:Ttk, Tk::Tile::Treeview, :TkTreeview)
 Tk.__set_loaded_toplevel_aliases__('tkextlib/tile/treeview.rb',
                                    :Ttk, Tk::Tile::Treeview, :TkTreeview)
@@ -0,0 +1,492 @@
+# frozen_string_literal: false
+#
+#  virtual (lazy-loading) treeview widget
+#
+# A ttk::treeview that only materializes the rows around the visible page.
+# Row data is pulled from a Ruby model as the view scrolls; item ids are
+# recycled as rows scroll out of the window.
+#
+# See: https://www.tcl-lang.org/man/tcl/TkCmd/ttk_treeview.html
+#
+require 'tk'
+require 'tkextlib/tile.rb'
+require 'tkextlib/tile/treeview'
+
+module Tk
+  module Tile
+    class VirtualTreeview < Treeview
+    end
+  end
+end
+
+# Treeview whose rows come from a Ruby model instead of being inserted.
+#
+# Only the visible page plus +margin+ rows on each side exist as Tk items.
+# Scrolling through the scrollbar (#yview) or inside the widget (mouse
+# wheel, keyboard, #see) slides that window over the model; items whose
+# rows leave the window are reused for rows entering it. Selection and
+# focus are tracked by model row, so they survive recycling.
+#
+# == Model protocol
+#
+#   model.row_count            # => Integer, number of top-level rows
+#   model.row(index)           # => row (see below)
+#   model.rows(first, count)   # => Array of rows (optional, batched fetch)
+#   model.children?(index)     # => Boolean (optional; shows the open indicator)
+#   model.children(index)      # => Array of rows, loaded on <<TreeviewOpen>>
+#
+# A row is an Array of column values (in -columns order), or a Hash with
+# :text, :values and :tags keys.
+#
+# Children are one level deep and are inserted as ordinary items while
+# their parent is materialized.
+#
+# @example
+#   class Numbers
+#     def row_count = 10_000_000
+#     def row(i) = { text: "Row #{i}", values: [i, i * i] }
+#   end
+#
+#   tree = Tk::Tile::VirtualTreeview.new(root, model: Numbers.new,
+#                                        columns: %w[n square])
+#   sb = Tk::Tile::YScrollbar.new(root)
+#   tree.yscrollbar(sb)
+#
+# Keys (model row indices) are Integers for top-level rows and
+# [row, child_index] pairs for children.
+class Tk::Tile::VirtualTreeview < Tk::Tile::Treeview
+  # Extra rows materialized above and below the page (default: one page)
+  attr_reader :margin
+
+  attr_reader :model
+
+  def initialize(parent=nil, keys=nil)
+    opts = parent.kind_of?(Hash) ? parent : keys
+    if opts
+      opts = _symbolkey2str(opts)
+      model = opts.delete('model')
+      margin = opts.delete('margin')
+      if parent.kind_of?(Hash)
+        parent = opts
+      else
+        keys = opts
+      end
+    end
+    super(parent, keys)
+    _init_virtual(model, margin)
+  end
+
+  def model=(model)
+    @model = model
+    reload
+  end
+
+  def margin=(rows)
+    @margin = rows && Integer(rows)
+    _refresh
+  end
+
+  # Drop all materialized rows and re-read the model.
+  # Call after the model's rows change.
+  def reload
+    _sync_selection
+    _release_rows(@row_slot.keys)
+    @open.clear
+    @open_rows.clear
+    @selected.delete_if{|key, _| !_valid_key?(key) }
+    @focus_key = nil unless @focus_key && _valid_key?(@focus_key)
+    _refresh
+    self
+  end
+
+  # Total number of displayed lines (top-level rows plus open children).
+  def line_count
+    count = @model ? @model.row_count : 0
+    @open.each_value{|rows| count += rows.size }
+    count
+  end
+
+  # Line index of the first visible row.
+  def first_line
+    @first
+  end
+
+  # Model key for a materialized item id, or nil.
+  def row_for(item)
+    id = tagid(item)
+    @slot_row[id] || @child_key[id]
+  end
+
+  # Item id currently showing +key+, or nil when it is not materialized.
+  def item_for(key)
+    if key.kind_of?(Array)
+      (kids = @children[key[0]]) && !@placeholder[key[0]] ? kids[key[1]] : nil
+    else
+      @row_slot[key]
+    end
+  end
+
+  # Selected model keys, including rows that are scrolled out of the window.
+  def selected_rows
+    _sync_selection
+    @selected.keys
+  end
+
+  def selected_rows=(keys)
+    @selected = {}
+    keys.each{|key| @selected[key] = true }
+    _restore_selection
+  end
+
+  # Scroll so that top-level row +row+ is visible.
+  def see_row(row)
+    line = _line_of_row(row)
+    page = _page_size
+    if line < @first
+      @first = line
+    elsif line >= @first + page
+      @first = line - page + 1
+    end
+    _refresh
+    self
+  end
+
+  ###################
+  # yview protocol
+
+  def yview(*index)
+    if index.empty?
+      return _fractions
+    end
+
+    page = _page_size
+    case index[0].to_s
+    when 'moveto'
+      @first = (Float(index[1]) * line_count).floor
+    when 'scroll'
+      count = Integer(index[1])
+      @first += (index[2].to_s.start_with?('page'))? count * page : count
+    else
+      @first = Integer(index[0])
+    end
+    _refresh
+    self
+  end
+
+  def yscrollcommand(cmd=nil, &block)
+    @yscroll_observer = cmd || block
+    _notify_scroll
+    self
+  end
+
+  # Same arguments as YScrollable#yscrollbar. Rows are paged in from
+  # Ruby, so the bar is always driven from here: native: has no Tcl
+  # link to make and is accepted as is. A block is an observer, called
+  # with the first and last visible fractions whenever the view moves.
+  def yscrollbar(bar=nil, native: false, &observer)
+    if bar
+      @yscrollbar = bar
+      @yscrollbar.orient 'vertical'
+      @yscrollbar.command {|*arg| self.yview(*arg)}
+    end
+    @yscrollbar_observer = observer if observer
+    _notify_scroll if bar || observer
+    @yscrollbar
+  end
+
+  def __destroy_hook__
+    @model = nil
+    super
+  end
+
+  ###################
+  private
+
+  def _init_virtual(model, margin)
+    @model = model
+    @margin = margin && Integer(margin)
+    @first = 0
+    @window = nil       # Range of materialized top-level rows
+    @row_slot = {}      # row => item id
+    @slot_row = {}      # item id => row
+    @free = []          # detached item ids ready for reuse
+    @children = {}      # row => [child item ids]
+    @child_key = {}     # child item id => [row, index]
+    @placeholder = {}   # row => true while its only child is a placeholder
+    @open = {}          # row => [child rows] for expanded rows
+    @open_rows = []     # sorted keys of @open
+    @selected = {}      # key => true
+    @focus_key = nil
+
+    # Scrolling inside the widget (wheel, keys, see) reports here first
+    configure_cmd 'yscrollcommand', proc{|f0, f1| _tree_scrolled(f0, f1) }
+
+    bind_append('<TreeviewSelect>'){ _sync_selection }
+    bind_append('<TreeviewOpen>'){ _open_row(tk_send_without_enc('focus')) }
+    bind_append('<TreeviewClose>'){ _close_row(tk_send_without_enc('focus')) }
+
+    _refresh
+  end
+
+  def _page_size
+    height = Integer(tk_send_without_enc('cget', '-height')) rescue 0
+    (height > 0)? height : 10
+  end
+
+  def _margin
+    @margin || _page_size
+  end
+
+  def _line_of_row(row)
+    line = row
+    @open_rows.each{|r|
+      break if r >= row
+      line += @open[r].size
+    }
+    line
+  end
+
+  # [row, child_index] displayed at +line+ (child_index nil for a top row)
+  def _row_at_line(line)
+    extra = 0
+    @open_rows.each{|r|
+      start = r + extra
+      return [line - extra, nil] if line < start
+      return [r, nil] if line == start
+      return [r, line - start - 1] if line <= start + @open[r].size
+      extra += @open[r].size
+    }
+    [line - extra, nil]
+  end
+
+  def _window_line_count
+    return 0 unless @window && @window.first <= @window.last
+    last = @window.last
+    _line_of_row(last) + 1 + (@open[last] ? @open[last].size : 0) -
+      _line_of_row(@window.first)
+  end
+
+  def _valid_key?(key)
+    return false unless @model
+    row = key.kind_of?(Array) ? key[0] : key
+    row >= 0 && row < @model.row_count
+  end
+
+  def _fractions
+    total = line_count
+    return [0.0, 1.0] if total == 0
+    [@first.fdiv(total), [(@first + _page_size).fdiv(total), 1.0].min]
+  end
+
+  def _notify_scroll
+    return unless @first  # not initialized yet
+    first, last = _fractions
+    @yscrollbar.set(first, last) if @yscrollbar
+    @yscroll_observer.call(first, last) if @yscroll_observer
+    @yscrollbar_observer.call(first, last) if @yscrollbar_observer
+  end
+
+  def _tree_scrolled(f0, _f1)
+    return unless @window
+    top = _line_of_row(@window.first) +
+          (Float(f0) * _window_line_count).round
+    if top != @first
+      @first = top
+      _schedule_refresh
+    end
+    _notify_scroll
+  end
+
+  def _schedule_refresh
+    return if @refresh_pending
+    @refresh_pending = true
+    Tk.after_idle{
+      @refresh_pending = false
+      _refresh unless @model.nil?
+    }
+  end
+
+  # Slide the materialized window so it covers @first +/- margin.
+  def _refresh
+    return unless @row_slot  # not initialized yet
+    _sync_selection if @window
+
+    total = line_count
+    page = _page_size
+    margin = _margin
+    @first = @first.clamp(0, [total - page, 0].max)
+
+    if total == 0
+      _release_rows(@row_slot.keys)
+      set_children('')
+      @window = nil
+      _notify_scroll
+      return
+    end
+
+    top = _row_at_line([@first - margin, 0].max)[0]
+    bottom = _row_at_line([@first + page + margin, total].min - 1)[0]
+    window = top..bottom
+
+    _release_rows(@row_slot.keys.reject{|row| window.cover?(row) })
+    _materialize(window.reject{|row| @row_slot.key?(row) })
+
+    set_children('', window.map{|row| @row_slot[row] })
+    @window = window
+    tk_send_without_enc('yview', @first - _line_of_row(top))
+
+    _restore_selection
+    _notify_scroll
+  end
+
+  def _release_rows(rows)
+    return if rows.empty?
+    kids = []
+    rows.each{|row|
+      slot = @row_slot.delete(row)
+      @slot_row.delete(slot)
+      @placeholder.delete(row)
+      if (ids = @children.delete(row))
+        ids.each{|id| @child_key.delete(id) }
+        kids.concat(ids)
+      end
+      @free << slot
+    }
+    delete(kids) unless kids.empty?
+  end
+
+  def _fetch_rows(rows)
+    return [] if rows.empty?
+    if @model.respond_to?(:rows)
+      data = []
+      rows.chunk_while{|a, b| b == a + 1 }.each{|run|
+        data.concat(@model.rows(run.first, run.size).to_a)
+      }
+      data
+    else
+      rows.map{|row| @model.row(row) }
+    end
+  end
+
+  def _normalize_row(row)
+    if row.kind_of?(Hash)
+      [row[:text] || row['text'] || '',
+       (row[:values] || row['values'] || []).to_a,
+       row[:tags] || row['tags']]
+    else
+      ['', row.to_a, nil]
+    end
+  end
+
+  def _materialize(rows)
+    return if rows.empty?
+    need = rows.size - @free.size
+    @free.concat(insert_rows('', Array.new(need){ [] })) if need > 0
+
+    has_children = @model.respond_to?(:children?)
+    _fetch_rows(rows).each_with_index{|data, i|
+      row = rows[i]
+      slot = @free.pop
+      text, values, tags = _normalize_row(data)
+      tk_send_without_enc('item', slot,
+                          '-text', _get_eval_string(text),
+                          '-values', array2tk_list(values, true),
+                          '-tags', array2tk_list(Array(tags), true),
+                          '-open', (@open[row])? 1 : 0)
+      @row_slot[row] = slot
+      @slot_row[slot] = row
+
+      if @open[row]
+        _insert_children(row, slot)
+      elsif has_children && @model.children?(row)
+        @children[row] = [tk_send_without_enc('insert', slot, 'end')]
+        @placeholder[row] = true
+      end
+    }
+  end
+
+  def _insert_children(row, slot)
+    rows = @open[row].map{|data| _normalize_row(data) }
+    ids = insert_rows(slot, rows.map{|_, values, _| values },
+                      text: rows.map{|text, _, _| text })
+    rows.each_with_index{|(_, _, tags), i|
+      tk_send_without_enc('item', ids[i], '-tags',
+                          array2tk_list(Array(tags), true)) if tags
+      @child_key[ids[i]] = [row, i]
+    }
+    @children[row] = ids
+  end
+
+  def _open_row(item)
+    key = item && row_for(item)
+    return unless key.kind_of?(Integer) && !@open[key]
+    return unless @model.respond_to?(:children)
+
+    slot = @row_slot[key]
+    if (ids = @children.delete(key))
+      ids.each{|id| @child_key.delete(id) }
+      delete(ids)
+    end
+    @placeholder.delete(key)
+
+    @open[key] = @model.children(key).to_a
+    @open_rows.insert(@open_rows.bsearch_index{|r| r > key } || @open_rows.size, key)
+    _insert_children(key, slot)
+    _schedule_refresh
+  end
+
+  def _close_row(item)
+    key = item && row_for(item)
+    return unless key.kind_of?(Integer) && @open.delete(key)
+
+    @open_rows.delete(key)
+    @selected.delete_if{|k, _| k.kind_of?(Array) && k[0] == key }
+    if (ids = @children.delete(key))
+      ids.each{|id| @child_key.delete(id) }
+      delete(ids)
+    end
+    if @model.respond_to?(:children?) && @model.children?(key)
+      @children[key] = [tk_send_without_enc('insert', @row_slot[key], 'end')]
+      @placeholder[key] = true
+    end
+    _schedule_refresh
+  end
+
+  def _materialized_key?(key)
+    if key.kind_of?(Array)
+      !item_for(key).nil?
+    else
+      @row_slot.key?(key)
+    end
+  end
+
+  # Fold the widget's current selection/focus into the row-keyed state.
+  def _sync_selection
+    return unless @window
+    @selected.delete_if{|key, _| _materialized_key?(key) }
+    simplelist(tk_send_without_enc('selection')).each{|id|
+      key = row_for(id)
+      @selected[key] = true if key
+    }
+    focus = tk_send_without_enc('focus')
+    if (key = row_for(focus))
+      @focus_key = key
+    end
+  end
+
+  def _restore_selection
+    return unless @window
+    want = @selected.keys.map{|key| item_for(key) }.compact
+    have = simplelist(tk_send_without_enc('selection'))
+    unless want.sort == have.sort
+      tk_send_without_enc('selection', 'set', array2tk_list(want, true))
+    end
+
+    focus = @focus_key && item_for(@focus_key)
+    tk_send_without_enc('focus', focus || '')
+  end
+end
+
+Tk.__set_loaded_toplevel_aliases__('tkextlib/tile/virtual_treeview.rb',
+                                   :Ttk, Tk::Tile::VirtualTreeview,
+                                   :TkVirtualTreeview)
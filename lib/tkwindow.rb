@@ -749,37 +749,15 @@ class TkWindow<TkObject
 
     super
 
-    # Find all descendants (not just direct children)
-    # Tk's destroy command destroys all descendants, so we need to mark them all
-    descendants = []
-    prefix = self.path + "."
-    TkCore::INTERP.tk_windows.each{|path, obj|
-      descendants << [path, obj] if path.start_with?(prefix)
-    }
-
-    if defined?(@cmdtbl)
-      for id in @cmdtbl
-        uninstall_cmd id
-      end
-    end
-
-    descendants.each{|path, obj|
-      obj.instance_eval{
-        @destroyed = true  # Mark all descendants as destroyed
-        if defined?(@cmdtbl)
-          for id in @cmdtbl
-            uninstall_cmd id
-          end
-        end
-      }
-      TkCore::INTERP.tk_windows.delete(path)
-    }
-
+    # Tk reports this widget and every descendant to
+    # TkCore._widgets_destroyed in one batch when 'destroy' returns;
+    # that marks them destroyed, drops their table entries and releases
+    # their callbacks.
     begin
       tk_call_without_enc('destroy', epath)
     rescue
     end
-    uninstall_win
+    uninstall_win if TkCore::INTERP.tk_windows[@path].equal?(self)
   end
 
   # Block until this widget becomes visible.
@@ -0,0 +1,171 @@
+# frozen_string_literal: true
+
+# Parallel test runner.
+#
+# Shards test files across N processes. Each process gets its own X
+# display (a private Xvfb when one is installed) and its own TkWorker,
+# which keeps one interpreter alive for all of that shard's tests and
+# resets it between them. Per-test timings are collected from every
+# shard; the slowest tests are reported, and the per-file totals are
+# kept so the next run balances shards by time instead of file count.
+#
+# Usage:
+#   ruby test/parallel_runner.rb [-j N] [test files...]
+#   rake test:parallel JOBS=N
+
+require 'etc'
+require 'fileutils'
+require 'json'
+require 'rbconfig'
+require 'tmpdir'
+
+class ParallelRunner
+  PROJECT_ROOT = File.expand_path('..', __dir__)
+  TIMINGS_FILE = File.join(PROJECT_ROOT, 'tmp', 'test_timings.json')
+  SLOWEST_SHOWN = 15
+
+  # Default estimate for files without a recorded time
+  DEFAULT_FILE_TIME = 1.0
+
+  Shard = Struct.new(:id, :files, :pid, :xvfb_pid, :log, :timings, :status)
+
+  attr_reader :jobs, :files
+
+  def initialize(files, jobs: Etc.nprocessors)
+    @files = files.map { |f| File.expand_path(f, PROJECT_ROOT) }
+                  .reject { |f| File.basename(f) == 'test_helper.rb' }
+    @jobs = [[jobs, 1].max, @files.size].min
+  end
+
+  # Returns true if every shard passed
+  def run
+    return true if files.empty?
+
+    @workdir = Dir.mktmpdir('tk_parallel')
+    shards = build_shards
+    puts "Running #{files.size} test files in #{shards.size} processes..."
+
+    started = Process.clock_gettime(Process::CLOCK_MONOTONIC)
+    shards.each { |shard| start_shard(shard) }
+    shards.each { |shard| wait_shard(shard) }
+    elapsed = Process.clock_gettime(Process::CLOCK_MONOTONIC) - started
+
+    report(shards, elapsed)
+    save_timings(shards)
+    shards.all? { |s| s.status&.success? }
+  ensure
+    FileUtils.rm_rf(@workdir) if @workdir
+  end
+
+  private
+
+  # Longest file first onto the least loaded shard
+  def build_shards
+    known = File.exist?(TIMINGS_FILE) ? JSON.parse(File.read(TIMINGS_FILE)) : {}
+    shards = Array.new(jobs) { |i| Shard.new(i, []) }
+    loads = Array.new(jobs, 0.0)
+
+    files.sort_by { |f| -(known[relative(f)] || DEFAULT_FILE_TIME) }.each do |file|
+      i = loads.each_with_index.min_by(&:first).last
+      shards[i].files << file
+      loads[i] += known[relative(file)] || DEFAULT_FILE_TIME
+    end
+    shards.reject { |s| s.files.empty? }
+  end
+
+  def start_shard(shard)
+    shard.log = File.join(@workdir, "shard_#{shard.id}.log")
+    shard.timings = File.join(@workdir, "shard_#{shard.id}.jsonl")
+
+    env = {
+      'TK_WORKER_ID' => "#{Process.pid}_#{shard.id}",
+      'TK_TEST_TIMINGS' => shard.timings,
+    }
+    display = start_display(shard)
+    env['DISPLAY'] = display if display
+    env['COVERAGE_NAME'] = "#{ENV['COVERAGE_NAME'] || 'default'}_#{shard.id}" if ENV['COVERAGE']
+
+    loader = 'ARGV.each { |f| require f }'
+    shard.pid = Process.spawn(env, RbConfig.ruby, '-I', File.join(PROJECT_ROOT, 'lib'),
+                              '-I', File.join(PROJECT_ROOT, 'test'), '-e', loader,
+                              *shard.files, in: :close, out: shard.log, err: [:child, :out])
+  end
+
+  # Start a private Xvfb for the shard and return its DISPLAY, or nil to
+  # share the current display (no Xvfb, or not an X11 platform).
+  def start_display(shard)
+    return nil unless RbConfig::CONFIG['host_os'] =~ /linux|bsd/ && xvfb
+
+    r, w = IO.pipe
+    shard.xvfb_pid = Process.spawn(xvfb, '-displayfd', w.fileno.to_s, '-screen', '0', '1280x1024x24',
+                                   '-nolisten', 'tcp', w.fileno => w, out: File::NULL, err: File::NULL)
+    w.close
+    number = IO.select([r], nil, nil, 10) && r.gets
+    r.close
+    raise "Xvfb for shard #{shard.id} did not start" unless number
+
+    ":#{number.strip}"
+  end
+
+  def xvfb
+    return @xvfb if defined?(@xvfb)
+    @xvfb = ENV['PATH'].split(File::PATH_SEPARATOR)
+                       .map { |dir| File.join(dir, 'Xvfb') }
+                       .find { |path| File.executable?(path) }
+  end
+
+  def wait_shard(shard)
+    _, shard.status = Process.wait2(shard.pid)
+  ensure
+    if shard.xvfb_pid
+      Process.kill('TERM', shard.xvfb_pid) rescue nil
+      Process.wait(shard.xvfb_pid) rescue nil
+    end
+  end
+
+  def read_timings(shard)
+    return [] unless File.exist?(shard.timings)
+    File.readlines(shard.timings).map { |line| JSON.parse(line, symbolize_names: true) }
+  end
+
+  def report(shards, elapsed)
+    shards.each do |shard|
+      result = shard.status.success? ? 'passed' : 'FAILED'
+      puts "\n=== Shard #{shard.id} (#{shard.files.size} files) #{result} ==="
+      puts File.read(shard.log)
+    end
+
+    tests = shards.flat_map { |shard| read_timings(shard) }
+    serial = tests.sum { |t| t[:time] }
+    puts "\nSlowest tests:"
+    tests.max_by(SLOWEST_SHOWN) { |t| t[:time] }.each do |t|
+      puts format('  %8.3fs  %s (%s)', t[:time], t[:test], relative(t[:file].to_s))
+    end
+    puts format("\n%d tests, %.1fs in tests, %.1fs wall clock with %d processes",
+                tests.size, serial, elapsed, shards.size)
+  end
+
+  def save_timings(shards)
+    per_file = File.exist?(TIMINGS_FILE) ? JSON.parse(File.read(TIMINGS_FILE)) : {}
+    shards.flat_map { |shard| read_timings(shard) }
+          .group_by { |t| relative(t[:file].to_s) }
+          .each { |file, tests| per_file[file] = tests.sum { |t| t[:time] }.round(3) }
+
+    FileUtils.mkdir_p(File.dirname(TIMINGS_FILE))
+    File.write(TIMINGS_FILE, JSON.pretty_generate(per_file.sort.to_h))
+  end
+
+  def relative(file)
+    file.delete_prefix("#{PROJECT_ROOT}/")
+  end
+end
+
+if __FILE__ == $0
+  jobs = Etc.nprocessors
+  if (i = ARGV.index('-j'))
+    jobs = Integer(ARGV[i + 1])
+    ARGV.slice!(i, 2)
+  end
+  files = ARGV.empty? ? Dir[File.join(ParallelRunner::PROJECT_ROOT, 'test', '**', 'test_*.rb')].sort : ARGV
+  exit ParallelRunner.new(files, jobs: jobs).run
+end
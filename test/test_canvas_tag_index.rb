@@ -0,0 +1,84 @@
+# frozen_string_literal: true
+
+# Tests for the optional Ruby-side canvas tag index (Tk::CanvasTagIndex)
+
+require_relative 'test_helper'
+require_relative 'tk_test_helper'
+require 'tk'
+
+class TestCanvasTagIndex < Minitest::Test
+  include TkTestHelper
+
+  def test_tag_index_tracks_wrapper_calls
+    assert_tk_app("canvas tag index follows wrapper calls", method(:app_tag_index_wrapper))
+  end
+
+  def app_tag_index_wrapper
+    require 'tk'
+    require 'tk/canvas'
+
+    errors = []
+    canvas = TkCanvas.new(root)
+    canvas.enable_tag_index(check: true)  # every answer verified against Tcl
+
+    a = TkcRectangle.new(canvas, 0, 0, 10, 10, tags: ['node', 'red'])
+    b = TkcOval.new(canvas, 20, 20, 30, 30, tags: 'node')
+    c = TkcLine.new(canvas, 0, 0, 5, 5)
+
+    errors << "index should be on" unless canvas.tag_index?
+    errors << "items_with_tag(node) wrong" unless canvas.items_with_tag('node') == [a, b]
+    errors << "item_tags wrong" unless canvas.item_tags(a).map(&:to_s) == ['node', 'red']
+    errors << "tag? wrong" unless canvas.tag?(a, 'red') && !canvas.tag?(b, 'red')
+    errors << "all wrong" unless canvas.items_with_tag('all') == [a, b, c]
+
+    canvas.addtag_withtag('picked', 'node')
+    errors << "addtag withtag not indexed" unless canvas.items_with_tag('picked') == [a, b]
+
+    canvas.dtag(a, 'picked')
+    errors << "dtag not indexed" unless canvas.items_with_tag('picked') == [b]
+
+    canvas.addtag_all('everything')
+    errors << "addtag all not indexed" unless canvas.items_with_tag('everything').size == 3
+
+    canvas.delete('red')
+    errors << "delete not indexed" unless canvas.items_with_tag('node') == [b]
+    errors << "deleted item still tagged" if canvas.tag?(a.id, 'node')
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_tag_index_falls_back_after_raw_tcl
+    assert_tk_app("canvas tag index rebuilds after raw Tcl", method(:app_tag_index_raw))
+  end
+
+  def app_tag_index_raw
+    require 'tk'
+    require 'tk/canvas'
+
+    errors = []
+    canvas = TkCanvas.new(root)
+    canvas.enable_tag_index(check: true)
+
+    a = TkcRectangle.new(canvas, 0, 0, 10, 10, tags: 'node')
+    errors << "initial" unless canvas.items_with_tag('node') == [a]
+
+    # Bypass the wrapper entirely
+    Tk.ip_eval("#{canvas.path} addtag raw withtag node")
+    Tk.ip_eval("#{canvas.path} create oval 5 5 9 9 -tags node")
+    Tk.ip_eval("#{canvas.path} itemconfigure #{a.id} -tags {node moved}")
+    errors << "raw itemconfigure not seen" unless canvas.items_with_tag('moved') == [a]
+    errors << "raw create not seen" unless canvas.items_with_tag('node').size == 2
+    errors << "raw itemconfigure should replace tags" if canvas.tag?(a, 'raw')
+
+    # Geometric modes and expressions go through Tcl, then resync
+    canvas.addtag_overlapping('hit', 0, 0, 3, 3)
+    errors << "overlapping addtag not seen" unless canvas.items_with_tag('hit') == [a]
+    errors << "expression should fall back" unless canvas.items_with_tag('node && hit') == [a]
+
+    canvas.disable_tag_index
+    errors << "index should be off" if canvas.tag_index?
+    errors << "queries should still work when off" unless canvas.items_with_tag('hit') == [a]
+
+    raise errors.join("\n") unless errors.empty?
+  end
+end
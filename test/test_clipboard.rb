@@ -316,4 +316,30 @@ class TestClipboard < Minitest::Test
 
     raise errors.join("\n") unless errors.empty?
   end
+
+  # ===========================================
+  # provide / each_chunk (streaming)
+  # ===========================================
+
+  def test_provide_and_each_chunk
+    assert_tk_app("Clipboard provide/each_chunk", method(:provide_chunk_app))
+  end
+
+  def provide_chunk_app
+    require 'tk'
+    require 'tk/clipboard'
+
+    errors = []
+
+    data = "0123456789abcdef" * 8192
+    TkClipboard.provide(root, data)
+
+    chunks = []
+    total = TkClipboard.each_chunk { |c| chunks << c }
+    errors << "total bytes wrong: #{total}" unless total == data.bytesize
+    errors << "chunked read differs" unless chunks.join == data
+    errors << "get should see provided data" unless TkClipboard.get == data
+
+    raise errors.join("\n") unless errors.empty?
+  end
 end
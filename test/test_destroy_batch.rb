@@ -0,0 +1,81 @@
+# frozen_string_literal: true
+
+# Tests for batched destroy notification (TkCore._widgets_destroyed)
+
+require_relative 'test_helper'
+require_relative 'tk_test_helper'
+
+class TestDestroyBatch < Minitest::Test
+  include TkTestHelper
+
+  def test_subtree_destroy_cleans_up_in_one_batch
+    assert_tk_app("subtree destroy cleans up in one batch", method(:app_subtree))
+  end
+
+  def app_subtree
+    require 'tk'
+
+    errors = []
+
+    hooked = []
+    hook_class = Class.new(TkFrame) do
+      define_method(:__destroy_hook__) { hooked << path }
+    end
+
+    page = TkFrame.new(root)
+    inner = hook_class.new(page)
+    buttons = Array.new(50) { |i| TkButton.new(inner, text: i.to_s, command: proc { i }) }
+    cmd_ids = buttons.flat_map { |b| b.instance_variable_get(:@cmdtbl) || [] }
+    errors << "buttons should have callbacks" if cmd_ids.empty?
+
+    batches = 0
+    original = TkCore.method(:_widgets_destroyed)
+    TkCore.define_singleton_method(:_widgets_destroyed) { |paths| batches += 1; original.call(paths) }
+    begin
+      page.destroy
+    ensure
+      TkCore.define_singleton_method(:_widgets_destroyed, original)
+    end
+
+    errors << "expected one batch, got #{batches}" unless batches == 1
+    windows = TkCore::INTERP.tk_windows
+    leftover = ([page, inner] + buttons).select { |w| windows.key?(w.path) }
+    errors << "#{leftover.size} widgets left in tk_windows" unless leftover.empty?
+    errors << "descendants should be marked destroyed" unless buttons.all? { |b| b.instance_variable_get(:@destroyed) }
+    errors << "__destroy_hook__ should run once, got #{hooked.inspect}" unless hooked == [inner.path]
+
+    # Callbacks are released at idle time
+    tbl = TkCore::INTERP.tk_cmd_tbl
+    errors << "callbacks released too early" unless cmd_ids.all? { |id| tbl.key?(id) }
+    Tk.update_idletasks
+    errors << "callbacks not released" if cmd_ids.any? { |id| tbl.key?(id) }
+    module_ids = TkComm.instance_variable_get(:@cmdtbl)
+    errors << "callback ids left in TkComm's table" if cmd_ids.any? { |id| module_ids.include?(id) }
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_tcl_side_destroy_is_seen
+    assert_tk_app("destroy from Tcl cleans up Ruby tables", method(:app_tcl_destroy))
+  end
+
+  def app_tcl_destroy
+    require 'tk'
+
+    errors = []
+
+    frame = TkFrame.new(root)
+    label = TkLabel.new(frame, text: 'x')
+    Tk.ip_eval("destroy #{frame.path}")
+
+    windows = TkCore::INTERP.tk_windows
+    errors << "Tcl destroy should drop Ruby entries" if windows.key?(frame.path) || windows.key?(label.path)
+
+    # Same path recreated right away belongs to the new widget
+    again = TkFrame.new(root, widgetname: frame.path.split('.').last)
+    Tk.update
+    errors << "recreated widget must stay registered" unless windows[again.path].equal?(again)
+
+    raise errors.join("\n") unless errors.empty?
+  end
+end
@@ -669,4 +669,72 @@ class TestEvent < Minitest::Test
 
     raise errors.join("\n") unless errors.empty?
   end
+
+  def test_event_generate_many
+    assert_tk_app("Batched event generation", method(:app_event_generate_many))
+  end
+
+  def app_event_generate_many
+    require 'tk'
+
+    errors = []
+    root.deiconify
+    Tk.update
+
+    canvas = TkCanvas.new(root, width: 100, height: 100)
+    canvas.pack
+    Tk.update
+
+    points = []
+    canvas.bind('Motion', proc { |x, y| points << [x, y] }, :x, :y)
+    virtuals = 0
+    canvas.bind('<Ping>', proc { virtuals += 1 })
+
+    events = (1..20).map { |i| [canvas, 'Motion', {x: i, y: i * 2}] }
+    events << [canvas.path, '<<Ping>>']
+
+    # Queued: nothing runs until the event loop does
+    result = Tk.event_generate_many(events)
+    errors << "count #{result[:count]}" unless result[:count] == 21
+    errors << "time should be a Float" unless result[:time].is_a?(Float)
+    errors << "queued events ran early" unless points.empty?
+    Tk.update
+    errors << "queued motion: #{points.size}" unless points.size == 20
+    errors << "motion order: #{points.last.inspect}" unless points.last == [20, 40]
+    errors << "virtual event: #{virtuals}" unless virtuals == 1
+
+    # Synchronous: dispatched during the call
+    points.clear
+    Tk.event_generate_many([[canvas, 'Motion', {x: 7, y: 8}]], sync: true)
+    errors << "sync motion: #{points.inspect}" unless points == [[7, 8]]
+
+    # Bindings that change the batch while it runs see no effect on it
+    points.clear
+    fields = {x: 1, y: 1}
+    batch = [[canvas, 'Motion', fields], [canvas, 'Motion', {x: 2, y: 2}], [canvas, 'Motion', {x: 3, y: 3}]]
+    canvas.bind('Motion', proc { |x, y|
+      points << [x, y]
+      batch.clear
+      fields[:state] = 1
+    }, :x, :y)
+    result = Tk.event_generate_many(batch, sync: true)
+    errors << "mutated batch count #{result[:count]}" unless result[:count] == 3
+    errors << "mutated batch motion: #{points.inspect}" unless points == [[1, 1], [2, 2], [3, 3]]
+
+    begin
+      Tk.event_generate_many([[canvas, 'Motion'], ['.no_such_window', 'Motion']])
+      errors << "expected TclError for bad window"
+    rescue TclTkLib::TclError => e
+      errors << "error should name index 1: #{e.message}" unless e.message.start_with?("event 1:")
+    end
+
+    begin
+      Tk.event_generate_many([[canvas]])
+      errors << "expected ArgumentError for short tuple"
+    rescue ArgumentError
+      # expected
+    end
+
+    raise errors.join("\n") unless errors.empty?
+  end
 end
@@ -45,6 +45,9 @@ FIXTURES_PATH = File.expand_path('fixtures', __dir__)
 
 require 'minitest/autorun'
 
+# Per-test timings, written when run by test/parallel_runner.rb
+require_relative 'timing_reporter' if ENV['TK_TEST_TIMINGS']
+
 # Stop TkWorker cleanly after all tests (allows coverage to be written)
 Minitest.after_run do
   if defined?(TkWorker) && TkWorker.running?
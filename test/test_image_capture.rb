@@ -0,0 +1,79 @@
+# frozen_string_literal: true
+
+# Tests for Interp#capture_window and TclTkLib.image_diff
+
+require_relative 'test_helper'
+require_relative 'tk_test_helper'
+
+class TestImageCapture < Minitest::Test
+  include TkTestHelper
+
+  def test_image_diff_counts_pixels
+    assert_tk_app("image_diff counts differing pixels", method(:app_diff))
+  end
+
+  def app_diff
+    require 'tk'
+
+    errors = []
+    a = ("\x10\x20\x30\xff" * 16).b
+    b = a.dup
+    b.setbyte(0, 0x11)       # off by one: within tolerance 1
+    b.setbyte(20, 0xff)      # pixel 5
+
+    r = TclTkLib.image_diff(a, b, 4, 4)
+    errors << "expected 2 differing, got #{r[:pixel_diff]}" unless r[:pixel_diff] == 2
+    errors << "expected total 16, got #{r[:total]}" unless r[:total] == 16
+
+    r = TclTkLib.image_diff(a, b, 4, 4, tolerance: 1, mask: true)
+    errors << "tolerance: expected 1, got #{r[:pixel_diff]}" unless r[:pixel_diff] == 1
+    errors << "mask size #{r[:mask].bytesize}" unless r[:mask].bytesize == 64
+    errors << "overlay size #{r[:overlay].bytesize}" unless r[:overlay].bytesize == 64
+
+    # The same String on both sides is locked once and released after
+    r = TclTkLib.image_diff(a, a, 4, 4)
+    errors << "self diff: expected 0, got #{r[:pixel_diff]}" unless r[:pixel_diff] == 0
+    begin
+      a << "x"
+      a.chop!
+    rescue RuntimeError => e
+      errors << "input left locked: #{e.message}"
+    end
+
+    begin
+      TclTkLib.image_diff(a, b, 5, 4)
+      errors << "size mismatch not rejected"
+    rescue ArgumentError
+    end
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_capture_window
+    assert_tk_app("capture_window returns the window's pixels", method(:app_capture))
+  end
+
+  def app_capture
+    require 'tk'
+
+    errors = []
+    root = TkRoot.new { withdraw }
+    top = TkToplevel.new(root, background: '#ff0000', width: 40, height: 30)
+    Tk.update
+    Tk.update
+
+    if Tk.windowingsystem == 'x11'
+      shot = TkCore::INTERP.capture_window(top.path)
+      errors << "width #{shot[:width]}" unless shot[:width] == 40
+      errors << "height #{shot[:height]}" unless shot[:height] == 30
+      errors << "pixel #{shot[:data][0, 4].bytes}" unless shot[:data][0, 4].bytes == [255, 0, 0, 255]
+
+      img = TkPhotoImage.capture(top)
+      errors << "photo size" unless img.width == 40 && img.height == 30
+      img.delete
+    end
+
+    top.destroy
+    raise errors.join("\n") unless errors.empty?
+  end
+end
@@ -0,0 +1,132 @@
+# frozen_string_literal: true
+
+# Tests for Interp#snapshot / Interp#reset (tkreset.c)
+
+require_relative 'test_helper'
+require_relative 'tk_test_helper'
+
+class TestInterpReset < Minitest::Test
+  include TkTestHelper
+
+  def test_reset_restores_snapshot
+    assert_tk_app("reset removes everything created since snapshot", method(:app_reset))
+  end
+
+  def app_reset
+    require 'tk'
+
+    errors = []
+    ip = TkCore::INTERP
+    ip.snapshot
+    base_cmds = ip.tk_cmd_tbl.size
+    base_globals = ip.tcl_eval("info globals").split.sort
+
+    frame = TkFrame.new(root)
+    TkButton.new(frame, text: "x", command: proc { 1 }).pack
+    root.bind('Control-x') { 2 }
+    var = TkVariable.new(1)
+    var.trace('w') { 3 }
+    ip.register_callback(proc { 4 })
+    ip.tcl_eval("proc ::reset_test_proc {} {}; namespace eval ::reset_test { variable v 1 }")
+    ip.tcl_eval("set ::reset_test_global 1; after 10000 {set ::fired 1}")
+
+    counts = ip.reset
+
+    errors << "frame should be gone" if ip.tcl_eval("winfo exists #{frame.path}") == "1"
+    errors << "proc should be gone" unless ip.tcl_eval("info commands ::reset_test_proc").empty?
+    errors << "namespace should be gone" if ip.tcl_eval("namespace exists ::reset_test") == "1"
+    globals = ip.tcl_eval("info globals").split.sort
+    errors << "leaked globals: #{globals - base_globals}" unless (globals - base_globals).empty?
+    errors << "root binding should be gone" unless ip.tcl_eval("bind . <Control-x>").empty?
+    errors << "after events left: #{ip.tcl_eval('after info')}" unless ip.tcl_eval("after info").empty?
+    errors << "leaked callbacks: #{ip.tk_cmd_tbl.size - base_cmds}" unless ip.tk_cmd_tbl.size == base_cmds
+    errors << "registered callback not dropped" unless counts[:callbacks] >= 1
+    errors << "window count #{counts[:windows]}" unless counts[:windows] >= 1
+
+    # Library procs come back through add_tk_procs
+    errors << "rb_out missing after reset" if ip.tcl_eval("info commands rb_out").empty?
+
+    # The interpreter is still usable
+    label = TkLabel.new(root, text: "after reset")
+    errors << "widget after reset" unless label.cget(:text) == "after reset"
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_reset_clears_ruby_registries
+    assert_tk_app("reset drops Ruby-side state tied to dropped Tcl objects", method(:app_reset_registries))
+  end
+
+  def app_reset_registries
+    require 'tk'
+    require 'tkextlib/tile/style'
+
+    errors = []
+    ip = TkCore::INTERP
+    ip.snapshot
+
+    TkButton.new(root, command: proc { 1 }).pack
+    new_ids = ip.tk_cmd_tbl.keys
+    v1 = TkValidation.integer(min: 0, max: 99)
+    Tk::Tile::Style.lookup('TButton', :padding)
+
+    ip.reset
+
+    cmdtbl = TkComm.instance_variable_get(:@cmdtbl)
+    leaked = cmdtbl.select { |id| new_ids.include?(id) && !ip.tk_cmd_tbl.key?(id) }
+    errors << "TkComm cmdtbl kept dropped ids: #{leaked}" unless leaked.empty?
+
+    v2 = TkValidation.integer(min: 0, max: 99)
+    errors << "validator cache returned a deleted command" if v2.equal?(v1)
+    errors << "validator command missing" if ip.tcl_eval("info commands #{v2.command}").empty?
+
+    errors << "style lookup cache survived reset" if Tk::Tile::Style.instance_variable_get(:@lookup_cache).key?(ip)
+    Tk::Tile::Style.lookup('TButton', :padding)
+    id = Tk::Tile::Style.instance_variable_get(:@theme_watch_id)[ip]
+    errors << "theme watcher not reinstalled" unless id && ip.tcl_eval("bind RbStyleWatch <<ThemeChanged>>").include?("ruby_callback #{id}")
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_reset_keeps_shared_library_packages
+    assert_tk_app("reset leaves packages loaded from shared libraries", method(:app_reset_keeps_loaded))
+  end
+
+  # A second "load" of the same library skips its init, so the commands
+  # of a binary package have to survive for package require to mean anything.
+  def app_reset_keeps_loaded
+    require 'tk'
+
+    errors = []
+    ip = TkCore::INTERP
+    ip.snapshot
+    return if ip.tcl_eval("catch {package require Thread}") == "1"
+
+    ip.reset
+
+    errors << "Thread forgotten" if ip.tcl_eval("catch {package present Thread}") == "1"
+    errors << "package require Thread failed" if ip.tcl_eval("catch {package require Thread}") == "1"
+    errors << "Thread commands deleted" if ip.tcl_eval("info commands ::thread::id").empty?
+    errors << "::tsv deleted" unless ip.tcl_eval("namespace exists ::tsv") == "1"
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_reset_without_snapshot_raises
+    assert_tk_app("reset needs a snapshot", method(:app_no_snapshot))
+  end
+
+  def app_no_snapshot
+    require 'tk'
+
+    ip = TclTkIp.new
+    begin
+      ip.reset
+      raise "expected TclError"
+    rescue TclTkLib::TclError => e
+      raise "wrong message: #{e.message}" unless e.message.include?("snapshot")
+    ensure
+      ip.delete
+    end
+  end
+end
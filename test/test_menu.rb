@@ -457,4 +457,90 @@ class TestTkMenu < Minitest::Test
 
     raise errors.join("\n") unless errors.empty?
   end
+
+  # --- Bulk entries ---
+
+  def test_add_entries
+    assert_tk_app("Menu add_entries", method(:app_add_entries))
+  end
+
+  def app_add_entries
+    require 'tk'
+    require 'tk/menu'
+
+    errors = []
+
+    menu = TkMenu.new(root, tearoff: false)
+    picked = []
+    var = TkVariable.new(0)
+    result = menu.add_entries(
+      Array.new(100) { |i| {label: "File #{i}", command: -> { picked << i }} } +
+      [:separator, [:checkbutton, {label: 'Wrap', variable: var}]])
+
+    errors << "add_entries should return self" unless result == menu
+    errors << "expected 102 entries, got #{menu.index('end')}" unless menu.index('end') == 101
+    errors << "separator type" unless menu.menutype(100) == 'separator'
+    errors << "checkbutton type" unless menu.menutype(101) == 'checkbutton'
+    errors << "label: #{menu.entrycget(42, :label)}" unless menu.entrycget(42, :label) == 'File 42'
+
+    menu.invoke(42)
+    menu.invoke(7)
+    errors << "commands should dispatch by entry, got #{picked}" unless picked == [42, 7]
+
+    # Rebuilding replaces entries and their commands
+    menu.add_entries([{label: 'Only', command: -> { picked << :only }}], replace: true)
+    errors << "replace should leave 1 entry" unless menu.index('end') == 0
+    menu.invoke(0)
+    errors << "replaced command should run" unless picked.last == :only
+
+    begin
+      menu.add_entries([{label: 'ok'}, {label: 'bad', nosuchoption: 1}])
+      errors << "bad option should raise"
+    rescue TclTkLib::TclError => e
+      errors << "error should name entry 1: #{e.message}" unless e.message.start_with?('entry 1:')
+    end
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_add_lazy_cascade
+    assert_tk_app("Menu add_lazy_cascade", method(:app_add_lazy_cascade))
+  end
+
+  def app_add_lazy_cascade
+    require 'tk'
+    require 'tk/menu'
+
+    errors = []
+
+    menu = TkMenu.new(root, tearoff: false)
+    files = %w(a.rb b.rb)
+    calls = 0
+    submenu = menu.add_lazy_cascade(label: 'Open Recent') {
+      calls += 1
+      files.map { |f| {label: f} }
+    }
+
+    errors << "cascade entry" unless menu.menutype(0) == 'cascade'
+    errors << "submenu should start empty" unless submenu.index('end').nil?
+    errors << "generator should not run before posting" unless calls == 0
+
+    post = proc { Tk.tk_call('eval', Tk.tk_call(submenu.path, 'cget', '-postcommand')) }
+    post.call
+    errors << "submenu should be filled on post" unless submenu.index('end') == 1
+
+    files << 'c.rb'
+    post.call
+    errors << "submenu should be rebuilt on each post" unless submenu.index('end') == 2
+    errors << "generator calls: #{calls}" unless calls == 2
+
+    once = menu.add_lazy_cascade(label: 'Once', once: true) { files.map { |f| {label: f} } }
+    post_once = proc { Tk.tk_call('eval', Tk.tk_call(once.path, 'cget', '-postcommand')) }
+    post_once.call
+    files << 'd.rb'
+    post_once.call
+    errors << "once: true should fill only once" unless once.index('end') == 2
+
+    raise errors.join("\n") unless errors.empty?
+  end
 end
@@ -206,4 +206,73 @@ class TestMultiInterp < Minitest::Test
       RUBY
     end
   end
+
+  # TkCore.with_interp routes tk_call and widget creation to another
+  # interpreter, and callbacks installed there dispatch back to Ruby
+  def test_with_interp_routes_calls_and_callbacks
+    assert_tk_subprocess("with_interp should route calls to the given interpreter") do
+      <<~RUBY
+        require 'tk'
+        root = TkRoot.new { withdraw }
+
+        other = TclTkIp.new
+        clicked = []
+        button = TkCore.with_interp(other) do
+          raise "TkCore.interp should be the routed one" unless TkCore.interp.equal?(other)
+          TkButton.new(text: "other", command: proc { clicked << :other })
+        end
+
+        raise "button should exist in other" unless other._eval("winfo exists \#{button.path}") == "1"
+        raise "button should not exist in INTERP" if TkCore::INTERP._eval("winfo exists \#{button.path}") == "1"
+
+        other._eval("\#{button.path} invoke")
+        raise "callback not run: \#{clicked.inspect}" unless clicked == [:other]
+
+        # Counters are per interpreter
+        raise "other should count the callback" unless other.stats[:callbacks] >= 1
+        raise "other should not be in a callback" if other.in_callback?
+
+        # Fiber storage is inherited by threads started inside the block
+        seen = TkCore.with_interp(other) { Thread.new { TkCore.current_interp }.value }
+        raise "thread should inherit the routed interp" unless seen.equal?(other)
+        raise "routing should end with the block" unless TkCore.current_interp.equal?(TkCore::INTERP)
+
+        # An inner with_interp that fails to set up keeps the outer routing
+        dead = TclTkIp.new
+        dead.delete
+        TkCore.with_interp(other) do
+          begin
+            TkCore.with_interp(dead) { }
+          rescue StandardError
+          end
+          raise "outer routing lost" unless TkCore.current_interp.equal?(other)
+        end
+
+        other.delete
+        root.destroy
+      RUBY
+    end
+  end
+
+  # in_callback? is tracked per interpreter
+  def test_callback_depth_is_per_interpreter
+    assert_tk_subprocess("callback depth should be per interpreter") do
+      <<~RUBY
+        require 'tk'
+        root = TkRoot.new { withdraw }
+
+        other = TclTkIp.new
+        inside = nil
+        id = TkCore::INTERP.register_callback(proc {
+          inside = [TkCore::INTERP.in_callback?, other.in_callback?, TclTkLib.in_callback?]
+        })
+        TkCore::INTERP._eval("ruby_callback \#{id}")
+        raise "unexpected depth flags: \#{inside.inspect}" unless inside == [true, false, true]
+        raise "max depth should be recorded" unless TkCore::INTERP.stats[:max_callback_depth] >= 1
+
+        other.delete
+        root.destroy
+      RUBY
+    end
+  end
 end
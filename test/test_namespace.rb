@@ -390,4 +390,44 @@ class TestNamespace < Minitest::Test
 
     raise errors.join("\n") unless errors.empty?
   end
+
+  def test_ns_invoke
+    assert_tk_app("Commands and callbacks run inside the namespace", method(:ns_invoke_app))
+  end
+
+  def ns_invoke_app
+    require 'tk'
+    require 'tk/namespace'
+
+    errors = []
+    ip = TkCore::INTERP
+
+    ip.tcl_eval("namespace eval ::nsinv { variable v 7; proc where {} { return inner } }")
+    ip.tcl_eval("proc ::where {} { return outer }")
+
+    errors << "ns_invoke command" unless ip.ns_invoke("::nsinv", "where") == "inner"
+    errors << "ns_invoke variable" unless ip.ns_invoke("::nsinv", "set", "v") == "7"
+    errors << "ns_invoke quoting" unless ip.ns_invoke("::nsinv", "list", "a b", "{", "$x") == "{a b} \\{ {$x}"
+    ip.ns_invoke("::nsinv_new", "set", "created", "1")
+    errors << "ns_invoke should create the namespace" unless ip.tcl_eval("namespace exists ::nsinv_new") == "1"
+    begin
+      ip.ns_invoke("::nsinv", "error", "boom")
+      errors << "expected TclError"
+    rescue TclTkLib::TclError => e
+      errors << "wrong message: #{e.message}" unless e.message.include?("boom")
+    end
+
+    ns = TkNamespace.new("::nsinv")
+    errors << "TkNamespace#tk_call" unless ns.tk_call("where") == "inner"
+    errors << "ScopeArgs#tk_call" unless TkNamespace::ScopeArgs.new("::nsinv").tk_call("set", "v") == "7"
+
+    # Callbacks installed through the namespace see it as current
+    seen = nil
+    cmd = ns.install_cmd(proc { |*args| seen = [Tk.tk_call("namespace", "current"), *args] })
+    ip.tcl_eval("#{cmd} a {b c}")
+    errors << "namespaced callback: #{seen.inspect}" unless seen == ["::nsinv", "a", "b c"]
+
+    ip.tcl_eval("namespace delete ::nsinv ::nsinv_new; rename ::where {}")
+    raise errors.join("\n") unless errors.empty?
+  end
 end
@@ -263,6 +263,84 @@ class TestPalette < Minitest::Test
     raise errors.join("\n") unless errors.empty?
   end
 
+  # ===========================================
+  # Native recolor
+  # ===========================================
+
+  def test_recolor_from_colors
+    assert_tk_app("Palette native recolor", method(:recolor_from_colors_app))
+  end
+
+  def recolor_from_colors_app
+    require 'tk'
+    require 'tk/palette'
+
+    errors = []
+
+    frame = TkFrame.new(root, background: 'white')
+    plain = TkLabel.new(frame, text: 'a', background: 'white', foreground: 'black')
+    custom = TkLabel.new(frame, text: 'b', background: 'red', foreground: 'black')
+    done = TkLabel.new(frame, text: 'c', background: '#000080', foreground: 'black')
+
+    stats = TkPalette.recolor({'background' => 'navy', 'foreground' => 'white'},
+                              root: frame, from: {'background' => 'white', 'foreground' => 'black'})
+
+    errors << "plain label background: #{plain.cget(:background)}" unless plain.cget(:background) == 'navy'
+    errors << "plain label foreground: #{plain.cget(:foreground)}" unless plain.cget(:foreground) == 'white'
+    errors << "custom color should be kept" unless custom.cget(:background) == 'red'
+    errors << "custom label foreground should change" unless custom.cget(:foreground) == 'white'
+    errors << "frame background should change" unless frame.cget(:background) == 'navy'
+    errors << "matching color should be skipped" unless done.cget(:background) == '#000080'
+    errors << "windows: #{stats[:windows]}" unless stats[:windows] == 4
+    errors << "configured: #{stats[:configured]}" unless stats[:configured] == 4
+    errors << "skipped: #{stats[:skipped]}" unless stats[:skipped] >= 1
+
+    # Nothing left to change
+    again = TkPalette.recolor({'background' => 'navy'}, root: frame, from: {'background' => 'white'})
+    errors << "second pass should configure nothing" unless again[:configured] == 0
+
+    begin
+      TkPalette.recolor({'background' => 'no-such-color'}, root: frame)
+      errors << "unknown color should raise"
+    rescue TclTkLib::TclError => e
+      errors << "wrong error: #{e.message}" unless e.message.include?('no-such-color')
+    end
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_apply
+    assert_tk_app("Palette apply", method(:apply_app))
+  end
+
+  def apply_app
+    require 'tk'
+    require 'tk/palette'
+
+    errors = []
+
+    derived = TkPalette.derive('gray85')
+    %w(foreground activeBackground selectBackground troughColor disabledForeground).each{|k|
+      errors << "derive should fill #{k}" unless derived[k]
+    }
+    errors << "dark text on light background" unless derived['foreground'] == 'black'
+
+    label = TkLabel.new(root, text: 'Test')
+    kept = TkLabel.new(root, text: 'Kept', background: 'red')
+    palette = TkPalette.apply('background' => 'darkblue')
+
+    errors << "light text on dark background" unless palette['foreground'] == 'white'
+    errors << "label background: #{label.cget(:background)}" unless label.cget(:background) == 'darkblue'
+    errors << "label foreground: #{label.cget(:foreground)}" unless label.cget(:foreground) == 'white'
+    errors << "explicit color should be kept" unless kept.cget(:background) == 'red'
+    errors << "::tk::Palette not updated" unless Tk.tk_call('set', '::tk::Palette(background)') == 'darkblue'
+
+    later = TkLabel.new(root, text: 'Later')
+    errors << "new widgets should match" unless later.cget(:background) == 'darkblue'
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
   # ===========================================
   # Integration
   # ===========================================
@@ -0,0 +1,116 @@
+# frozen_string_literal: true
+
+# Tests for Tk.on_resize - coalesced <Configure> delivery
+
+require_relative 'test_helper'
+require_relative 'tk_test_helper'
+
+class TestResizeWatch < Minitest::Test
+  include TkTestHelper
+
+  def test_on_resize_coalesces_per_frame
+    assert_tk_app("on_resize delivers latest size once per frame", method(:app_coalesce))
+  end
+
+  def app_coalesce
+    require 'tk'
+
+    errors = []
+
+    frame = TkFrame.new(root, width: 100, height: 50)
+    frame.place(x: 0, y: 0)
+    Tk.update
+
+    calls = []
+    watch = Tk.on_resize(frame) { |w, h| calls << [w, h] }
+
+    # A burst of <Configure> events before the event loop goes idle
+    10.times { |i| frame.event_generate('<Configure>', width: 110 + i, height: 60 + i) }
+    frame.event_generate('<Configure>', width: 200, height: 80)
+    Tk.update
+
+    errors << "expected one delivery, got #{calls.inspect}" unless calls.size == 1
+    errors << "expected latest size [200, 80], got #{calls.last.inspect}" unless calls.last == [200, 80]
+
+    # Same size again is not a change
+    frame.event_generate('<Configure>', width: 200, height: 80)
+    Tk.update
+    errors << "unchanged size should not be delivered" unless calls.size == 1
+
+    errors << "cancel should succeed" unless watch.cancel
+    frame.place(width: 50, height: 50)
+    Tk.update
+    errors << "cancelled watch still delivered" unless calls.size == 1
+    errors << "second cancel should be false" if watch.cancel
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_on_resize_batch_and_debounce
+    assert_tk_app("on_resize batch with quiet period", method(:app_batch))
+  end
+
+  def app_batch
+    require 'tk'
+
+    errors = []
+
+    a = TkFrame.new(root)
+    b = TkFrame.new(root)
+    a.place(x: 0, y: 0, width: 10, height: 10)
+    b.place(x: 20, y: 0, width: 10, height: 10)
+    Tk.update
+
+    batches = []
+    Tk.on_resize([a, b], debounce: 30, batch: true) { |sizes| batches << sizes }
+
+    a.place(width: 40, height: 40)
+    b.place(width: 50, height: 20)
+    Tk.update
+    errors << "debounced watch fired before the quiet period" unless batches.empty?
+
+    deadline = Time.now + 1
+    Tk.update while batches.empty? && Time.now < deadline
+
+    errors << "expected one batch, got #{batches.size}" unless batches.size == 1
+    sizes = batches.first || {}
+    errors << "batch sizes wrong: #{sizes.inspect}" unless sizes[a] == [40, 40] && sizes[b] == [50, 20]
+
+    b.destroy
+    a.place(width: 60, height: 60)
+    deadline = Time.now + 1
+    Tk.update while batches.size < 2 && Time.now < deadline
+    errors << "destroyed window should drop out" unless batches.last == { a => [60, 60] }
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_on_resize_ends_with_its_windows
+    assert_tk_app("on_resize watch is dropped with its last window", method(:app_destroyed))
+  end
+
+  def app_destroyed
+    require 'tk'
+
+    errors = []
+    ip = TkCore::INTERP
+    before = ip.resize_watches
+
+    a = TkFrame.new(root)
+    b = TkFrame.new(root)
+    watch = Tk.on_resize([a, b]) { |_win, _w, _h| }
+    errors << "watch not registered" unless (ip.resize_watches - before).size == 1
+
+    a.destroy
+    Tk.update
+    errors << "watch dropped while a window remains" unless watch.active?
+
+    b.destroy
+    Tk.update
+    errors << "registry not empty: #{ip.resize_watches - before}" unless (ip.resize_watches - before).empty?
+    errors << "watch still active" if watch.active?
+    errors << "cancel of an ended watch should be false" if watch.cancel
+
+    raise errors.join("\n") unless errors.empty?
+  end
+end
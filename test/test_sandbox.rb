@@ -0,0 +1,171 @@
+# frozen_string_literal: true
+
+# Tests for Interp#create_sandbox / #sandbox_eval (tksandbox.c)
+
+require_relative 'test_helper'
+require_relative 'tk_test_helper'
+
+class TestSandbox < Minitest::Test
+  include TkTestHelper
+
+  def test_command_limit_stops_runaway_script
+    assert_tk_app("command budget stops an endless loop", method(:app_command_limit))
+  end
+
+  def app_command_limit
+    require 'tk'
+
+    errors = []
+    sb = TkCore::INTERP.create_sandbox("sandbox_limit", commands: 10_000)
+    begin
+      begin
+        sb.sandbox_eval("while 1 {incr i}")
+        errors << "expected LimitError"
+      rescue TclTkLib::LimitError
+        # expected
+      end
+      errors << "LimitError should be a TclError" unless TclTkLib::LimitError < TclTkLib::TclError
+
+      stats = sb.sandbox_stats
+      errors << "limit_hits #{stats[:limit_hits]}" unless stats[:limit_hits] >= 1
+      errors << "errors #{stats[:errors]}" unless stats[:errors] == 1
+
+      # Budget is re-armed for the next eval
+      result = sb.sandbox_eval("set x 0; for {set i 0} {$i < 100} {incr i} {incr x}; set x")
+      errors << "sandbox unusable after limit: #{result}" unless result == "100"
+
+      begin
+        sb.sandbox_eval("error boom")
+        errors << "expected TclError"
+      rescue TclTkLib::LimitError
+        errors << "plain error raised as LimitError"
+      rescue TclTkLib::TclError => e
+        errors << "wrong message: #{e.message}" unless e.message.include?("boom")
+      end
+    ensure
+      sb.delete
+    end
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_time_limit
+    assert_tk_app("time budget stops a long script", method(:app_time_limit))
+  end
+
+  def app_time_limit
+    require 'tk'
+
+    sb = TkCore::INTERP.create_sandbox("sandbox_time", time_ms: 50, granularity: 1)
+    begin
+      t = Process.clock_gettime(Process::CLOCK_MONOTONIC)
+      begin
+        sb.sandbox_eval("while 1 {incr i}")
+        raise "expected LimitError"
+      rescue TclTkLib::LimitError
+        # expected
+      end
+      elapsed = Process.clock_gettime(Process::CLOCK_MONOTONIC) - t
+      raise "took #{elapsed}s" if elapsed > 5
+    ensure
+      sb.delete
+    end
+  end
+
+  def test_redefined_info_does_not_lift_command_limit
+    assert_tk_app("child cannot fake its command count", method(:app_fake_cmdcount))
+  end
+
+  def app_fake_cmdcount
+    require 'tk'
+
+    errors = []
+    sb = TkCore::INTERP.create_sandbox("sandbox_fake", commands: 10_000)
+    begin
+      sb.sandbox_eval("rename info _info; proc info args {return 2000000000}")
+      begin
+        sb.sandbox_eval("while 1 {incr i}")
+        errors << "a fake info cmdcount lifted the command limit"
+      rescue TclTkLib::LimitError
+        # expected
+      end
+    ensure
+      sb.delete
+    end
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_time_limit_does_not_outlive_eval
+    assert_tk_app("event handlers get no stale deadline", method(:app_time_limit_events))
+  end
+
+  def app_time_limit_events
+    require 'tk'
+
+    errors = []
+    sb = TkCore::INTERP.create_sandbox("sandbox_after", time_ms: 50, granularity: 1)
+    begin
+      sb.sandbox_eval("after 150 {set ::fired 1}")
+      sleep 0.2
+      Tk.update
+      fired = sb.sandbox_eval("info exists ::fired")
+      errors << "after callback failed on the last eval's deadline" unless fired == "1"
+    ensure
+      sb.delete
+    end
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_aliases
+    assert_tk_app("sandbox sees only its aliases", method(:app_aliases))
+  end
+
+  def app_aliases
+    require 'tk'
+
+    errors = []
+    ip = TkCore::INTERP
+    ip.tcl_eval("proc ::sandbox_host_double {n} { expr {$n * 2} }")
+    calls = []
+    sb = ip.create_sandbox("sandbox_alias", commands: 1000,
+                           aliases: { "double" => "::sandbox_host_double",
+                                      "notify" => ->(*args) { calls << args; "ok" } })
+    begin
+      errors << "string alias" unless sb.sandbox_eval("double 21") == "42"
+      errors << "callable alias result" unless sb.sandbox_eval("notify a b") == "ok"
+      errors << "callable alias args #{calls.inspect}" unless calls == [%w[a b]]
+
+      sb.sandbox_expose("triple", ->(n) { Integer(n) * 3 })
+      errors << "sandbox_expose" unless sb.sandbox_eval("triple 5") == "15"
+
+      begin
+        sb.sandbox_eval("exec true")
+        errors << "exec should not exist in a safe sandbox"
+      rescue TclTkLib::TclError
+        # expected
+      end
+
+      begin
+        sb.sandbox_expose("fail", ->(*) { raise "host failure" })
+        sb.sandbox_eval("fail")
+        errors << "expected error from failing alias"
+      rescue TclTkLib::TclError => e
+        errors << "wrong message: #{e.message}" unless e.message.include?("host failure")
+      end
+    ensure
+      sb.delete
+      ip.tcl_eval("rename ::sandbox_host_double {}")
+    end
+
+    begin
+      ip.sandbox_eval("set x 1")
+      errors << "sandbox_eval on a plain interpreter should raise"
+    rescue TclTkLib::TclError
+      # expected
+    end
+
+    raise errors.join("\n") unless errors.empty?
+  end
+end
@@ -0,0 +1,137 @@
+# frozen_string_literal: true
+
+# Tests for the compiled-code caches behind Interp#tcl_eval and the
+# Tcl ruby / ruby_eval commands
+
+require_relative 'test_helper'
+require_relative 'tk_test_helper'
+
+class TestScriptCache < Minitest::Test
+  include TkTestHelper
+
+  def test_repeated_scripts_hit_cache
+    assert_tk_app("repeated tcl_eval scripts hit the cache", method(:app_hits))
+  end
+
+  def app_hits
+    require 'tk'
+
+    errors = []
+    ip = TkCore::INTERP
+    ip.script_cache_clear
+
+    script = "expr {1 + 2}"
+    3.times do
+      result = ip.tcl_eval(script)
+      errors << "expected 3, got #{result.inspect}" unless result == "3"
+    end
+    # Unfrozen: looked up by content, cached only from the second run
+    3.times { ip.tcl_eval(+"expr {1 + 2}") }
+
+    stats = ip.script_cache_stats
+    errors << "expected 1 direct eval, got #{stats[:direct]}" unless stats[:direct] == 1
+    errors << "expected 2 misses, got #{stats[:misses]}" unless stats[:misses] == 2
+    errors << "expected 3 hits, got #{stats[:hits]}" unless stats[:hits] == 3
+
+    # One-shot and oversized scripts are never held
+    ip.script_cache_clear
+    ip.tcl_eval(+"set ::sc_once 1")
+    big = "set ::sc_big {#{'x' * 20_000}}"
+    2.times { ip.tcl_eval(big) }
+    stats = ip.script_cache_stats
+    errors << "one-shot/oversized scripts cached: size #{stats[:size]}" unless stats[:size] == 0
+    errors << "expected 3 direct evals, got #{stats[:direct]}" unless stats[:direct] == 3
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_size_limit_evicts
+    assert_tk_app("cache size limit evicts LRU scripts", method(:app_evict))
+  end
+
+  def app_evict
+    require 'tk'
+
+    errors = []
+    ip = TkCore::INTERP
+    ip.script_cache_clear
+    ip.script_cache_size = 2
+
+    %w[1 2 3].each { |n| 2.times { ip.tcl_eval(+"set ::sc_#{n} #{n}") } }
+    stats = ip.script_cache_stats
+    errors << "size should be 2, got #{stats[:size]}" unless stats[:size] == 2
+    errors << "expected 1 eviction, got #{stats[:evictions]}" unless stats[:evictions] == 1
+
+    # Size 0 disables the cache but evaluation still works
+    ip.script_cache_size = 0
+    errors << "eval with cache off failed" unless ip.tcl_eval("set ::sc_off ok") == "ok"
+    errors << "size 0 should empty cache" unless ip.script_cache_stats[:size] == 0
+
+    ip.script_cache_size = 256
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_errors_still_raise
+    assert_tk_app("cached scripts still raise TclError", method(:app_errors))
+  end
+
+  def app_errors
+    require 'tk'
+
+    errors = []
+    script = "error boom"
+    2.times do
+      begin
+        TkCore::INTERP.tcl_eval(script)
+        errors << "expected TclError"
+      rescue TclTkLib::TclError => e
+        errors << "wrong message #{e.message}" unless e.message.include?("boom")
+      end
+    end
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_ruby_command_reuses_compiled_code
+    assert_tk_app("ruby command reuses compiled code", method(:app_ruby_cache))
+  end
+
+  def app_ruby_cache
+    require 'tk'
+
+    errors = []
+    ip = TkCore::INTERP
+    ip.ruby_eval_cache_clear
+
+    # Same literal inside a Tcl proc: identity hits after the first call
+    ip.tcl_eval('proc ::rb_cache_probe {} { ruby {1 + 41} }')
+    3.times do
+      result = ip.tcl_eval('::rb_cache_probe')
+      errors << "expected 42, got #{result.inspect}" unless result == "42"
+    end
+    # Fresh Tcl_Obj with the same text: content hit
+    ip.tcl_eval(+'ruby_eval {1 + 41}')
+
+    stats = ip.ruby_eval_cache_stats
+    errors << "expected 1 miss, got #{stats[:misses]}" unless stats[:misses] == 1
+    errors << "expected 3 hits, got #{stats[:hits]}" unless stats[:hits] == 3
+
+    # Top-level semantics as before: globals persist, locals do not
+    ip.tcl_eval('ruby {$rb_cache_probe = 7}')
+    errors << "global not set" unless $rb_cache_probe == 7
+    2.times do
+      scoped = ip.tcl_eval('ruby {defined?(x) ? "leak" : (x = 1; "ok")}')
+      errors << "locals leaked between calls" unless scoped == "ok"
+    end
+
+    # Syntax errors surface as Tcl errors and are not cached
+    begin
+      ip.tcl_eval('ruby {1 +}')
+      errors << "syntax error should raise"
+    rescue TclTkLib::TclError
+    end
+    errors << "failed compile was cached" if ip.ruby_eval_cache_stats[:size] != 3
+
+    raise errors.join("\n") unless errors.empty?
+  end
+end
@@ -0,0 +1,90 @@
+# frozen_string_literal: true
+
+# Tests for Tk::ScrollGroup (Interp#scroll_group, tkscroll.c)
+
+require_relative 'test_helper'
+require_relative 'tk_test_helper'
+
+class TestScrollGroup < Minitest::Test
+  include TkTestHelper
+
+  def test_lockstep_scrolling
+    assert_tk_app("Scroll group keeps members in lockstep", method(:app_lockstep))
+  end
+
+  def app_lockstep
+    require 'tk'
+
+    errors = []
+    root.deiconify
+
+    lists = Array.new(3) do
+      lb = TkListbox.new(root, height: 10)
+      300.times { |i| lb.insert(:end, "row #{i}") }
+      lb.pack(side: :left)
+    end
+    bar = TkScrollbar.new(root).pack(side: :right, fill: :y)
+
+    seen = []
+    group = Tk::ScrollGroup.new(lists, axis: :y, scrollbar: bar) { |first, last| seen << [first, last] }
+    Tk.update
+
+    errors << "members: #{group.members.size}" unless group.members.map(&:path) == lists.map(&:path)
+    errors << "scrollbar command: #{bar.cget(:command)}" unless bar.cget(:command).to_s.include?(group.command)
+
+    # Scrollbar drag moves every member
+    Tk.ip_eval("{*}[#{bar.path} cget -command] moveto 0.5")
+    Tk.update
+    firsts = lists.map { |lb| lb.yview.first }
+    errors << "moveto not fanned out: #{firsts}" unless firsts.all? { |f| (f - 0.5).abs < 0.01 }
+
+    # One member scrolling on its own leads the others
+    seen.clear
+    lists[1].yview_moveto(0.2)
+    Tk.update
+    Tk.update
+    firsts = lists.map { |lb| lb.yview.first }
+    errors << "member did not lead: #{firsts}" unless firsts.all? { |f| (f - 0.2).abs < 0.01 }
+    bar_first = Tk.tk_call(bar.path, 'get').split.first.to_f
+    errors << "scrollbar not updated: #{bar_first}" unless (bar_first - 0.2).abs < 0.01
+    errors << "observer not called" if seen.empty?
+    errors << "group fractions: #{group.fractions}" unless (group.fractions.first - 0.2).abs < 0.01
+
+    # Unit scrolling follows the first member
+    group.scroll(5, 'units')
+    Tk.update
+    firsts = lists.map { |lb| lb.yview.first }
+    errors << "scroll step diverged: #{firsts}" unless firsts.uniq.size == 1 && firsts.first > 0.2
+
+    # Removal and destruction
+    group.remove(lists[2])
+    errors << "remove left scrollcommand" unless lists[2].cget(:yscrollcommand).to_s.empty?
+    lists[0].destroy
+    errors << "destroyed member kept: #{group.members.size}" unless group.members.size == 1
+
+    cmd = group.command
+    group.destroy
+    errors << "group command left behind" unless Tk.ip_eval("info commands #{cmd}").empty?
+    errors << "destroy left scrollcommand" unless lists[1].cget(:yscrollcommand).to_s.empty?
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_bad_member
+    assert_tk_app("Scroll group rejects unknown windows", method(:app_bad_member))
+  end
+
+  def app_bad_member
+    require 'tk'
+
+    before = Tk.ip_eval("info commands ::rb_scrollgroup*").split.size
+    begin
+      Tk::ScrollGroup.new(['.no_such_widget'])
+      raise "expected TclError"
+    rescue TclTkLib::TclError
+      # expected
+    end
+    after = Tk.ip_eval("info commands ::rb_scrollgroup*").split.size
+    raise "group command leaked" unless after == before
+  end
+end
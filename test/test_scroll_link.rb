@@ -0,0 +1,124 @@
+# frozen_string_literal: true
+
+# Tests for native scrollbar linkage (Interp#scroll_link, tkscroll.c)
+
+require_relative 'test_helper'
+require_relative 'tk_test_helper'
+
+class TestScrollLink < Minitest::Test
+  include TkTestHelper
+
+  def test_native_scrollbar
+    assert_tk_app("Scrollbar linked in Tcl", method(:app_native_scrollbar))
+  end
+
+  def app_native_scrollbar
+    require 'tk'
+
+    errors = []
+    root.deiconify
+
+    list = TkListbox.new(root, height: 10)
+    bar = TkScrollbar.new(root)
+    200.times { |i| list.insert(:end, "item #{i}") }
+    list.pack(side: :left)
+    bar.pack(side: :right, fill: :y)
+    list.yscrollbar(bar, native: true)
+    Tk.update
+
+    scroll_cmd = list.cget(:yscrollcommand).to_s
+    errors << "scrollcommand should not call Ruby: #{scroll_cmd}" if scroll_cmd.include?("rb_out")
+    errors << "scrollbar command: #{bar.cget(:command)}" unless bar.cget(:command).to_s.include?("yview")
+
+    # Widget -> scrollbar
+    list.yview_moveto(0.5)
+    Tk.update
+    first = Tk.tk_call(bar.path, 'get').split.first.to_f
+    errors << "scrollbar should follow widget: #{first}" unless (first - 0.5).abs < 0.01
+
+    # Scrollbar -> widget, as a drag would
+    Tk.ip_eval("{*}[#{bar.path} cget -command] moveto 0.25")
+    Tk.update
+    first = list.yview.first
+    errors << "widget should follow scrollbar: #{first}" unless (first - 0.25).abs < 0.01
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_observer_once_per_frame
+    assert_tk_app("Scroll observer is coalesced", method(:app_observer))
+  end
+
+  def app_observer
+    require 'tk'
+
+    errors = []
+    root.deiconify
+
+    text = TkText.new(root, height: 5)
+    bar = TkScrollbar.new(root)
+    text.insert(:end, (1..500).map { |i| "line #{i}" }.join("\n"))
+    text.pack(side: :left)
+    bar.pack(side: :right, fill: :y)
+
+    seen = []
+    text.yscrollbar(bar, native: true) { |first, last| seen << [first, last] }
+    Tk.update
+    seen.clear
+
+    10.times { |i| text.yview_moveto(i / 20.0) }
+    Tk.update
+    errors << "observer calls: #{seen.size}" unless seen.size == 1
+    first, last = seen.last
+    errors << "observer fractions should be Floats" unless first.is_a?(Float) && last.is_a?(Float)
+    errors << "observer first #{first}" unless (first - 0.45).abs < 0.01
+
+    bar_first = Tk.tk_call(bar.path, 'get').split.first.to_f
+    errors << "scrollbar not updated: #{bar_first}" unless (bar_first - first).abs < 0.001
+
+    # The observer command goes away with the widget
+    cmd = "::rb_scrolly#{text.path}"
+    errors << "link command missing" if Tk.ip_eval("info commands #{cmd}").empty?
+    text.destroy
+    Tk.update
+    errors << "link command left behind" unless Tk.ip_eval("info commands #{cmd}").empty?
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_virtual_treeview_yscrollbar_signature
+    assert_tk_app("VirtualTreeview#yscrollbar takes native: and an observer", method(:app_virtual_treeview))
+  end
+
+  def app_virtual_treeview
+    require 'tk'
+    require 'tkextlib/tile/virtual_treeview'
+
+    errors = []
+    root.deiconify
+
+    model = Object.new
+    def model.row_count = 1000
+    def model.row(i) = ["row #{i}"]
+
+    tree = Tk::Tile::VirtualTreeview.new(root, model: model, columns: %w[name], height: 10)
+    bar = Tk::Tile::YScrollbar.new(root)
+    tree.pack(side: :left)
+    bar.pack(side: :right, fill: :y)
+
+    seen = []
+    tree.yscrollbar(bar, native: true) { |first, last| seen << [first, last] }
+    Tk.update
+    errors << "observer not called on attach" if seen.empty?
+
+    seen.clear
+    tree.yview('moveto', 0.5)
+    Tk.update
+    first, = seen.last
+    errors << "observer after moveto: #{seen.inspect}" unless first && (first - 0.5).abs < 0.01
+    bar_first = Tk.tk_call(bar.path, 'get').split.first.to_f
+    errors << "scrollbar not updated: #{bar_first}" unless (bar_first - 0.5).abs < 0.01
+
+    raise errors.join("\n") unless errors.empty?
+  end
+end
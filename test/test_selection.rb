@@ -467,4 +467,104 @@ class TestSelection < Minitest::Test
 
     raise errors.join("\n") unless errors.empty?
   end
+
+  # ===========================================
+  # provide / each_chunk (streaming)
+  # ===========================================
+
+  def test_provide_streams_string
+    assert_tk_app("Selection provide String", method(:provide_string_app))
+  end
+
+  def provide_string_app
+    require 'tk'
+    require 'tk/selection'
+
+    errors = []
+
+    label = TkLabel.new(root, text: 'Test')
+    label.pack
+
+    data = ("row\t\u00e9t\u00e9\t42\n" * 20_000).freeze
+    TkSelection.provide(label, data)
+
+    chunks = []
+    total = TkSelection.each_chunk { |c| chunks << c }
+    errors << "expected several chunks, got #{chunks.size}" unless chunks.size > 1
+    errors << "total bytes wrong: #{total}" unless total == data.bytesize
+    errors << "chunk split a UTF-8 character" unless chunks.all?(&:valid_encoding?)
+    errors << "streamed data differs" unless chunks.join == data
+    errors << "get should see same data" unless TkSelection.get == data
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_provide_with_callable
+    assert_tk_app("Selection provide callable", method(:provide_callable_app))
+  end
+
+  def provide_callable_app
+    require 'tk'
+    require 'tk/selection'
+
+    errors = []
+
+    label = TkLabel.new(root, text: 'Test')
+    label.pack
+
+    source = 'x' * 10_000
+    calls = []
+    label.provide { |off, max| calls << off; source.byteslice(off, max) }
+
+    result = TkSelection.get
+    errors << "callable data wrong (#{result.size})" unless result == source
+    errors << "provider should be called per chunk" unless calls.size > 1 && calls.first == 0
+
+    errors << "unprovide should report removal" unless label.unprovide == true
+    errors << "second unprovide should be false" unless label.unprovide == false
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_provide_with_short_chunks
+    assert_tk_app("Selection provider returning short chunks", method(:provide_short_chunks_app))
+  end
+
+  def provide_short_chunks_app
+    require 'tk'
+    require 'tk/selection'
+
+    errors = []
+
+    label = TkLabel.new(root, text: 'Test')
+    label.pack
+
+    # Never more than 100 bytes per call, whatever Tk asks for
+    source = (0...50_000).map { |i| (97 + i % 26).chr }.join
+    label.provide { |off, max| source.byteslice(off, [max, 100].min) }
+
+    result = TkSelection.get
+    errors << "short chunks truncated the selection (#{result.size} of #{source.size})" unless result == source
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_provide_dropped_on_destroy
+    assert_tk_app("Selection provider dropped on destroy", method(:provide_destroy_app))
+  end
+
+  def provide_destroy_app
+    require 'tk'
+    require 'tk/selection'
+
+    errors = []
+
+    label = TkLabel.new(root, text: 'Test')
+    TkSelection.provide(label, 'gone soon', own: false)
+    label.destroy
+
+    errors << "handler should be gone with its window" if TkSelection.unprovide(label.path)
+
+    raise errors.join("\n") unless errors.empty?
+  end
 end
@@ -52,4 +52,132 @@ class TestTile < Minitest::Test
     # Try setting the first available theme
     Tk::Tile.set_theme(themes.first)
   end
+
+  def test_style_restyle
+    assert_tk_app("Tk::Tile::Style.restyle", method(:app_style_restyle))
+  end
+
+  def app_style_restyle
+    require 'tk'
+    require 'tkextlib/tile'
+    require 'tkextlib/tile/style'
+
+    errors = []
+
+    styles = {
+      'Restyle.TLabel' => {configure: {background: '#123456', foreground: 'white'}},
+      'Restyle.TButton' => {map: {background: [['active', '#654321']]}}
+    }
+    stats = Tk::Tile::Style.restyle(styles)
+    errors << "changed: #{stats[:changed]}" unless stats[:changed] == 3
+
+    bg = Tk.tk_call('ttk::style', 'configure', 'Restyle.TLabel', '-background')
+    errors << "configure not applied: #{bg}" unless bg == '#123456'
+    map = Tk.tk_call('ttk::style', 'map', 'Restyle.TButton', '-background')
+    errors << "map not applied: #{map}" unless map == 'active #654321'
+
+    again = Tk::Tile::Style.restyle(styles)
+    errors << "unchanged settings should be skipped" unless again == {changed: 0, skipped: 3}
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_style_lookup_cache
+    assert_tk_app("Tk::Tile::Style lookup cache", method(:app_style_lookup_cache))
+  end
+
+  def app_style_lookup_cache
+    require 'tk'
+    require 'tkextlib/tile'
+    require 'tkextlib/tile/style'
+
+    errors = []
+    style = Tk::Tile::Style
+
+    style.configure('Cache.TLabel', foreground: '#111111')
+    errors << "first lookup" unless style.lookup('Cache.TLabel', :foreground) == '#111111'
+
+    # Changed behind the wrapper's back: the cached value stays until cleared
+    Tk.tk_call('ttk::style', 'configure', 'Cache.TLabel', '-foreground', '#222222')
+    errors << "lookup should be cached" unless style.lookup('Cache.TLabel', :foreground) == '#111111'
+    style.clear_lookup_cache
+    errors << "clear_lookup_cache" unless style.lookup('Cache.TLabel', :foreground) == '#222222'
+
+    # Changes through the wrapper invalidate at once
+    style.configure('Cache.TLabel', foreground: '#333333')
+    errors << "configure should invalidate" unless style.lookup('Cache.TLabel', '-foreground') == '#333333'
+    style.map('Cache.TLabel', foreground: [['disabled', '#444444']])
+    errors << "state lookup" unless style.lookup('Cache.TLabel', :foreground, 'disabled') == '#444444'
+    errors << "fallback" unless style.lookup('Cache.TLabel', :nosuchoption, TkUtil::None, 'dflt') == 'dflt'
+
+    # <<ThemeChanged>> invalidates changes made directly in Tcl
+    Tk.tk_call('ttk::style', 'configure', 'Cache.TLabel', '-foreground', '#555555')
+    Tk.update
+    errors << "ThemeChanged should invalidate" unless style.lookup('Cache.TLabel', :foreground) == '#555555'
+
+    # Replacing the bindings on "." (no "+") leaves the watcher in place
+    Tk.root.bind('<<ThemeChanged>>') { }
+    Tk.root.bind_remove('<<ThemeChanged>>')
+    Tk.tk_call('ttk::style', 'configure', 'Cache.TLabel', '-foreground', '#666666')
+    Tk.update
+    errors << "watcher removed by root bind" unless style.lookup('Cache.TLabel', :foreground) == '#666666'
+
+    # Inside theme_settings, configure and lookup apply to that theme
+    current = Tk.tk_call('ttk::style', 'theme', 'use')
+    other = (style.theme_names - [current]).first
+    seen = []
+    style.theme_settings(other) {
+      style.configure('Cache.TLabel', foreground: '#777777')
+      seen << style.lookup('Cache.TLabel', :foreground)
+      style.configure('Cache.TLabel', foreground: '#888888')
+      seen << style.lookup('Cache.TLabel', :foreground)
+    }
+    errors << "theme_settings lookups: #{seen}" unless seen == ['#777777', '#888888']
+    errors << "theme_settings leaked into #{current}" unless style.lookup('Cache.TLabel', :foreground) == '#666666'
+
+    # Another interpreter gets its own cache and watcher
+    ip = TclTkIp.new
+    begin
+      TkCore.with_interp(ip) {
+        style.configure('Cache.TLabel', foreground: '#aaaaaa')
+        errors << "cache shared across interps" unless style.lookup('Cache.TLabel', :foreground) == '#aaaaaa'
+      }
+      id = style.instance_variable_get(:@theme_watch_id)[ip]
+      errors << "watcher not bound in routed interp" unless id && ip._invoke('bind', 'RbStyleWatch', '<<ThemeChanged>>').include?("ruby_callback #{id}")
+    ensure
+      ip.delete
+    end
+    errors << "main interp cache changed" unless style.lookup('Cache.TLabel', :foreground) == '#666666'
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_style_prefetch
+    assert_tk_app("Tk::Tile::Style.prefetch", method(:app_style_prefetch))
+  end
+
+  def app_style_prefetch
+    require 'tk'
+    require 'tkextlib/tile'
+    require 'tkextlib/tile/style'
+
+    errors = []
+    style = Tk::Tile::Style
+
+    style.configure('Pre.TButton', padding: 7)
+    values = style.prefetch('Pre.TButton')
+    %w(padding foreground background).each{|opt|
+      errors << "prefetch should resolve #{opt}: #{values.keys}" unless values.key?(opt)
+    }
+    errors << "padding: #{values['padding']}" unless values['padding'] == '7'
+    values.each{|opt, val|
+      errors << "#{opt} should match lookup" unless style.lookup('Pre.TButton', opt) == val
+    }
+
+    style.map('Pre.TButton', foreground: [['pressed', '#00ff00']])
+    pressed = style.prefetch('Pre.TButton', 'pressed')
+    errors << "state prefetch: #{pressed['foreground']}" unless pressed['foreground'] == '#00ff00'
+
+    raise errors.join("\n") unless errors.empty?
+  end
 end
@@ -1603,4 +1603,97 @@ class TestTkVariable < Minitest::Test
     val = var.value
     raise "expected TkWindow, got #{val.class}" unless val.is_a?(TkWindow)
   end
+
+  # --- Bulk variable access (tkvars.c) ---
+
+  def test_bulk_get_and_set_vars
+    assert_tk_app("tcl_set_vars/tcl_get_vars round trip", method(:app_bulk_vars))
+  end
+
+  def app_bulk_vars
+    require 'tk'
+    ip = TkCore::INTERP
+    ip.tcl_eval("namespace eval ::bulkns {}")
+
+    values = {
+      "bulk_a" => "plain",
+      "::bulkns::b" => "with\0nul and \u00e9",
+      "bulk_arr(k 1)" => "element",
+      "bulk_n" => 42,
+      "bulk_nil" => nil,
+    }
+    ip.tcl_set_vars(values)
+
+    got = ip.tcl_get_vars(values.keys + ["bulk_missing"])
+    expected = {
+      "bulk_a" => "plain",
+      "::bulkns::b" => "with\0nul and \u00e9",
+      "bulk_arr(k 1)" => "element",
+      "bulk_n" => "42",
+      "bulk_nil" => "",
+      "bulk_missing" => nil,
+    }
+    raise "got #{got.inspect}" unless got == expected
+    raise "element not in array" unless ip.tcl_eval("set bulk_arr(k 1)") == "element"
+
+    begin
+      ip.tcl_set_vars({ "bulk_a(x)" => "1" })
+      raise "element write into a scalar should raise"
+    rescue TclTkLib::TclError
+    end
+  end
+
+  def test_array_get_and_set
+    assert_tk_app("tcl_array_set/tcl_array_get", method(:app_bulk_array))
+  end
+
+  def app_bulk_array
+    require 'tk'
+    ip = TkCore::INTERP
+
+    data = (1..500).to_h { |i| ["key #{i}", "value #{i}"] }
+    ip.tcl_array_set("bulk_model", data)
+    raise "size mismatch" unless ip.tcl_eval("array size bulk_model") == "500"
+    raise "array_get mismatch" unless ip.tcl_array_get("bulk_model") == data
+    raise "non-array should be empty" unless ip.tcl_array_get("bulk_no_such") == {}
+
+    ip.tcl_array_set("bulk_empty", {})
+    raise "empty array_set should create array" unless ip.tcl_eval("array exists bulk_empty") == "1"
+
+    var = TkVariable.new({ "a" => 1 })
+    var.update({ "b" => 2, "c" => 3 })
+    raise "update mismatch: #{var.value.inspect}" unless var.value == { "a" => "1", "b" => "2", "c" => "3" }
+
+    # Multi-part keys and TkVariable values convert as with #[]=
+    src = TkVariable.new("from var")
+    var.update({ ["row", 2] => "cell", "v" => src })
+    raise "multi-part key: #{var.keys.inspect}" unless var["row", 2] == "cell"
+    raise "TkVariable value stored #{var['v'].inspect}" unless var["v"] == "from var"
+  end
+
+  def test_quiet_bulk_load_fires_trace_once
+    assert_tk_app("quiet bulk load fires one trace", method(:app_quiet_load))
+  end
+
+  def app_quiet_load
+    require 'tk'
+
+    var = TkVariable.new({ "seed" => 0 })
+    calls = []
+    var.trace('write') { |_v, elem, op| calls << [elem, op] }
+
+    var.update((1..100).to_h { |i| [i, i] }, quiet: true)
+    raise "expected one notification, got #{calls.size}" unless calls.size == 1
+    raise "expected whole-array notification, got #{calls.inspect}" unless calls == [["", "write"]]
+
+    # Trace is back in place afterwards
+    calls.clear
+    var["after"] = 1
+    raise "trace not restored: #{calls.inspect}" unless calls.size == 1
+
+    # Without quiet, every element notifies
+    calls.clear
+    var.update({ "x" => 1, "y" => 2 })
+    raise "expected 2 notifications, got #{calls.size}" unless calls.size == 2
+  end
 end
@@ -456,4 +456,118 @@ class TestTkValidation < Minitest::Test
 
     raise errors.join("\n") unless errors.empty?
   end
+
+  # --- Compiled (native) validators ---
+
+  def test_compiled_validators
+    assert_tk_app("Compiled validators", method(:app_compiled_validators))
+  end
+
+  def app_compiled_validators
+    require 'tk'
+    require 'tk/entry'
+
+    errors = []
+
+    age = TkEntry.new(root, validate: 'key', vcmd: TkValidation.integer(min: 0, max: 150))
+    age.insert(0, '42')
+    age.insert('end', 'x')
+    errors << "integer should reject 'x', got '#{age.get}'" unless age.get == '42'
+    age.insert('end', '0')
+    errors << "integer should reject 420 > max, got '#{age.get}'" unless age.get == '42'
+
+    price = TkEntry.new(root, validate: 'key', vcmd: TkValidation.decimal(precision: 2))
+    price.insert(0, '3.14')
+    price.insert('end', '1')
+    errors << "decimal precision not enforced, got '#{price.get}'" unless price.get == '3.14'
+
+    code = TkEntry.new(root, validate: 'key',
+                       vcmd: TkValidation::Compiled.new(max_length: 4, charset: ('A'..'F')))
+    code.insert(0, 'ABCDE')
+    errors << "length/charset: 'ABCDE' should be rejected" unless code.get == ''
+    code.insert(0, 'BEEF')
+    errors << "length/charset: 'BEEF' should be accepted" unless code.get == 'BEEF'
+
+    zip = TkEntry.new(root, validate: 'key', vcmd: TkValidation.regexp('[0-9]{0,5}'))
+    zip.insert(0, '123456')
+    errors << "regexp should reject 6 digits" unless zip.get == ''
+
+    # Key validation accepts prefixes of a possible match, nothing else
+    plate = TkEntry.new(root, validate: 'all', vcmd: TkValidation.regexp('[A-Z]{2}[0-9]{3}'))
+    'AB12'.each_char { |c| plate.insert('end', c) }
+    errors << "regexp should accept prefixes while typing, got '#{plate.get}'" unless plate.get == 'AB12'
+    plate.insert('end', 'X')
+    errors << "regexp should reject a non-prefix, got '#{plate.get}'" unless plate.get == 'AB12'
+    errors << "incomplete value should fail full validation" unless Tk.tk_call(plate.path, 'validate') == '0'
+    plate.insert('end', '3')
+    errors << "complete value should pass, got '#{plate.get}'" unless Tk.tk_call(plate.path, 'validate') == '1'
+    plate.insert('end', '4')
+    errors << "regexp should reject past a full match, got '#{plate.get}'" unless plate.get == 'AB123'
+
+    # Directors and embedded options stay in front of the anchors
+    nocase = TkEntry.new(root, validate: 'all', vcmd: TkValidation.regexp('(?i)ab[0-9]'))
+    nocase.insert(0, 'AB1')
+    errors << "(?i) pattern should match 'AB1', got '#{nocase.get}'" unless nocase.get == 'AB1'
+    literal = TkEntry.new(root, validate: 'all', vcmd: TkValidation.regexp('***=a.b'))
+    literal.insert(0, 'axb')
+    errors << "***= pattern should be literal, got '#{literal.get}'" unless literal.get == ''
+    literal.insert(0, 'a.b')
+    errors << "***= pattern should match itself, got '#{literal.get}'" unless literal.get == 'a.b'
+    begin
+      TkValidation.regexp('(?b)a*')
+      errors << "BRE pattern should be rejected"
+    rescue ArgumentError
+    end
+
+    same = TkValidation.integer(min: 0, max: 150)
+    errors << "identical specs should share a command" unless same.equal?(TkValidation.integer(min: 0, max: 150))
+
+    # Commands are created in the routed interpreter, cached per interpreter
+    other = TclTkIp.new
+    begin
+      there = TkCore.with_interp(other) { TkValidation.integer(min: 0, max: 150) }
+      errors << "validator cached across interpreters" if there.equal?(same)
+      errors << "validator missing in routed interp" if other._invoke('info', 'commands', there.command).empty?
+    ensure
+      other.delete
+    end
+
+    begin
+      TkValidation.regexp('(')
+      errors << "bad pattern should raise"
+    rescue TclTkLib::TclError
+    end
+
+    raise errors.join("\n") unless errors.empty?
+  end
+
+  def test_validation_states
+    assert_tk_app("Batched validation states", method(:app_validation_states))
+  end
+
+  def app_validation_states
+    require 'tk'
+    require 'tk/entry'
+
+    errors = []
+
+    range = TkValidation.integer(min: 10, max: 20)
+    a = TkEntry.new(root, validate: 'none', vcmd: range)
+    b = TkEntry.new(root, validate: 'none', vcmd: range)
+    a.insert(0, '15')
+    b.insert(0, '5')   # fine while typing, out of range when forced
+
+    states = TkValidation.states([a, b])
+    errors << "unvalidated widgets should be nil, got #{states.inspect}" unless states == [nil, nil]
+
+    states = TkValidation.states([a, b], revalidate: true)
+    errors << "forced states wrong: #{states.inspect}" unless states == [true, false]
+    errors << "recorded states wrong" unless TkValidation.states([a.path, b.path]) == [true, false]
+
+    b.destroy
+    b2 = TkEntry.new(root, widgetname: b.path.split('.').last)
+    errors << "destroyed widget state should be dropped" unless TkValidation.states([b2]) == [nil]
+
+    raise errors.join("\n") unless errors.empty?
+  end
 end
@@ -685,4 +685,48 @@ class TestTkWinfo < Minitest::Test
     found = TkWinfo.widget(id)
     raise "widget should find button, got #{found.inspect}" unless found.path == btn.path
   end
+
+  # --- Bulk query ---
+
+  def test_winfo_query
+    assert_tk_app("winfo query reads many windows at once", method(:app_query))
+  end
+
+  def app_query
+    require 'tk'
+    errors = []
+
+    frame = TkFrame.new(root, width: 120, height: 40).pack
+    label = TkLabel.new(root, text: "Bulk").pack
+    hidden = TkLabel.new(root, text: "Unmapped")
+    Tk.update
+
+    wins = [frame, label, hidden, '.no_such_window']
+    props = TkWinfo::QUERY_PROPS
+    info = TkWinfo.query(wins, props)
+
+    errors << "keys should match props" unless info.keys == props
+    errors << "each column should have one entry per window" unless info.values.all? { |col| col.size == wins.size }
+
+    [frame, label, hidden].each_with_index do |w, i|
+      %i[width height reqwidth reqheight x y rootx rooty].each do |prop|
+        expected = TkWinfo.send(prop, w)
+        errors << "#{prop} of #{w.path}: #{info[prop][i]} != #{expected}" unless info[prop][i] == expected
+      end
+      errors << "ismapped of #{w.path} wrong" unless info[:ismapped][i] == TkWinfo.mapped?(w)
+      errors << "viewable of #{w.path} wrong" unless info[:viewable][i] == TkWinfo.viewable(w)
+      errors << "class of #{w.path} wrong" unless info[:class][i] == TkWinfo.classname(w)
+    end
+    errors << "hidden label should not be mapped" if info[:ismapped][2]
+    errors << "missing window should not exist" unless info[:exists] == [true, true, true, false]
+    errors << "missing window width should be nil" unless info[:width][3].nil?
+
+    begin
+      TkWinfo.query([frame], [:bogus])
+      errors << "unknown property should raise"
+    rescue ArgumentError
+    end
+
+    raise errors.join("\n") unless errors.empty?
+  end
 end
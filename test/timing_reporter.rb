@@ -0,0 +1,39 @@
+# frozen_string_literal: true
+
+require 'json'
+
+# Per-test timing for the parallel runner (test/parallel_runner.rb).
+#
+# Loaded by test_helper when TK_TEST_TIMINGS names a file. Each finished
+# test appends one JSON line: test name, source file, seconds, result.
+module TkTestTimings
+  class Reporter < Minitest::AbstractReporter
+    def initialize(path)
+      super()
+      @path = path
+      @records = []
+    end
+
+    def record(result)
+      file, = result.source_location
+      @records << { test: "#{result.klass}##{result.name}", file: file,
+                    time: result.time, passed: result.passed? || result.skipped? }
+    end
+
+    def report
+      File.open(@path, 'a') do |f|
+        @records.each { |r| f.puts(JSON.generate(r)) }
+      end
+    end
+  end
+
+  # Minitest only loads gem plugins, so add the reporter once it exists
+  module Plugin
+    def init_plugins(options)
+      super
+      reporter << Reporter.new(ENV['TK_TEST_TIMINGS'])
+    end
+  end
+end
+
+Minitest.singleton_class.prepend(TkTestTimings::Plugin)
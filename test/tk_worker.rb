@@ -8,6 +8,9 @@
 #
 # Uses pipe-based IPC (no threads) to avoid Tk threading issues.
 #
+# Under the parallel runner (test/parallel_runner.rb) each test process
+# has its own worker; TK_WORKER_ID keeps their files apart.
+#
 # Usage:
 #   TkWorker.start
 #   result = TkWorker.run_test("label = TkLabel.new(root); ...")
@@ -19,7 +22,7 @@ require 'tmpdir'
 require 'json'
 
 class TkWorker
-  SOCKET_DIR = File.join(Dir.tmpdir, 'tk_worker')
+  SOCKET_DIR = File.join(Dir.tmpdir, ['tk_worker', ENV['TK_WORKER_ID']].compact.join('_'))
   PID_FILE = File.join(SOCKET_DIR, 'worker.pid')
   READY_FILE = File.join(SOCKET_DIR, 'ready')
 
@@ -126,6 +129,7 @@ class TkWorker
       require 'tk'
       @root = TkRoot.new { withdraw }
       @test_count = 0
+      snapshot_callbacks!
     end
 
     def run
@@ -348,6 +352,8 @@ class TkWorker
         Tk::BWidget.reset
       end
 
+      reset_callbacks!
+
       # Reset global Tk settings to defaults
       Tk.version_mismatch = :warn
 
@@ -355,6 +361,49 @@ class TkWorker
       Tk::Warnings.reset!
     end
 
+    # Remember what exists before any test runs, so reset_callbacks! can
+    # drop only what tests added.
+    def snapshot_callbacks!
+      @base_var_cb_ids = defined?(TkVariable) ? TkVariable::TkVar_CB_TBL.keys : []
+      @base_bindings = %w[. all].to_h do |tag|
+        [tag, Tk.tk_call_without_enc('bind', tag).to_s.split]
+      end
+    end
+
+    # Callbacks that outlive the test's widgets: bindings added to "." or
+    # "all", and variable traces. Remove them along with their entries in
+    # the callback tables. Other table entries are left alone, since
+    # libraries loaded during a test may register callbacks for good.
+    def reset_callbacks!
+      tbl = TkCore::INTERP.tk_cmd_tbl
+      @base_bindings.each do |tag, base|
+        (Tk.tk_call_without_enc('bind', tag).to_s.split - base).each do |seq|
+          script = Tk.tk_call_without_enc('bind', tag, seq).to_s
+          Tk.tk_call_without_enc('bind', tag, seq, '')
+          script.scan(CALLBACK_ID_RE) { |(id)| tbl.delete(id) }
+        end
+      end
+
+      return unless defined?(TkVariable)
+      var_tbl = TkVariable::TkVar_CB_TBL
+      (var_tbl.keys - @base_var_cb_ids).each do |id|
+        remove_var_traces(id)
+        var_tbl.delete(id)
+      end
+    end
+
+    CALLBACK_ID_RE = /rb_out\S*(?:\s+::\S*)?\s+(c(?:_\d+_)?\d+)/
+
+    def remove_var_traces(name)
+      ip = TkCore::INTERP
+      ip.tcl_split_list(ip._invoke_without_enc('trace', 'info', 'variable', name)).each do |trace|
+        ops, cmd = ip.tcl_split_list(trace)
+        ip._invoke_without_enc('trace', 'remove', 'variable', name, ops, cmd)
+      end
+    rescue TclError
+      # Variable already gone
+    end
+
     # Reset grid geometry manager state for a widget.
     # Column/row weights, minsize, pad, uniform settings persist after
     # children are removed, so we must explicitly clear them.
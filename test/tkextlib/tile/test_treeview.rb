@@ -414,4 +414,183 @@ class TestTreeviewWidget < Minitest::Test
 
     raise "Treeview test failures:\n  " + errors.join("\n  ") unless errors.empty?
   end
+
+  # ========================================
+  # Bulk insert (insert_rows)
+  # ========================================
+
+  def test_treeview_insert_rows
+    assert_tk_app("Treeview insert_rows bulk insert", method(:treeview_insert_rows_app))
+  end
+
+  def treeview_insert_rows_app
+    require 'tk'
+    require 'tkextlib/tile'
+
+    errors = []
+
+    tree = Tk::Tile::Treeview.new(root, columns: ["name", "size", "kind"])
+
+    # --- Row-major, in -columns order ---
+    ids = tree.insert_rows('', [["a.txt", 1, "file"], ["b dir", 2, "dir"]])
+    errors << "should return one id per row" unless ids.size == 2
+    errors << "ids should be strings" unless ids.all? { |id| id.is_a?(String) }
+    errors << "row 0 values wrong" unless tree.itemcget(ids[0], :values) == ["a.txt", "1", "file"]
+    errors << "value with space not preserved" unless tree.get(ids[1], "name") == "b dir"
+
+    # --- No wrapper registered until asked for ---
+    errors << "id2obj should return raw id" unless Tk::Tile::Treeview::Item.id2obj(tree, ids[0]) == ids[0]
+    item = Tk::Tile::Treeview::Item.assign(tree, ids[0])
+    errors << "assign should wrap id" unless item.kind_of?(Tk::Tile::Treeview::Item) && item.id == ids[0]
+    errors << "id2obj should return assigned wrapper" unless Tk::Tile::Treeview::Item.id2obj(tree, ids[0]).equal?(item)
+
+    # --- Reordered/partial columns, text and tags ---
+    ids = tree.insert_rows(item, [["dir", "c.rb"]], columns: ["kind", "name"],
+                           text: ["C"], tags: ["hot"])
+    errors << "columns: mapping failed" unless tree.itemcget(ids[0], :values) == ["c.rb", "", "dir"]
+    errors << "text failed" unless tree.itemcget(ids[0], :text) == "C"
+    errors << "tags failed" unless tree.tag_has?("hot", ids[0])
+    errors << "parent failed" unless tree.parent_item(ids[0]).id == item.id
+
+    # --- Columnar hash and integer index ---
+    ids = tree.insert_rows('', { "size" => [10, 20], "name" => ["x", "y"] }, index: 0)
+    errors << "columnar insert failed" unless tree.get(ids[1], "name") == "y" && tree.get(ids[1], "size") == "20"
+    errors << "index should advance per row" unless tree.index(ids[0]) == 0 && tree.index(ids[1]) == 1
+
+    # --- Errors ---
+    begin
+      tree.insert_rows('', { "name" => ["x"], "size" => [1, 2] })
+      errors << "columnar length mismatch should raise"
+    rescue ArgumentError
+    end
+
+    # A cell whose #to_s raises fails before any row is inserted
+    bad = Object.new
+    def bad.to_s = raise(IOError, "no string")
+    before = tree.children('').size
+    begin
+      tree.insert_rows('', [["ok", 1, "file"], ["bad", bad, "file"]])
+      errors << "raising #to_s should propagate"
+    rescue IOError
+    end
+    errors << "no row should be inserted when a cell fails" unless tree.children('').size == before
+
+    errors << "empty insert should return []" unless tree.insert_rows('', []) == []
+
+    raise "insert_rows test failures:\n  " + errors.join("\n  ") unless errors.empty?
+  end
+
+  # ========================================
+  # Native sort and filter
+  # ========================================
+
+  def test_treeview_sort_filter
+    assert_tk_app("Treeview sort_by_column/filter", method(:treeview_sort_filter_app))
+  end
+
+  def treeview_sort_filter_app
+    require 'tk'
+    require 'tkextlib/tile'
+
+    errors = []
+
+    tree = Tk::Tile::Treeview.new(root, columns: ["name", "size", "date"])
+    ids = tree.insert_rows('', [
+      ["file10", "30",  "2024-03-01"],
+      ["file9",  "5",   "2023-12-31 23:59"],
+      ["File2",  "n/a", "bogus"],
+      ["file9",  "100", "2024-01-15"],
+    ], text: ["d", "b", "c", "a"])
+    child = tree.insert_rows(ids[0], [["x", "1", ""]]).first
+    tree.itemconfigure(ids[0], :open, true)
+
+    order = tree.sort_by_column('size', type: :numeric)
+    errors << "numeric sort wrong: #{order}" unless order == [ids[1], ids[0], ids[3], ids[2]]
+    errors << "sort should apply order" unless tree.tk_send('children', '').split == order
+    errors << "open state lost" unless tree.itemcget(ids[0], :open)
+    errors << "grandchild lost" unless tree.tk_send('children', ids[0]) == child
+
+    order = tree.sort_by_column('name', type: :natural)
+    errors << "natural sort wrong: #{order}" unless order == [ids[2], ids[1], ids[3], ids[0]]
+
+    order = tree.sort_by_column('name', type: :natural, descending: true)
+    errors << "descending not stable: #{order}" unless order == [ids[0], ids[1], ids[3], ids[2]]
+
+    order = tree.sort_by_column('date', type: :date)
+    errors << "date sort wrong: #{order}" unless order == [ids[1], ids[3], ids[0], ids[2]]
+
+    order = tree.sort_by_column('#0')
+    errors << "tree column sort wrong" unless order == [ids[3], ids[1], ids[2], ids[0]]
+
+    begin
+      tree.sort_by_column('size', type: :bogus)
+      errors << "unknown type should raise"
+    rescue ArgumentError
+    end
+
+    # --- Filter detaches, sort keeps hidden rows, clear restores ---
+    shown = tree.filter('size') {|v| v.to_i >= 30 }
+    errors << "filter wrong: #{shown}" unless shown.sort == [ids[0], ids[3]].sort
+    errors << "filtered? should be true" unless tree.filtered?
+    tree.sort_by_column('size', type: :numeric, descending: true)
+    errors << "sort while filtered wrong" unless tree.tk_send('children', '').split == [ids[3], ids[0]]
+    all = tree.filter('size')
+    errors << "clear should restore sorted rows: #{all}" unless all == [ids[3], ids[0], ids[1], ids[2]]
+    errors << "filtered? should be false" if tree.filtered?
+
+    raise "sort/filter test failures:\n  " + errors.join("\n  ") unless errors.empty?
+  end
+
+  # ========================================
+  # Per-widget item/tag registries
+  # ========================================
+
+  def test_treeview_registry
+    assert_tk_app("Treeview per-widget registries", method(:treeview_registry_app))
+  end
+
+  def treeview_registry_app
+    require 'tk'
+    require 'tkextlib/tile'
+
+    errors = []
+
+    tree1 = Tk::Tile::Treeview.new(root)
+    tree2 = Tk::Tile::Treeview.new(root)
+
+    parent = tree1.insert('', 'end', text: 'parent')
+    child = parent.insert('end', text: 'child')
+    tree2.insert('', 'end', text: 'other')
+    tag = Tk::Tile::Treeview::Tag.new(tree1)
+
+    errors << "item not registered on its tree" unless tree1.itemid2obj(child.id).equal?(child)
+    errors << "registries should be per widget" if tree2.itemid2obj(child.id).equal?(child)
+    errors << "tag not registered on its tree" unless Tk::Tile::Treeview::Tag.id2obj(tree1, tag.id).equal?(tag)
+
+    report = tree1.registry_report
+    errors << "report item count wrong: #{report}" unless report[:items][:count] == 2
+    errors << "report tag count wrong: #{report}" unless report[:tags][:count] == 1
+    errors << "report bytes missing" unless report[:items][:bytes] > 0
+
+    # Deleting a leaf drops just its own wrapper
+    leaf = tree1.insert('', 'end', text: 'leaf')
+    errors << "leaf not registered" unless tree1.registry_report[:items][:count] == 3
+    leaf.delete
+    errors << "leaf wrapper should be dropped" unless tree1.registry_report[:items][:count] == 2
+    errors << "sibling wrappers should stay" unless tree1.itemid2obj(child.id).equal?(child)
+
+    # Deleting a parent also drops its descendants' wrappers, without
+    # touching a global the application happens to call "id"
+    Tk.ip_eval('array set ::id {a 1}')
+    parent.delete
+    errors << "global ::id changed" unless Tk.ip_eval('array get ::id') == 'a 1'
+    errors << "deleted items should be pruned" unless tree1.registry_report[:items][:count] == 0
+    errors << "id2obj should fall back to id" unless tree1.itemid2obj(child.id) == child.id
+    errors << "other tree should be untouched" unless tree2.registry_report[:items][:count] == 1
+
+    tree2.destroy
+    errors << "destroy should drop registry" unless tree2.registry_report[:items][:count] == 0
+
+    raise "registry test failures:\n  " + errors.join("\n  ") unless errors.empty?
+  end
 end
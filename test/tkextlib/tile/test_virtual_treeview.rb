@@ -0,0 +1,78 @@
+# frozen_string_literal: true
+
+# Test for Tk::Tile::VirtualTreeview (treeview over a lazily-loaded model).
+#
+# See: https://www.tcl-lang.org/man/tcl/TkCmd/ttk_treeview.html
+
+require_relative '../../test_helper'
+require_relative '../../tk_test_helper'
+
+class TestVirtualTreeviewWidget < Minitest::Test
+  include TkTestHelper
+
+  def test_virtual_treeview
+    assert_tk_app("VirtualTreeview lazy rows", method(:virtual_treeview_app))
+  end
+
+  def virtual_treeview_app
+    require 'tk'
+    require 'tkextlib/tile'
+
+    errors = []
+
+    model = Class.new {
+      attr_reader :fetched
+      def initialize; @fetched = 0; end
+      def row_count; 100_000; end
+      def row(i); @fetched += 1; { text: "Row #{i}", values: [i, i * 2] }; end
+      def children?(i); i.even?; end
+      def children(i); [["#{i}.a", 0], ["#{i}.b", 1]]; end
+    }.new
+
+    tree = Tk::Tile::VirtualTreeview.new(root, model: model, margin: 5,
+                                         columns: ["n", "double"], height: 10)
+    tree.pack(fill: "both", expand: true)
+    Tk.update
+
+    # --- Only the page plus margins exist ---
+    top = tree.tk_send('children', '')
+    errors << "should materialize page + margin, got #{top.size}" unless top.size.between?(10, 20)
+    errors << "should not read the whole model" unless model.fetched < 100
+    errors << "row 0 text wrong" unless tree.itemcget(tree.item_for(0), :text) == "Row 0"
+
+    # --- Scrolling slides the window and reuses items ---
+    tree.yview_moveto(0.5)
+    Tk.update
+    errors << "first_line should follow moveto" unless tree.first_line == 50_000
+    id = tree.item_for(50_003)
+    errors << "row in window should be materialized" unless id
+    errors << "recycled item has wrong values" unless id && tree.get(id, "double") == "100006"
+    errors << "rows outside window should be released" if tree.item_for(0)
+    first, last = tree.yview
+    errors << "yview fractions wrong" unless (first - 0.5).abs < 1e-9 && last > first
+
+    # --- Selection survives recycling ---
+    tree.selected_rows = [50_001]
+    tree.yview_moveto(0.0)
+    Tk.update
+    errors << "selection lost while scrolled away" unless tree.selected_rows == [50_001]
+    errors << "recycled item should not stay selected" unless tree.selection.empty?
+    tree.see_row(50_001)
+    Tk.update
+    sel = tree.tk_send('selection')
+    errors << "selection not restored" unless sel == tree.item_for(50_001).to_s
+
+    # --- Lazy children on open ---
+    tree.yview(0)
+    Tk.update
+    tree.focus_item(tree.item_for(2))
+    tree.itemconfigure(tree.item_for(2), :open, true)
+    tree.event_generate('<TreeviewOpen>')
+    Tk.update
+    child = tree.item_for([2, 1])
+    errors << "children not loaded on open" unless child && tree.get(child, "n") == "2.b"
+    errors << "open children should add lines" unless tree.line_count == 100_002
+
+    raise "VirtualTreeview test failures:\n  " + errors.join("\n  ") unless errors.empty?
+  end
+end
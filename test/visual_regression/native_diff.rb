@@ -0,0 +1,116 @@
+# frozen_string_literal: true
+
+require 'json'
+require 'fileutils'
+require_relative 'perceptualdiff'
+
+module VisualRegression
+  # In-process screenshot comparison, used inside the widget showcase
+  # process where Tk is already loaded.
+  #
+  # Screenshots are captured with Interp#capture_window and compared
+  # with TclTkLib.image_diff, so no ImageMagick process is spawned and
+  # no PNG is re-read for the comparison. PNG files are read and written
+  # with Tk's photo image. Comparisons run in Ruby threads; image_diff
+  # releases the GVL, so they proceed in parallel.
+  #
+  # Results are written to RESULTS_FILE in the diffs directory, where the
+  # Runner picks them up instead of calling Perceptualdiff.
+  class NativeDiff
+    RESULTS_FILE = 'results.json'
+
+    attr_reader :blessed_dir, :diffs_dir, :threshold, :tolerance
+
+    # Native capture needs an X11 build of Tk
+    def self.available?
+      Tk.windowingsystem == 'x11' && TkCore::INTERP.respond_to?(:capture_window)
+    end
+
+    def initialize(blessed_dir:, diffs_dir:, threshold: Perceptualdiff::DEFAULT_THRESHOLD, tolerance: 0)
+      @blessed_dir = blessed_dir
+      @diffs_dir = diffs_dir
+      @threshold = threshold
+      @tolerance = tolerance
+      @shots = {}
+    end
+
+    # Capture win, save it as PNG and keep the pixels for comparison
+    def capture(win, name, file)
+      shot = TkCore::INTERP.capture_window(win.path)
+      write_png(shot, file)
+      @shots[name] = shot
+    end
+
+    # Compare every captured shot against its blessed PNG.
+    # Writes diff/overlay PNGs for failures and the results file.
+    def compare_all
+      pairs = @shots.filter_map do |name, actual|
+        blessed = File.join(blessed_dir, "#{name}.png")
+        next unless File.exist?(blessed)
+        [name, read_png(blessed), actual]
+      end
+
+      # Pixel work off the GVL, one thread per image
+      diffs = pairs.map do |name, expected, actual|
+        Thread.new { [name, expected, actual, diff(expected, actual)] }
+      end.map(&:value)
+
+      # Tk calls stay on the main thread
+      results = diffs.to_h do |name, expected, _actual, result|
+        [name, record(name, expected, result)]
+      end
+
+      FileUtils.mkdir_p(diffs_dir)
+      File.write(File.join(diffs_dir, RESULTS_FILE), JSON.pretty_generate(results))
+      results
+    end
+
+    def self.load_results(diffs_dir)
+      file = File.join(diffs_dir, RESULTS_FILE)
+      return nil unless File.exist?(file)
+      JSON.parse(File.read(file))
+    end
+
+    private
+
+    def diff(expected, actual)
+      unless expected[:width] == actual[:width] && expected[:height] == actual[:height]
+        return { size_mismatch: true,
+                 pixel_diff: [expected[:width] * expected[:height],
+                              actual[:width] * actual[:height]].max }
+      end
+      TclTkLib.image_diff(expected[:data], actual[:data], actual[:width], actual[:height],
+                          tolerance: tolerance, mask: true)
+    end
+
+    def record(name, expected, result)
+      passed = !result[:size_mismatch] && result[:pixel_diff] <= threshold
+      entry = { 'pixel_diff' => result[:pixel_diff], 'passed' => passed }
+      if result[:size_mismatch]
+        entry['output'] = 'image sizes differ'
+      elsif !passed
+        size = { width: expected[:width], height: expected[:height] }
+        entry['diff_image'] = File.join(diffs_dir, "diff_#{name}.png")
+        entry['overlay_image'] = File.join(diffs_dir, "overlay_#{name}.png")
+        write_png(size.merge(data: result[:mask]), entry['diff_image'])
+        write_png(size.merge(data: result[:overlay]), entry['overlay_image'])
+      end
+      entry
+    end
+
+    def read_png(file)
+      img = TkPhotoImage.new(file: file, format: 'png')
+      img.get_image
+    ensure
+      img&.delete
+    end
+
+    def write_png(shot, file)
+      img = TkPhotoImage.new(width: shot[:width], height: shot[:height])
+      img.put_block(shot[:data], shot[:width], shot[:height])
+      img.write(file, format: 'png')
+    ensure
+      img&.delete
+    end
+  end
+end
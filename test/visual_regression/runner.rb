@@ -3,11 +3,13 @@
 require 'fileutils'
 require 'open3'
 require_relative 'perceptualdiff'
+require_relative 'native_diff'
 
 module VisualRegression
   # Orchestrates visual regression testing:
   # 1. Generates screenshots of the widget showcase
-  # 2. Compares against blessed baseline images
+  # 2. Compares against blessed baseline images (in the showcase process
+  #    on X11, see NativeDiff; otherwise with ImageMagick)
   # 3. Reports differences and exits with appropriate status
   class Runner
     SCREENSHOTS_DIR = File.expand_path('../../../screenshots', __FILE__)
@@ -75,6 +77,7 @@ module VisualRegression
       FileUtils.mkdir_p(diffs_dir)
       FileUtils.mkdir_p(logs_dir)
       FileUtils.rm_f(Dir.glob(File.join(diffs_dir, '*.png')))
+      FileUtils.rm_f(File.join(diffs_dir, NativeDiff::RESULTS_FILE))
       FileUtils.rm_f(Dir.glob(File.join(logs_dir, '*.log')))
     end
 
@@ -88,7 +91,8 @@ module VisualRegression
       load_path_args = load_paths.flat_map { |p| ["-I", p] }
 
       stdout, stderr, status = Open3.capture3(
-        RbConfig.ruby, *load_path_args, showcase_script, unverified_dir
+        RbConfig.ruby, *load_path_args, showcase_script, unverified_dir,
+        blessed_dir, diffs_dir, threshold.to_s
       )
 
       puts stdout unless stdout.empty?
@@ -103,7 +107,8 @@ module VisualRegression
       puts "\nComparing against blessed baselines (#{tcl_version})..."
       puts "-" * 60
 
-      diff_tool = Perceptualdiff.new(threshold: threshold)
+      native = NativeDiff.load_results(diffs_dir)
+      diff_tool = Perceptualdiff.new(threshold: threshold) unless native
       unverified_files = Dir.glob(File.join(unverified_dir, '*.png')).sort
 
       if unverified_files.empty?
@@ -116,7 +121,11 @@ module VisualRegression
         blessed = File.join(blessed_dir, name)
         diff = File.join(diffs_dir, "diff_#{name}")
 
-        result = compare_single(diff_tool, name, blessed, unverified, diff)
+        result = if native
+                   compare_native(native, name, blessed, unverified)
+                 else
+                   compare_single(diff_tool, name, blessed, unverified, diff)
+                 end
         @results << result
       end
     end
@@ -149,6 +158,30 @@ module VisualRegression
       end
     end
 
+    # Report a comparison already done by NativeDiff in the showcase process
+    def compare_native(native, name, blessed, unverified)
+      unless File.exist?(blessed)
+        puts "  #{name.ljust(28)} MISSING BASELINE"
+        return { name: name, status: :missing, message: 'No blessed baseline exists' }
+      end
+
+      entry = native.fetch(File.basename(name, '.png'), {})
+      log_file = File.join(logs_dir, "#{File.basename(name, '.png')}.log")
+      File.write(log_file, "Comparing: #{blessed} vs #{unverified}\n\n" \
+                           "#{entry['output'] || "#{entry['pixel_diff']} pixels differ"}\n")
+
+      if entry['passed']
+        puts "  #{name.ljust(28)} PASS"
+        { name: name, status: :pass, pixel_diff: entry['pixel_diff'] }
+      else
+        puts "  #{name.ljust(28)} FAIL (#{entry['pixel_diff']} pixels differ)"
+        puts "    Log: #{log_file}"
+        puts "    Overlay: #{entry['overlay_image']}" if entry['overlay_image']
+        { name: name, status: :fail, pixel_diff: entry['pixel_diff'],
+          diff_image: entry['diff_image'], overlay_image: entry['overlay_image'] }
+      end
+    end
+
     def report_results
       puts "-" * 60
       puts "\nSummary:"
@@ -5,6 +5,7 @@ require 'tkextlib/tile'
 require 'tkextlib/tkimg/window'
 require 'tkextlib/tkimg/png'
 require 'fileutils'
+require_relative 'native_diff'
 
 module VisualRegression
   # A comprehensive Tk/Ttk widget showcase for visual regression testing.
@@ -13,8 +14,14 @@ module VisualRegression
   class WidgetShowcase
     attr_reader :output_dir, :tcl_version, :tk_version
 
-    def initialize(output_dir:)
+    # With blessed_dir and diffs_dir, screenshots are also compared
+    # in-process (see NativeDiff) when the Tk build supports it.
+    def initialize(output_dir:, blessed_dir: nil, diffs_dir: nil,
+                   threshold: Perceptualdiff::DEFAULT_THRESHOLD)
       @output_dir = output_dir
+      @blessed_dir = blessed_dir
+      @diffs_dir = diffs_dir
+      @threshold = threshold
       @tcl_version = Tk::TCL_VERSION rescue "unknown"
       @tk_version = Tk::TK_VERSION rescue "unknown"
       @scrollable_widgets = {}  # Store references for scroll state captures
@@ -24,6 +31,7 @@ module VisualRegression
     def run
       setup_error_handler
       build_ui
+      setup_native_diff
       schedule_captures
       Tk.mainloop
     end
@@ -671,6 +679,10 @@ module VisualRegression
         end
       else
         puts "Screenshots saved to: #{output_dir}/"
+        if @native_diff && @blessed_dir
+          results = @native_diff.compare_all
+          puts "Compared #{results.size} screenshots in-process"
+        end
         Tk.after(500) { @root.destroy }
       end
     end
@@ -698,10 +710,23 @@ module VisualRegression
       # No title bar adjustment needed - window is borderless (overrideredirect)
 
       file = File.join(output_dir, "#{name}.png")
-      capture_screen_region(x, y, w, h, file)
+      if @native_diff
+        @native_diff.capture(@root, name, file)
+      else
+        capture_screen_region(x, y, w, h, file)
+      end
       puts "  Captured: #{name}.png"
     end
 
+    # X11 builds read the window directly (no import process, no PNG
+    # round trip for comparison); other platforms use capture_screen_region.
+    def setup_native_diff
+      return unless NativeDiff.available?
+      @native_diff = NativeDiff.new(blessed_dir: @blessed_dir || output_dir,
+                                    diffs_dir: @diffs_dir || output_dir,
+                                    threshold: @threshold)
+    end
+
     # Cross-platform screen capture.
     #
     # macOS: Uses screencapture. Requires Screen Recording permission for your
@@ -755,5 +780,9 @@ end
 # Allow running standalone
 if __FILE__ == $0
   output_dir = ARGV[0] || 'screenshots/unverified'
-  VisualRegression::WidgetShowcase.new(output_dir: output_dir).run
+  blessed_dir, diffs_dir, threshold = ARGV[1], ARGV[2], ARGV[3]
+  VisualRegression::WidgetShowcase.new(
+    output_dir: output_dir, blessed_dir: blessed_dir, diffs_dir: diffs_dir,
+    threshold: (threshold || VisualRegression::Perceptualdiff::DEFAULT_THRESHOLD).to_i
+  ).run
 end